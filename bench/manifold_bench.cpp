@@ -0,0 +1,189 @@
+// Headless benchmarks for the geometry libraries the extension is built from. This links against the
+// same manifold and Clipper2 sources as SCsub but not against Godot, so it measures the native cost
+// of each operation; project/benchmarks/benchmark.tscn measures the same operations through the
+// GDScript API, including Variant conversion and Callable overhead.
+//
+//     scons bench && bin/manifold_bench [--filter <substring>] [--min-time <seconds>]
+
+#include <manifold/cross_section.h>
+#include <manifold/manifold.h>
+#include <manifold/polygon.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Result {
+	std::string name;
+	size_t iterations;
+	double min_usec;
+	double median_usec;
+	double mean_usec;
+};
+
+struct Options {
+	const char *filter = nullptr;
+	double min_seconds = 0.5;
+	size_t min_iterations = 5;
+};
+
+// Runs p_operation until both the minimum time and the minimum iteration count are reached.
+Result measure(const char *p_name, const Options &p_options, const std::function<void()> &p_operation) {
+	using clock = std::chrono::steady_clock;
+
+	std::vector<double> samples;
+	double total = 0.0;
+	while (samples.size() < p_options.min_iterations || total < p_options.min_seconds * 1e6) {
+		const clock::time_point start = clock::now();
+		p_operation();
+		const double usec = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+		samples.push_back(usec);
+		total += usec;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	return { p_name, samples.size(), samples.front(), samples[samples.size() / 2], total / samples.size() };
+}
+
+// Manifold evaluates CSG lazily; asking for the triangle count forces the work to happen.
+void force(const manifold::Manifold &p_manifold) {
+	volatile size_t num_tri = p_manifold.NumTri();
+	(void)num_tri;
+}
+
+} //namespace
+
+int main(int argc, char **argv) {
+	Options options;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			options.filter = argv[++i];
+		} else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+			options.min_seconds = atof(argv[++i]);
+		} else {
+			fprintf(stderr, "usage: %s [--filter <substring>] [--min-time <seconds>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<Result> results;
+	const auto bench = [&](const char *p_name, const std::function<void()> &p_operation) {
+		if (options.filter && !strstr(p_name, options.filter)) {
+			return;
+		}
+		results.push_back(measure(p_name, options, p_operation));
+	};
+
+	const manifold::Manifold sphere = manifold::Manifold::Sphere(1.0, 128);
+	const manifold::Manifold other = sphere.Translate({ 0.5, 0.25, 0.125 });
+	force(sphere);
+	force(other);
+
+	bench("primitive/cube", []() {
+		force(manifold::Manifold::Cube({ 1.0, 1.0, 1.0 }, true));
+	});
+	bench("primitive/cylinder", []() {
+		force(manifold::Manifold::Cylinder(2.0, 1.0, 0.5, 128, true));
+	});
+	bench("primitive/sphere", []() {
+		force(manifold::Manifold::Sphere(1.0, 128));
+	});
+
+	// the native halves of ManifoldMesh::from_mesh and _commit_to_arrays
+	const manifold::MeshGL sphere_meshgl = sphere.GetMeshGL();
+	bench("meshgl/from_meshgl", [&sphere_meshgl]() {
+		force(manifold::Manifold(sphere_meshgl));
+	});
+	bench("meshgl/merge", [&sphere_meshgl]() {
+		manifold::MeshGL copy = sphere_meshgl;
+		copy.mergeFromVert.clear();
+		copy.mergeToVert.clear();
+		copy.Merge();
+	});
+	bench("meshgl/get_meshgl", [&sphere]() {
+		const manifold::MeshGL meshgl = sphere.GetMeshGL();
+		(void)meshgl;
+	});
+
+	bench("boolean/union", [&]() {
+		force(sphere + other);
+	});
+	bench("boolean/intersection", [&]() {
+		force(sphere ^ other);
+	});
+	bench("boolean/difference", [&]() {
+		force(sphere - other);
+	});
+
+	std::vector<manifold::Manifold> grid;
+	for (int x = 0; x < 8; x++) {
+		for (int y = 0; y < 8; y++) {
+			grid.push_back(manifold::Manifold::Sphere(0.6, 32).Translate({ double(x), double(y), 0.0 }));
+		}
+	}
+	bench("boolean/batch_union", [&grid]() {
+		force(manifold::Manifold::BatchBoolean(grid, manifold::OpType::Add));
+	});
+
+	bench("level_set/gyroid", []() {
+		const auto gyroid = [](manifold::vec3 p_point) -> double {
+			return std::sin(p_point.x) * std::cos(p_point.y) + std::sin(p_point.y) * std::cos(p_point.z) + std::sin(p_point.z) * std::cos(p_point.x);
+		};
+		force(manifold::Manifold::LevelSet(gyroid, manifold::Box({ -3.0, -3.0, -3.0 }, { 3.0, 3.0, 3.0 }), 0.1));
+	});
+
+	const manifold::Manifold coarse = manifold::Manifold::Sphere(1.0, 32);
+	force(coarse);
+	bench("refine/4", [&coarse]() {
+		force(coarse.Refine(4));
+	});
+
+	// the level of detail chain ManifoldMesh builds: each level simplifies the last at twice the tolerance
+	bench("simplify/lod_chain", [&sphere]() {
+		manifold::Manifold level = sphere;
+		for (double tolerance = 0.004; tolerance < 1.0; tolerance *= 2.0) {
+			level = level.Simplify(tolerance);
+			force(level);
+		}
+	});
+
+	bench("warp/twist", [&sphere]() {
+		force(sphere.Warp([](manifold::vec3 &p_vert) {
+			const double angle = p_vert.z;
+			p_vert = { p_vert.x * std::cos(angle) - p_vert.y * std::sin(angle), p_vert.x * std::sin(angle) + p_vert.y * std::cos(angle), p_vert.z };
+		}));
+	});
+
+	const manifold::CrossSection circle = manifold::CrossSection::Circle(1.0, 256);
+	bench("cross_section/offset_round", [&circle]() {
+		volatile size_t num_vert = circle.Offset(0.1, manifold::CrossSection::JoinType::Round).NumVert();
+		(void)num_vert;
+	});
+	bench("cross_section/offset_miter", [&circle]() {
+		volatile size_t num_vert = circle.Offset(0.1, manifold::CrossSection::JoinType::Miter).NumVert();
+		(void)num_vert;
+	});
+
+	const manifold::Polygons slice = (sphere - other).Slice(0.0);
+	bench("cross_section/triangulate", [&slice]() {
+		const std::vector<manifold::ivec3> triangles = manifold::Triangulate(slice);
+		(void)triangles;
+	});
+
+	printf("{\n\t\"suite\": \"manifold_bench\",\n\t\"results\": [");
+	for (size_t i = 0; i < results.size(); i++) {
+		const Result &result = results[i];
+		printf("%s\n\t\t{ \"name\": \"%s\", \"iterations\": %zu, \"min_usec\": %.3f, \"median_usec\": %.3f, \"mean_usec\": %.3f }", i == 0 ? "" : ",", result.name.c_str(), result.iterations, result.min_usec, result.median_usec, result.mean_usec);
+	}
+	printf("\n\t]\n}\n");
+
+	return 0;
+}
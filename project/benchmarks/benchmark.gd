@@ -0,0 +1,71 @@
+extends Node
+
+# Times the GDScript-facing API, including Variant conversion and Callable overhead.
+# bench/manifold_bench.cpp times the same operations natively (`scons bench`).
+#
+# godot --headless --path project res://benchmarks/benchmark.tscn
+
+const MIN_USEC := 500000
+const MIN_ITERATIONS := 5
+
+
+func _ready() -> void:
+	var sphere := ManifoldMesh.sphere(1.0, 128)
+	var other := sphere.translate(Vector3(0.5, 0.25, 0.125))
+	var coarse := ManifoldMesh.sphere(1.0, 32)
+	var sphere_mesh := SphereMesh.new()
+	sphere_mesh.radial_segments = 128
+	sphere_mesh.rings = 64
+	var grid: Array[ManifoldMesh] = []
+	for x in 8:
+		for y in 8:
+			grid.append(ManifoldMesh.sphere(0.6, 32).translate(Vector3(x, y, 0)))
+	var circle := CrossSection.circle(1.0, 256)
+	var slice := sphere.difference(other).slice_cross_section(0.0)
+	for mesh in [sphere, other, coarse]:
+		mesh.get_triangle_count()
+
+	var results := [
+		_measure("primitive/cube", func() -> void: ManifoldMesh.cube(Vector3.ONE, true).get_triangle_count()),
+		_measure("primitive/cylinder", func() -> void: ManifoldMesh.cylinder(2.0, 1.0, 0.5, 128, true).get_triangle_count()),
+		_measure("primitive/sphere", func() -> void: ManifoldMesh.sphere(1.0, 128).get_triangle_count()),
+		_measure("mesh/from_mesh", func() -> void: ManifoldMesh.from_mesh(sphere_mesh).get_triangle_count()),
+		_measure("mesh/to_mesh", func() -> void: sphere.translate(Vector3.ZERO).to_mesh(false, false)),
+		_measure("boolean/union", func() -> void: sphere.union(other).get_triangle_count()),
+		_measure("boolean/intersection", func() -> void: sphere.intersection(other).get_triangle_count()),
+		_measure("boolean/difference", func() -> void: sphere.difference(other).get_triangle_count()),
+		_measure("boolean/batch_union", func() -> void: ManifoldMesh.batch_union(grid).get_triangle_count()),
+		_measure("level_set/gyroid", func() -> void:
+			ManifoldMesh.level_set(func(p: Vector3) -> float:
+				return sin(p.x) * cos(p.y) + sin(p.y) * cos(p.z) + sin(p.z) * cos(p.x),
+				AABB(Vector3(-3, -3, -3), Vector3(6, 6, 6)), 0.1).get_triangle_count()),
+		_measure("refine/4", func() -> void: coarse.refine(4).get_triangle_count()),
+		_measure("warp/twist", func() -> void:
+			sphere.warp(func(v: Vector3) -> Vector3: return v.rotated(Vector3.BACK, v.z)).get_triangle_count()),
+		_measure("cross_section/offset_round", func() -> void: circle.offset(0.1, CrossSection.ROUND)),
+		_measure("cross_section/offset_miter", func() -> void: circle.offset(0.1, CrossSection.MITER)),
+		_measure("cross_section/triangulate", func() -> void: slice.to_triangles()),
+	]
+
+	print(JSON.stringify({ "suite": "benchmark.tscn", "engine": Engine.get_version_info().string, "results": results }, "\t"))
+	get_tree().quit()
+
+
+func _measure(benchmark_name: String, operation: Callable) -> Dictionary:
+	var samples: Array[int] = []
+	var total := 0
+	while samples.size() < MIN_ITERATIONS or total < MIN_USEC:
+		var start := Time.get_ticks_usec()
+		operation.call()
+		var usec := Time.get_ticks_usec() - start
+		samples.append(usec)
+		total += usec
+
+	samples.sort()
+	return {
+		"name": benchmark_name,
+		"iterations": samples.size(),
+		"min_usec": samples[0],
+		"median_usec": samples[samples.size() / 2],
+		"mean_usec": float(total) / samples.size(),
+	}
@@ -0,0 +1,38 @@
+extends SceneTree
+
+# Measures what converting contours through PackedVector2Array costs compared to
+# passing CrossSection objects between the 2D and 3D APIs.
+#
+# godot --headless --path project --script res://benchmarks/cross_section_bridge.gd
+
+const ITERATIONS := 50
+const SEGMENTS := 512
+
+
+func _init() -> void:
+	var mesh := ManifoldMesh.sphere(1.0, SEGMENTS)
+	var section := mesh.slice_cross_section(0.0)
+	var polygons := section.to_polygons()
+
+	var results := {
+		"slice": _measure(func() -> void: mesh.slice(0.0)),
+		"slice_cross_section": _measure(func() -> void: mesh.slice_cross_section(0.0)),
+		"extrude": _measure(func() -> void: ManifoldMesh.extrude(polygons, 1.0)),
+		"extrude_cross_section": _measure(func() -> void: ManifoldMesh.extrude_cross_section(section, 1.0)),
+		"slice_offset_extrude": _measure(func() -> void:
+			var offset := CrossSection.from_polygons(mesh.slice(0.0)).offset(0.1, CrossSection.ROUND)
+			ManifoldMesh.extrude(offset.to_polygons(), 1.0)),
+		"slice_offset_extrude_cross_section": _measure(func() -> void:
+			var offset := mesh.slice_cross_section(0.0).offset(0.1, CrossSection.ROUND)
+			ManifoldMesh.extrude_cross_section(offset, 1.0)),
+	}
+
+	print(JSON.stringify({ "iterations": ITERATIONS, "vertices": section.get_vertex_count(), "usec": results }, "\t"))
+	quit()
+
+
+func _measure(operation: Callable) -> int:
+	var start := Time.get_ticks_usec()
+	for i in ITERATIONS:
+		operation.call()
+	return (Time.get_ticks_usec() - start) / ITERATIONS
@@ -0,0 +1,201 @@
+extends SceneTree
+
+# Runs operations at geometrically growing input sizes, fits the growth exponent of their run time
+# on a log-log scale, and exits with status 1 if any operation grows faster than its declared
+# complexity class allows. Catches accidental quadratic paths that a fixed-size benchmark hides.
+#
+# godot --headless --path project --script res://benchmarks/scaling.gd
+
+const SIZES := [32, 64, 128, 256, 512]
+const SAMPLES := 3
+# measured exponents are noisy at small sizes; only flag clear regressions
+const SLACK := 0.35
+const EXPORT_PATH := "user://scaling.stl"
+
+
+func _init() -> void:
+	var cases := [
+		# name, declared exponent, setup(n) -> Variant, operation(input) -> void, and optionally
+		# size(input) -> int when the input doesn't grow linearly with n, to fit against instead
+		["from_mesh/surfaces", 1.0, _array_mesh_with_surfaces, func(mesh: ArrayMesh) -> void:
+			ManifoldMesh.from_mesh(mesh)],
+		["to_mesh/surfaces", 1.0, _manifold_with_surfaces, func(mesh: ManifoldMesh) -> void:
+			mesh.to_mesh(false, false)],
+		["remove_unused_materials/surfaces", 1.0, _manifold_with_unused_surfaces, func(mesh: ManifoldMesh) -> void:
+			mesh.remove_unused_materials()],
+		["batch_union/operands", 1.3, _separate_cubes, func(cubes: Array[ManifoldMesh]) -> void:
+			ManifoldMesh.batch_union(cubes).get_triangle_count()],
+		["union/surfaces", 1.3, func(n: int) -> Array: return [_manifold_with_surfaces(n), _manifold_with_surfaces(n).translate(Vector3(0.5, 0.5, 0.5))],
+			func(pair: Array) -> void: pair[0].union(pair[1]).get_triangle_count()],
+		# sphere triangle counts grow with the square of the segment count
+		["to_mesh/triangles", 1.15, func(n: int) -> ManifoldMesh: return ManifoldMesh.sphere(1.0, n * 2),
+			func(mesh: ManifoldMesh) -> void: mesh.to_mesh(false, false),
+			func(mesh: ManifoldMesh) -> int: return mesh.get_triangle_count()],
+		["difference/triangles", 1.3, func(n: int) -> Array: return [ManifoldMesh.sphere(1.0, n * 2), ManifoldMesh.sphere(1.0, n * 2).translate(Vector3(0.5, 0.0, 0.0))],
+			func(pair: Array) -> void: pair[0].difference(pair[1]).get_triangle_count(),
+			func(pair: Array) -> int: return pair[0].get_triangle_count() + pair[1].get_triangle_count()],
+		["slice_many/layers", 1.15, func(n: int) -> Array: return [ManifoldMesh.sphere(1.0, 64), _heights(n)],
+			func(input: Array) -> void: input[0].slice_many(input[1])],
+		# the rest of the geometry operations, each on a sphere whose triangle count grows with n^2
+		["sphere/triangles", 1.15, func(n: int) -> int: return n,
+			func(segments: int) -> void: ManifoldMesh.sphere(1.0, segments).get_triangle_count(),
+			func(segments: int) -> int: return segments * segments],
+		["intersection/triangles", 1.3, _sphere_pair,
+			func(pair: Array) -> void: pair[0].intersection(pair[1]).get_triangle_count(), _pair_triangles],
+		["split/triangles", 1.3, _sphere_pair,
+			func(pair: Array) -> void: pair[0].split(pair[1]).map(_triangles), _pair_triangles],
+		["split_by_plane/triangles", 1.15, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.split_by_plane(Plane(Vector3.UP, 0.1)).map(_triangles), _triangles],
+		["trim_by_plane/triangles", 1.15, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.trim_by_plane(Plane(Vector3.UP, 0.1)).get_triangle_count(), _triangles],
+		["transform/triangles", 1.15, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.transform(Transform3D(Basis(Vector3.UP, 0.5), Vector3.ONE)).get_triangle_count(), _triangles],
+		["warp/triangles", 1.15, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.warp(func(v: Vector3) -> Vector3: return v * 1.5).get_triangle_count(), _triangles],
+		["refine/triangles", 1.15, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.refine(2).get_triangle_count(), _triangles],
+		["simplify/triangles", 1.3, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.simplify(0.01).get_triangle_count(), _triangles],
+		["hull/triangles", 1.3, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.hull().get_triangle_count(), _triangles],
+		["decompose/triangles", 1.15, func(n: int) -> ManifoldMesh: return _sphere(n).union(_sphere(n).translate(Vector3(3, 0, 0))),
+			func(mesh: ManifoldMesh) -> void: mesh.decompose(), _triangles],
+		["slice/triangles", 1.15, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.slice(0.1), _triangles],
+		["project/triangles", 1.3, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.project(), _triangles],
+		["get_min_gap/triangles", 1.3, func(n: int) -> Array: return [_sphere(n), _sphere(n).translate(Vector3(2.5, 0, 0))],
+			func(pair: Array) -> void: pair[0].get_min_gap(pair[1], 1.0), _pair_triangles],
+		["modify_normal/triangles", 1.15, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.modify_normal(func(_p: Vector3, normal: Vector3) -> Vector3: return normal).get_triangle_count(), _triangles],
+		["to_navigation_mesh/triangles", 1.3, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.to_navigation_mesh(), _triangles],
+		["export_to_file/triangles", 1.15, _sphere,
+			func(mesh: ManifoldMesh) -> void: mesh.export_to_file(EXPORT_PATH), _triangles],
+		["import_from_file/triangles", 1.15, _exported_sphere,
+			func(_triangle_count: int) -> void: ManifoldMesh.import_from_file(EXPORT_PATH).get_triangle_count(),
+			func(triangle_count: int) -> int: return triangle_count],
+		["extrude/vertices", 1.15, func(n: int) -> Array: return _circle(n * 8),
+			func(cross_section: Array) -> void: ManifoldMesh.extrude(cross_section, 1.0, 4).get_triangle_count()],
+	]
+
+	var results := []
+	var failed := false
+	for test_case in cases:
+		var sizes := []
+		var times := []
+		for n in SIZES:
+			var samples := []
+			for i in SAMPLES:
+				# inputs are rebuilt for each sample since some operations change them in place
+				var input = test_case[2].call(n)
+				# measured before the clock starts on every sample, so they all do the same work
+				var size: int = test_case[4].call(input) if test_case.size() > 4 else n
+				if i == 0:
+					sizes.append(size)
+				var start := Time.get_ticks_usec()
+				test_case[3].call(input)
+				samples.append(maxi(Time.get_ticks_usec() - start, 1))
+			samples.sort()
+			times.append(samples[SAMPLES / 2])
+
+		var exponent := _fit_exponent(sizes, times)
+		var passed: bool = exponent <= test_case[1] + SLACK
+		failed = failed or not passed
+		results.append({ "name": test_case[0], "declared": test_case[1], "exponent": snappedf(exponent, 0.01), "passed": passed, "sizes": sizes, "usec": times })
+
+	DirAccess.remove_absolute(EXPORT_PATH)
+	print(JSON.stringify({ "suite": "scaling", "failed": failed, "results": results }, "\t"))
+	quit(1 if failed else 0)
+
+
+# least-squares slope of log(time) against log(size)
+func _fit_exponent(sizes: Array, times: Array) -> float:
+	var mean_x := 0.0
+	var mean_y := 0.0
+	for i in sizes.size():
+		mean_x += log(float(sizes[i]))
+		mean_y += log(float(times[i]))
+	mean_x /= sizes.size()
+	mean_y /= sizes.size()
+
+	var covariance := 0.0
+	var variance := 0.0
+	for i in sizes.size():
+		var dx := log(float(sizes[i])) - mean_x
+		covariance += dx * (log(float(times[i])) - mean_y)
+		variance += dx * dx
+	return covariance / variance
+
+
+func _separate_cubes(n: int) -> Array[ManifoldMesh]:
+	var cubes: Array[ManifoldMesh] = []
+	for i in n:
+		cubes.append(ManifoldMesh.cube(Vector3(0.5, 0.5, 0.5), false, StandardMaterial3D.new()).translate(Vector3(i, 0, 0)))
+	return cubes
+
+
+func _array_mesh_with_surfaces(n: int) -> ArrayMesh:
+	var mesh := ArrayMesh.new()
+	for i in n:
+		var cube := BoxMesh.new()
+		var arrays := cube.get_mesh_arrays()
+		var positions: PackedVector3Array = arrays[Mesh.ARRAY_VERTEX]
+		for j in positions.size():
+			positions[j] += Vector3(i * 2, 0, 0)
+		arrays[Mesh.ARRAY_VERTEX] = positions
+		mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, arrays)
+		mesh.surface_set_material(i, StandardMaterial3D.new())
+	return mesh
+
+
+func _manifold_with_surfaces(n: int) -> ManifoldMesh:
+	var mesh := ManifoldMesh.batch_union(_separate_cubes(n))
+	mesh.get_triangle_count()
+	return mesh
+
+
+func _manifold_with_unused_surfaces(n: int) -> ManifoldMesh:
+	# keep only the first half of the row of cubes, leaving the other half of the materials unused
+	var mesh := _manifold_with_surfaces(n).intersection(ManifoldMesh.cube(Vector3(n / 2.0, 1, 1)))
+	mesh.get_triangle_count()
+	return mesh
+
+
+func _heights(n: int) -> PackedFloat64Array:
+	var heights := PackedFloat64Array()
+	for i in n:
+		heights.append(lerpf(-0.99, 0.99, float(i) / (n - 1)))
+	return heights
+
+
+func _sphere(n: int) -> ManifoldMesh:
+	var mesh := ManifoldMesh.sphere(1.0, n)
+	mesh.get_triangle_count()
+	return mesh
+
+
+# exports a sphere for import_from_file to read back, and returns its triangle count
+func _exported_sphere(n: int) -> int:
+	var mesh := _sphere(n)
+	mesh.export_to_file(EXPORT_PATH)
+	return mesh.get_triangle_count()
+
+
+func _sphere_pair(n: int) -> Array:
+	return [_sphere(n), _sphere(n).translate(Vector3(0.5, 0.0, 0.0))]
+
+
+func _triangles(mesh: ManifoldMesh) -> int:
+	return mesh.get_triangle_count()
+
+
+func _pair_triangles(pair: Array) -> int:
+	return pair[0].get_triangle_count() + pair[1].get_triangle_count()
+
+
+func _circle(points: int) -> Array[PackedVector2Array]:
+	var circle := PackedVector2Array()
+	for i in points:
+		circle.append(Vector2.from_angle(TAU * i / points))
+	return [circle]
@@ -0,0 +1,37 @@
+extends SceneTree
+
+# Builds the same union of two fresh cubes twice with the Manifold cache on, and exits with status 1
+# unless the second result, which comes from the cache, carries the second pair's original IDs.
+#
+# godot --headless --path project --script res://tests/cache_original_ids.gd
+
+
+func _init() -> void:
+	ManifoldCache.clear()
+	ManifoldCache.set_budget(64 * 1024 * 1024)
+
+	var failed := false
+	for i in 2:
+		var first := Manifold.cube(Vector3.ONE)
+		var second := Manifold.cube(Vector3.ONE)
+		var expected := [first.original_id(), second.original_id()]
+		var result := first.union_with(second.translate(Vector3(0.5, 0.5, 0.5)))
+
+		var ids := []
+		for id in result.to_mesh64().get_run_original_id():
+			if not ids.has(id):
+				ids.append(id)
+		ids.sort()
+		expected.sort()
+		if ids != expected:
+			printerr("round %d: run original IDs %s, expected %s" % [i, ids, expected])
+			failed = true
+
+	var statistics := ManifoldCache.get_statistics()
+	if statistics["hits"] == 0:
+		printerr("the second round never hit the cache")
+		failed = true
+
+	ManifoldCache.set_budget(0)
+	ManifoldCache.clear()
+	quit(1 if failed else 0)
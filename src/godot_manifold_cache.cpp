@@ -0,0 +1,432 @@
+#include "godot_manifold_cache.h"
+#include "godot_manifold_defs.h"
+#include "godot_manifold_memory.h"
+
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/list.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+#include <manifold/manifold.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+// set by SCsub from git; a build without it shares one ID, so clear the disk cache when upgrading
+#ifndef GODOT_MANIFOLD_BUILD_ID
+#define GODOT_MANIFOLD_BUILD_ID "unknown"
+#endif
+
+using namespace godot;
+
+namespace {
+
+struct Entry {
+	ManifoldCacheKey key;
+	manifold::Manifold manifold;
+	// the operands' original IDs that the runs of manifold refer to
+	std::vector<uint32_t> original_ids;
+	Ref<ManifoldMesh> mesh;
+	manifold::Polygons polygons;
+	uint64_t bytes = 0;
+};
+
+std::mutex cache_mutex;
+std::atomic<int64_t> budget{ 0 };
+
+// most recently used at the front
+List<Entry> entries;
+HashMap<ManifoldCacheKey, List<Entry>::Element *, ManifoldCacheKey> entry_by_key;
+uint64_t bytes_used = 0;
+
+uint64_t hits = 0;
+uint64_t misses = 0;
+uint64_t evictions = 0;
+
+constexpr uint32_t DISK_MAGIC = 0x43454d47; // "GMEC"
+constexpr uint32_t DISK_FORMAT_VERSION = 1;
+constexpr const char *DISK_EXTENSION = "mmc";
+
+struct DiskFile {
+	String name;
+	uint64_t bytes = 0;
+};
+
+std::atomic<bool> disk_enabled{ false };
+String disk_path;
+int64_t disk_max_bytes = 0;
+uint64_t disk_bytes_used = 0;
+
+// least recently used first
+List<DiskFile> disk_files;
+HashMap<String, List<DiskFile>::Element *> disk_file_by_name;
+
+uint64_t disk_hits = 0;
+uint64_t disk_misses = 0;
+uint64_t disk_writes = 0;
+
+// call with cache_mutex held
+void evict_to(uint64_t p_bytes) {
+	while (bytes_used > p_bytes && entries.back()) {
+		List<Entry>::Element *oldest = entries.back();
+		bytes_used -= oldest->get().bytes;
+		entry_by_key.erase(oldest->get().key);
+		entries.erase(oldest);
+		evictions++;
+	}
+}
+
+// call with cache_mutex held; returns the entry moved to the front, or null on a miss
+Entry *find(const ManifoldCacheKey &p_key) {
+	List<Entry>::Element **element = entry_by_key.getptr(p_key);
+	if (!element) {
+		misses++;
+		return nullptr;
+	}
+
+	hits++;
+	entries.move_to_front(*element);
+	return &(*element)->get();
+}
+
+// call with cache_mutex held
+void insert(Entry &&p_entry) {
+	const int64_t limit = budget.load(std::memory_order_relaxed);
+	if (unlikely(p_entry.bytes > uint64_t(limit))) {
+		return;
+	}
+
+	List<Entry>::Element **existing = entry_by_key.getptr(p_entry.key);
+	if (existing) {
+		// another thread computed the same result in the meantime
+		entries.move_to_front(*existing);
+		return;
+	}
+
+	evict_to(uint64_t(limit) - p_entry.bytes);
+	bytes_used += p_entry.bytes;
+	const ManifoldCacheKey key = p_entry.key;
+	entry_by_key.insert(key, entries.push_front(std::move(p_entry)));
+}
+
+String disk_file_name(const ManifoldCacheKey &p_key) {
+	return String::num_uint64(p_key.a, 16).lpad(16, "0") + String::num_uint64(p_key.b, 16).lpad(16, "0") + "." + DISK_EXTENSION;
+}
+
+// call with cache_mutex held
+void evict_disk_to(uint64_t p_bytes) {
+	while (disk_bytes_used > p_bytes && disk_files.front()) {
+		List<DiskFile>::Element *oldest = disk_files.front();
+		DirAccess::remove_absolute(disk_path.path_join(oldest->get().name));
+		disk_bytes_used -= oldest->get().bytes;
+		disk_file_by_name.erase(oldest->get().name);
+		disk_files.erase(oldest);
+	}
+}
+
+// call with cache_mutex held
+void track_disk_file(const String &p_name, uint64_t p_bytes) {
+	List<DiskFile>::Element **existing = disk_file_by_name.getptr(p_name);
+	if (existing) {
+		disk_bytes_used -= (*existing)->get().bytes;
+		disk_files.erase(*existing);
+	}
+
+	DiskFile file;
+	file.name = p_name;
+	file.bytes = p_bytes;
+	disk_file_by_name[p_name] = disk_files.push_back(file);
+	disk_bytes_used += p_bytes;
+}
+
+} //namespace
+
+void ManifoldCache::_bind_methods() {
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("set_budget", "bytes"), &ManifoldCache::set_budget);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("get_budget"), &ManifoldCache::get_budget);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("is_enabled"), &ManifoldCache::is_enabled);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("is_memory_enabled"), &ManifoldCache::is_memory_enabled);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("clear"), &ManifoldCache::clear);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("get_statistics"), &ManifoldCache::get_statistics);
+
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("set_disk_cache", "path", "max_bytes"), &ManifoldCache::set_disk_cache, DEFVAL(256 * 1024 * 1024));
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("get_disk_cache_path"), &ManifoldCache::get_disk_cache_path);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("get_disk_cache_max_bytes"), &ManifoldCache::get_disk_cache_max_bytes);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("clear_disk_cache"), &ManifoldCache::clear_disk_cache);
+}
+
+void ManifoldCache::set_budget(int64_t p_bytes) {
+	ERR_FAIL_COND(p_bytes < 0);
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	budget.store(p_bytes, std::memory_order_relaxed);
+	evict_to(p_bytes);
+}
+
+int64_t ManifoldCache::get_budget() {
+	return budget.load(std::memory_order_relaxed);
+}
+
+bool ManifoldCache::is_enabled() {
+	return budget.load(std::memory_order_relaxed) > 0 || disk_enabled.load(std::memory_order_relaxed);
+}
+
+bool ManifoldCache::is_memory_enabled() {
+	return budget.load(std::memory_order_relaxed) > 0;
+}
+
+void ManifoldCache::clear() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	entries.clear();
+	entry_by_key.clear();
+	bytes_used = 0;
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
+
+Dictionary ManifoldCache::get_statistics() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+
+	Dictionary statistics;
+	statistics["hits"] = hits;
+	statistics["misses"] = misses;
+	statistics["evictions"] = evictions;
+	statistics["entries"] = entries.size();
+	statistics["bytes"] = bytes_used;
+	statistics["budget"] = budget.load(std::memory_order_relaxed);
+	statistics["disk_hits"] = disk_hits;
+	statistics["disk_misses"] = disk_misses;
+	statistics["disk_writes"] = disk_writes;
+	statistics["disk_entries"] = disk_files.size();
+	statistics["disk_bytes"] = disk_bytes_used;
+	return statistics;
+}
+
+void ManifoldCache::set_disk_cache(const String &p_path, int64_t p_max_bytes) {
+	ERR_FAIL_COND(p_max_bytes < 0);
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	disk_enabled.store(false, std::memory_order_relaxed);
+	disk_files.clear();
+	disk_file_by_name.clear();
+	disk_bytes_used = 0;
+	disk_path = p_path;
+	disk_max_bytes = p_max_bytes;
+
+	if (p_path.is_empty()) {
+		return;
+	}
+
+	const godot::Error err = DirAccess::make_dir_recursive_absolute(p_path);
+	ERR_FAIL_COND_MSG(err != OK, vformat("Cannot create Manifold disk cache directory %s", p_path));
+
+	// pick up what earlier runs left behind, oldest first so those are evicted first
+	struct Found {
+		uint64_t modified_time;
+		String name;
+		uint64_t bytes;
+	};
+	LocalVector<Found> found;
+	for (const String &name : DirAccess::get_files_at(p_path)) {
+		const String file_path = p_path.path_join(name);
+		if (name.get_extension() != DISK_EXTENSION) {
+			// a write that never got committed
+			if (name.get_extension() == "tmp") {
+				DirAccess::remove_absolute(file_path);
+			}
+			continue;
+		}
+
+		const Ref<FileAccess> file = FileAccess::open(file_path, FileAccess::READ);
+		if (file.is_valid()) {
+			found.push_back({ FileAccess::get_modified_time(file_path), name, file->get_length() });
+		}
+	}
+	std::sort(found.ptr(), found.ptr() + found.size(), [](const Found &p_a, const Found &p_b) {
+		return p_a.modified_time < p_b.modified_time;
+	});
+	for (const Found &file : found) {
+		track_disk_file(file.name, file.bytes);
+	}
+
+	evict_disk_to(p_max_bytes);
+	disk_enabled.store(true, std::memory_order_relaxed);
+}
+
+String ManifoldCache::get_disk_cache_path() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return disk_path;
+}
+
+int64_t ManifoldCache::get_disk_cache_max_bytes() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return disk_max_bytes;
+}
+
+godot::Error ManifoldCache::clear_disk_cache() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	ERR_FAIL_COND_V_MSG(disk_path.is_empty(), ERR_UNCONFIGURED, "The Manifold disk cache is not enabled");
+
+	evict_disk_to(0);
+	disk_hits = 0;
+	disk_misses = 0;
+	disk_writes = 0;
+	return OK;
+}
+
+bool ManifoldCache::lookup(const ManifoldCacheKey &p_key, manifold::Manifold &r_manifold, std::vector<uint32_t> &r_original_ids) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	const Entry *entry = find(p_key);
+	if (!entry) {
+		return false;
+	}
+
+	r_manifold = entry->manifold;
+	r_original_ids = entry->original_ids;
+	return true;
+}
+
+void ManifoldCache::store(const ManifoldCacheKey &p_key, const manifold::Manifold &p_manifold, const std::vector<uint32_t> &p_original_ids) {
+	// sizing the result evaluates it; do that before taking the lock
+	Entry entry;
+	entry.key = p_key;
+	entry.manifold = p_manifold;
+	entry.original_ids = p_original_ids;
+	entry.bytes = memory_of_manifold(p_manifold) + p_original_ids.size() * sizeof(uint32_t);
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	insert(std::move(entry));
+}
+
+Ref<ManifoldMesh> ManifoldCache::lookup_mesh(const ManifoldCacheKey &p_key) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	const Entry *entry = find(p_key);
+	if (!entry) {
+		return Ref<ManifoldMesh>();
+	}
+
+	return entry->mesh;
+}
+
+void ManifoldCache::store_mesh(const ManifoldCacheKey &p_key, const Ref<ManifoldMesh> &p_mesh, uint64_t p_bytes) {
+	Entry entry;
+	entry.key = p_key;
+	entry.mesh = p_mesh;
+	entry.bytes = p_bytes;
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	insert(std::move(entry));
+}
+
+bool ManifoldCache::lookup_polygons(const ManifoldCacheKey &p_key, manifold::Polygons &r_polygons) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	const Entry *entry = find(p_key);
+	if (!entry) {
+		return false;
+	}
+
+	r_polygons = entry->polygons;
+	return true;
+}
+
+void ManifoldCache::store_polygons(const ManifoldCacheKey &p_key, const manifold::Polygons &p_polygons) {
+	Entry entry;
+	entry.key = p_key;
+	entry.polygons = p_polygons;
+	entry.bytes = sizeof(manifold::SimplePolygon) * entry.polygons.capacity();
+	for (const manifold::SimplePolygon &polygon : entry.polygons) {
+		entry.bytes += sizeof(manifold::vec2) * polygon.capacity();
+	}
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	insert(std::move(entry));
+}
+
+Ref<FileAccess> ManifoldCache::open_disk_entry(const ManifoldCacheKey &p_key) {
+	if (!p_key.persistent || !disk_enabled.load(std::memory_order_relaxed)) {
+		return Ref<FileAccess>();
+	}
+
+	const String name = disk_file_name(p_key);
+	String file_path;
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		if (!disk_file_by_name.has(name)) {
+			disk_misses++;
+			return Ref<FileAccess>();
+		}
+		file_path = disk_path.path_join(name);
+	}
+
+	Ref<FileAccess> file = FileAccess::open(file_path, FileAccess::READ);
+	const bool valid = file.is_valid() &&
+			file->get_32() == DISK_MAGIC &&
+			file->get_32() == DISK_FORMAT_VERSION &&
+			file->get_pascal_string() == GODOT_MANIFOLD_BUILD_ID &&
+			file->get_32() == sizeof(real_t);
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	if (!valid) {
+		disk_misses++;
+		return Ref<FileAccess>();
+	}
+
+	disk_hits++;
+	List<DiskFile>::Element **element = disk_file_by_name.getptr(name);
+	if (element) {
+		disk_files.move_to_back(*element);
+	}
+	return file;
+}
+
+Ref<FileAccess> ManifoldCache::create_disk_entry(const ManifoldCacheKey &p_key) {
+	if (!p_key.persistent || !disk_enabled.load(std::memory_order_relaxed)) {
+		return Ref<FileAccess>();
+	}
+
+	String file_path;
+	{
+		std::lock_guard<std::mutex> lock(cache_mutex);
+		// two threads may build the same result at once, so each writes its own temporary file
+		file_path = disk_path.path_join(vformat("%s.%d.tmp", disk_file_name(p_key), OS::get_singleton()->get_thread_caller_id()));
+	}
+
+	Ref<FileAccess> file = FileAccess::open(file_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), Ref<FileAccess>(), vformat("Cannot write Manifold disk cache entry %s", file_path));
+
+	file->store_32(DISK_MAGIC);
+	file->store_32(DISK_FORMAT_VERSION);
+	file->store_pascal_string(GODOT_MANIFOLD_BUILD_ID);
+	file->store_32(sizeof(real_t));
+	return file;
+}
+
+void ManifoldCache::commit_disk_entry(const ManifoldCacheKey &p_key, const Ref<FileAccess> &p_file) {
+	ERR_FAIL_COND(p_file.is_null());
+
+	const String temp_path = p_file->get_path();
+	const uint64_t bytes = p_file->get_length();
+	const bool failed = p_file->get_error() != OK;
+	p_file->close();
+
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	if (unlikely(failed || disk_path.is_empty() || int64_t(bytes) > disk_max_bytes)) {
+		DirAccess::remove_absolute(temp_path);
+		return;
+	}
+
+	// renaming last means a crash never leaves a truncated entry behind under a real name
+	const String name = disk_file_name(p_key);
+	const godot::Error err = DirAccess::rename_absolute(temp_path, disk_path.path_join(name));
+	if (unlikely(err != OK)) {
+		DirAccess::remove_absolute(temp_path);
+		ERR_FAIL_MSG(vformat("Cannot commit Manifold disk cache entry %s", name));
+	}
+
+	track_disk_file(name, bytes);
+	disk_writes++;
+	evict_disk_to(disk_max_bytes);
+}
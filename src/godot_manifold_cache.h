@@ -0,0 +1,167 @@
+#pragma once
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/plane.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+#include <manifold/common.h>
+
+#include <cstring>
+#include <vector>
+
+namespace manifold {
+class Manifold;
+} //namespace manifold
+
+class ManifoldMesh;
+
+// 128 bits, so an accidental collision (which would hand back the wrong geometry) is not a concern.
+// A key is persistent when it only depends on things that are the same in every run (no object
+// instance IDs or reserved original IDs), which is what the disk cache needs; it doesn't take part
+// in comparisons.
+struct ManifoldCacheKey {
+	uint64_t a = 0;
+	uint64_t b = 0;
+	bool persistent = true;
+
+	bool operator==(const ManifoldCacheKey &p_other) const { return a == p_other.a && b == p_other.b; }
+	bool operator!=(const ManifoldCacheKey &p_other) const { return !(*this == p_other); }
+
+	static uint32_t hash(const ManifoldCacheKey &p_key) { return uint32_t(p_key.a ^ (p_key.a >> 32)); }
+};
+
+// Builds a ManifoldCacheKey from an operation name, its operands' content hashes and its parameters.
+class ManifoldHasher {
+	uint64_t _a = 0x9e3779b97f4a7c15ull;
+	uint64_t _b = 0xc2b2ae3d27d4eb4full;
+	bool _persistent = true;
+
+	static _FORCE_INLINE_ uint64_t _mix(uint64_t p_value) {
+		p_value ^= p_value >> 30;
+		p_value *= 0xbf58476d1ce4e5b9ull;
+		p_value ^= p_value >> 27;
+		p_value *= 0x94d049bb133111ebull;
+		p_value ^= p_value >> 31;
+		return p_value;
+	}
+
+public:
+	_FORCE_INLINE_ void add(uint64_t p_value) {
+		_a = _mix(_a ^ p_value);
+		_b = _mix(_b + p_value * 0xff51afd7ed558ccdull);
+	}
+	_FORCE_INLINE_ void add(double p_value) {
+		// adding zero turns -0.0 into 0.0, which gives the same result from every operation
+		const double value = p_value + 0.0;
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		add(bits);
+	}
+	_FORCE_INLINE_ void add(const ManifoldCacheKey &p_key) {
+		add(p_key.a);
+		add(p_key.b);
+		_persistent = _persistent && p_key.persistent;
+	}
+	_FORCE_INLINE_ void mark_transient() {
+		_persistent = false;
+	}
+	void add(const char *p_string) {
+		add_bytes(p_string, strlen(p_string));
+	}
+	void add(const godot::Vector3 &p_vector) {
+		add(double(p_vector.x));
+		add(double(p_vector.y));
+		add(double(p_vector.z));
+	}
+	void add(const godot::Plane &p_plane) {
+		add(p_plane.normal);
+		add(double(p_plane.d));
+	}
+	void add(const godot::Transform3D &p_transform) {
+		add(p_transform.basis.rows[0]);
+		add(p_transform.basis.rows[1]);
+		add(p_transform.basis.rows[2]);
+		add(p_transform.origin);
+	}
+	template <typename... Args>
+	void add_all(const Args &...p_args) {
+		(add(p_args), ...);
+	}
+	void add_bytes(const void *p_data, size_t p_size) {
+		const uint8_t *data = static_cast<const uint8_t *>(p_data);
+		add(uint64_t(p_size));
+		for (; p_size >= sizeof(uint64_t); data += sizeof(uint64_t), p_size -= sizeof(uint64_t)) {
+			uint64_t word;
+			memcpy(&word, data, sizeof(word));
+			add(word);
+		}
+		if (p_size) {
+			uint64_t word = 0;
+			memcpy(&word, data, p_size);
+			add(word);
+		}
+	}
+	template <typename T>
+	void add_vector(const std::vector<T> &p_vector) {
+		add_bytes(p_vector.data(), p_vector.size() * sizeof(T));
+	}
+
+	// runOriginalID is left to the caller, since what those IDs mean depends on who owns the mesh
+	template <typename Mesh>
+	void add_mesh(const Mesh &p_mesh) {
+		add(uint64_t(p_mesh.numProp));
+		add_vector(p_mesh.vertProperties);
+		add_vector(p_mesh.triVerts);
+		add_vector(p_mesh.mergeFromVert);
+		add_vector(p_mesh.mergeToVert);
+		add_vector(p_mesh.runIndex);
+		add_vector(p_mesh.runTransform);
+		add_vector(p_mesh.faceID);
+		add_vector(p_mesh.halfedgeTangent);
+	}
+
+	ManifoldCacheKey finish() const {
+		return { _mix(_a), _mix(_b ^ _a), _persistent };
+	}
+};
+
+// An opt-in, process-wide memo of operation results. With a budget of zero and no disk cache (the
+// default) nothing is cached and the operations don't even compute their keys. Manifold results
+// only use the memory tier, so Manifold checks is_memory_enabled instead.
+//
+// The disk cache holds ManifoldMesh results with persistent keys, one file per key, written by
+// ManifoldMesh between create_disk_entry and commit_disk_entry. Every file starts with the
+// extension's build ID, so a different build ignores them.
+class ManifoldCache : public godot::Object {
+	GDCLASS(ManifoldCache, godot::Object);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static void set_budget(int64_t p_bytes);
+	static int64_t get_budget();
+	static bool is_enabled();
+	static bool is_memory_enabled();
+	static void clear();
+	static godot::Dictionary get_statistics();
+
+	static void set_disk_cache(const godot::String &p_path, int64_t p_max_bytes = 256 * 1024 * 1024);
+	static godot::String get_disk_cache_path();
+	static int64_t get_disk_cache_max_bytes();
+	static godot::Error clear_disk_cache();
+
+	static bool lookup(const ManifoldCacheKey &p_key, manifold::Manifold &r_manifold, std::vector<uint32_t> &r_original_ids);
+	static void store(const ManifoldCacheKey &p_key, const manifold::Manifold &p_manifold, const std::vector<uint32_t> &p_original_ids);
+	static godot::Ref<ManifoldMesh> lookup_mesh(const ManifoldCacheKey &p_key);
+	static void store_mesh(const ManifoldCacheKey &p_key, const godot::Ref<ManifoldMesh> &p_mesh, uint64_t p_bytes);
+	static bool lookup_polygons(const ManifoldCacheKey &p_key, manifold::Polygons &r_polygons);
+	static void store_polygons(const ManifoldCacheKey &p_key, const manifold::Polygons &p_polygons);
+
+	static godot::Ref<godot::FileAccess> open_disk_entry(const ManifoldCacheKey &p_key);
+	static godot::Ref<godot::FileAccess> create_disk_entry(const ManifoldCacheKey &p_key);
+	static void commit_disk_entry(const ManifoldCacheKey &p_key, const godot::Ref<godot::FileAccess> &p_file);
+};
@@ -0,0 +1,214 @@
+#include "godot_manifold_chunk_grid.h"
+#include "godot_manifold_parallel.h"
+
+#include <godot_cpp/templates/local_vector.hpp>
+
+using namespace godot;
+
+void CrossSectionChunkGrid::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_chunk_size", "chunk_size"), &CrossSectionChunkGrid::set_chunk_size);
+	ClassDB::bind_method(D_METHOD("get_chunk_size"), &CrossSectionChunkGrid::get_chunk_size);
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "chunk_size", PROPERTY_HINT_RANGE, "0.001,4096,0.001,or_greater"), "set_chunk_size", "get_chunk_size");
+
+	ClassDB::bind_method(D_METHOD("set_max_convex_pieces", "max_convex_pieces"), &CrossSectionChunkGrid::set_max_convex_pieces);
+	ClassDB::bind_method(D_METHOD("get_max_convex_pieces"), &CrossSectionChunkGrid::get_max_convex_pieces);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_convex_pieces", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), "set_max_convex_pieces", "get_max_convex_pieces");
+
+	ClassDB::bind_method(D_METHOD("set_cross_section", "cross_section"), &CrossSectionChunkGrid::set_cross_section);
+	ClassDB::bind_method(D_METHOD("get_cross_section"), &CrossSectionChunkGrid::get_cross_section);
+	ClassDB::bind_method(D_METHOD("add", "cross_section"), &CrossSectionChunkGrid::add);
+	ClassDB::bind_method(D_METHOD("subtract", "cross_section"), &CrossSectionChunkGrid::subtract);
+	ClassDB::bind_method(D_METHOD("clear"), &CrossSectionChunkGrid::clear);
+
+	ClassDB::bind_method(D_METHOD("get_chunks"), &CrossSectionChunkGrid::get_chunks);
+	ClassDB::bind_method(D_METHOD("get_dirty_chunks"), &CrossSectionChunkGrid::get_dirty_chunks);
+	ClassDB::bind_method(D_METHOD("get_chunk_rect", "chunk"), &CrossSectionChunkGrid::get_chunk_rect);
+	ClassDB::bind_method(D_METHOD("get_chunk_cross_section", "chunk"), &CrossSectionChunkGrid::get_chunk_cross_section);
+	ClassDB::bind_method(D_METHOD("get_chunk_mesh", "chunk"), &CrossSectionChunkGrid::get_chunk_mesh);
+	ClassDB::bind_method(D_METHOD("get_chunk_shapes", "chunk"), &CrossSectionChunkGrid::get_chunk_shapes);
+
+	ClassDB::bind_method(D_METHOD("update"), &CrossSectionChunkGrid::update);
+}
+
+Vector2i CrossSectionChunkGrid::_chunk_at(const Vector2 &p_position) const {
+	return Vector2i(int32_t(Math::floor(p_position.x / _chunk_size)), int32_t(Math::floor(p_position.y / _chunk_size)));
+}
+
+void CrossSectionChunkGrid::_edit(const Ref<CrossSection> &p_cross_section, bool p_add) {
+	ERR_FAIL_COND(p_cross_section.is_null());
+	if (p_cross_section->is_empty()) {
+		return;
+	}
+
+	// added geometry may start new chunks, but removing it can only change chunks that exist
+	const Rect2 bounds = p_cross_section->get_bounds();
+	const Vector2i first = _chunk_at(bounds.position);
+	const Vector2i last = _chunk_at(bounds.get_end());
+	LocalVector<Vector2i> touched;
+	TypedArray<Rect2> rects;
+	for (int32_t y = first.y; y <= last.y; y++) {
+		for (int32_t x = first.x; x <= last.x; x++) {
+			const Vector2i chunk(x, y);
+			if (p_add || _chunks.has(chunk)) {
+				touched.push_back(chunk);
+				rects.push_back(get_chunk_rect(chunk));
+			}
+		}
+	}
+	const TypedArray<CrossSection> pieces = p_cross_section->rect_clip_many(rects);
+
+	LocalVector<Chunk *> chunks;
+	LocalVector<Ref<CrossSection>> chunk_pieces;
+	for (uint32_t i = 0; i < touched.size(); i++) {
+		const Ref<CrossSection> piece = pieces[i];
+		if (!piece->is_empty()) {
+			chunks.push_back(&_chunks[touched[i]]);
+			chunk_pieces.push_back(piece);
+		}
+	}
+
+	parallel_for(chunks.size(), [&](uint32_t p_chunk) {
+		Chunk &chunk = *chunks[p_chunk];
+		if (chunk.cross_section.is_null()) {
+			chunk.cross_section = chunk_pieces[p_chunk];
+		} else {
+			chunk.cross_section = p_add ? chunk.cross_section->union_with(chunk_pieces[p_chunk]) : chunk.cross_section->difference_with(chunk_pieces[p_chunk]);
+		}
+		chunk.dirty = true;
+	});
+}
+
+void CrossSectionChunkGrid::set_chunk_size(double p_chunk_size) {
+	ERR_FAIL_COND(p_chunk_size <= 0.0);
+	if (p_chunk_size == _chunk_size) {
+		return;
+	}
+
+	// the chunks have to be cut again along the new borders
+	const Ref<CrossSection> cross_section = get_cross_section();
+	_chunk_size = p_chunk_size;
+	set_cross_section(cross_section);
+}
+double CrossSectionChunkGrid::get_chunk_size() const {
+	return _chunk_size;
+}
+
+void CrossSectionChunkGrid::set_max_convex_pieces(int32_t p_max_convex_pieces) {
+	ERR_FAIL_COND(p_max_convex_pieces < 0);
+	_max_convex_pieces = p_max_convex_pieces;
+	for (KeyValue<Vector2i, Chunk> &E : _chunks) {
+		E.value.dirty = true;
+	}
+}
+int32_t CrossSectionChunkGrid::get_max_convex_pieces() const {
+	return _max_convex_pieces;
+}
+
+void CrossSectionChunkGrid::set_cross_section(const Ref<CrossSection> &p_cross_section) {
+	// chunks that end up empty are kept until the next update() reports them
+	for (KeyValue<Vector2i, Chunk> &E : _chunks) {
+		E.value.cross_section = Ref<CrossSection>(memnew(CrossSection));
+		E.value.dirty = true;
+	}
+	if (p_cross_section.is_valid()) {
+		_edit(p_cross_section, true);
+	}
+}
+Ref<CrossSection> CrossSectionChunkGrid::get_cross_section() const {
+	TypedArray<CrossSection> cross_sections;
+	for (const KeyValue<Vector2i, Chunk> &E : _chunks) {
+		cross_sections.push_back(E.value.cross_section);
+	}
+	// a union rather than a compose, so pieces cut apart at chunk borders are joined up again
+	return CrossSection::batch_union(cross_sections);
+}
+void CrossSectionChunkGrid::add(const Ref<CrossSection> &p_cross_section) {
+	_edit(p_cross_section, true);
+}
+void CrossSectionChunkGrid::subtract(const Ref<CrossSection> &p_cross_section) {
+	_edit(p_cross_section, false);
+}
+void CrossSectionChunkGrid::clear() {
+	set_cross_section(Ref<CrossSection>());
+}
+
+TypedArray<Vector2i> CrossSectionChunkGrid::get_chunks() const {
+	TypedArray<Vector2i> chunks;
+	for (const KeyValue<Vector2i, Chunk> &E : _chunks) {
+		chunks.push_back(E.key);
+	}
+	return chunks;
+}
+TypedArray<Vector2i> CrossSectionChunkGrid::get_dirty_chunks() const {
+	TypedArray<Vector2i> chunks;
+	for (const KeyValue<Vector2i, Chunk> &E : _chunks) {
+		if (E.value.dirty) {
+			chunks.push_back(E.key);
+		}
+	}
+	return chunks;
+}
+Rect2 CrossSectionChunkGrid::get_chunk_rect(const Vector2i &p_chunk) const {
+	return Rect2(Vector2(p_chunk) * _chunk_size, Vector2(_chunk_size, _chunk_size));
+}
+Ref<CrossSection> CrossSectionChunkGrid::get_chunk_cross_section(const Vector2i &p_chunk) const {
+	const Chunk *chunk = _chunks.getptr(p_chunk);
+	return chunk ? chunk->cross_section : Ref<CrossSection>();
+}
+Ref<ArrayMesh> CrossSectionChunkGrid::get_chunk_mesh(const Vector2i &p_chunk) const {
+	const Chunk *chunk = _chunks.getptr(p_chunk);
+	return chunk ? chunk->mesh : Ref<ArrayMesh>();
+}
+TypedArray<ConvexPolygonShape2D> CrossSectionChunkGrid::get_chunk_shapes(const Vector2i &p_chunk) const {
+	const Chunk *chunk = _chunks.getptr(p_chunk);
+	return chunk ? chunk->shapes : TypedArray<ConvexPolygonShape2D>();
+}
+
+// Rebuilds the mesh and shapes of every chunk changed since the last update, and returns those
+// chunks. Chunks that were emptied are dropped, so their getters return nothing afterwards.
+TypedArray<Vector2i> CrossSectionChunkGrid::update() {
+	struct Rebuild {
+		Vector2i chunk;
+		Ref<CrossSection> cross_section;
+		Array arrays;
+		TypedArray<PackedVector2Array> pieces;
+	};
+	LocalVector<Rebuild> rebuilds;
+	for (KeyValue<Vector2i, Chunk> &E : _chunks) {
+		if (E.value.dirty) {
+			rebuilds.push_back({ E.key, E.value.cross_section, Array(), TypedArray<PackedVector2Array>() });
+		}
+	}
+
+	// triangulation and convex partitioning happen on the workers; the mesh and shape resources are
+	// created here, since they talk to the rendering and physics servers
+	parallel_for(rebuilds.size(), [&](uint32_t p_rebuild) {
+		Rebuild &rebuild = rebuilds[p_rebuild];
+		if (!rebuild.cross_section->is_empty()) {
+			rebuild.arrays = rebuild.cross_section->to_mesh_arrays(get_chunk_rect(rebuild.chunk));
+			rebuild.pieces = rebuild.cross_section->to_convex_polygons(_max_convex_pieces);
+		}
+	});
+
+	TypedArray<Vector2i> updated;
+	for (const Rebuild &rebuild : rebuilds) {
+		updated.push_back(rebuild.chunk);
+		if (rebuild.arrays.is_empty()) {
+			_chunks.erase(rebuild.chunk);
+			continue;
+		}
+
+		Chunk &chunk = _chunks[rebuild.chunk];
+		chunk.mesh.instantiate();
+		chunk.mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, rebuild.arrays);
+		chunk.shapes.clear();
+		for (int64_t i = 0; i < rebuild.pieces.size(); i++) {
+			Ref<ConvexPolygonShape2D> shape;
+			shape.instantiate();
+			shape->set_points(rebuild.pieces[i]);
+			chunk.shapes.push_back(shape);
+		}
+		chunk.dirty = false;
+	}
+	return updated;
+}
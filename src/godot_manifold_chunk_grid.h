@@ -0,0 +1,57 @@
+#pragma once
+
+#include "godot_manifold_defs.h"
+
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/convex_polygon_shape2d.hpp>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+// A 2D region split into square chunks, for regions that are edited a little at a time (destructible
+// terrain and the like). An edit is clipped to each chunk it overlaps and only those chunks are
+// changed; update() then rebuilds the render mesh and collision shapes of the changed chunks only,
+// on worker threads.
+class CrossSectionChunkGrid : public godot::RefCounted {
+	GDCLASS(CrossSectionChunkGrid, godot::RefCounted);
+
+protected:
+	static void _bind_methods();
+
+private:
+	struct Chunk {
+		godot::Ref<CrossSection> cross_section;
+		godot::Ref<godot::ArrayMesh> mesh;
+		godot::TypedArray<godot::ConvexPolygonShape2D> shapes;
+		bool dirty = true;
+	};
+
+	double _chunk_size = 256.0;
+	int32_t _max_convex_pieces = 0;
+	godot::HashMap<godot::Vector2i, Chunk> _chunks;
+
+	godot::Vector2i _chunk_at(const godot::Vector2 &p_position) const;
+	void _edit(const godot::Ref<CrossSection> &p_cross_section, bool p_add);
+
+public:
+	void set_chunk_size(double p_chunk_size);
+	double get_chunk_size() const;
+	void set_max_convex_pieces(int32_t p_max_convex_pieces);
+	int32_t get_max_convex_pieces() const;
+
+	void set_cross_section(const godot::Ref<CrossSection> &p_cross_section);
+	godot::Ref<CrossSection> get_cross_section() const;
+	void add(const godot::Ref<CrossSection> &p_cross_section);
+	void subtract(const godot::Ref<CrossSection> &p_cross_section);
+	void clear();
+
+	godot::TypedArray<godot::Vector2i> get_chunks() const;
+	godot::TypedArray<godot::Vector2i> get_dirty_chunks() const;
+	godot::Rect2 get_chunk_rect(const godot::Vector2i &p_chunk) const;
+	godot::Ref<CrossSection> get_chunk_cross_section(const godot::Vector2i &p_chunk) const;
+	godot::Ref<godot::ArrayMesh> get_chunk_mesh(const godot::Vector2i &p_chunk) const;
+	godot::TypedArray<godot::ConvexPolygonShape2D> get_chunk_shapes(const godot::Vector2i &p_chunk) const;
+
+	godot::TypedArray<godot::Vector2i> update();
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "godot_manifold_parallel.h"
+
+#include <manifold/common.h>
+#include <manifold/cross_section.h>
+#include <manifold/polygon.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Hertel-Mehlhorn convex partitioning over an existing triangulation: every diagonal (an edge shared
+// by two triangles) is visited once, and removed when the vertices at both of its ends stay convex
+// in the merged piece. That gives at most four times the optimal number of pieces, and with the
+// pieces kept as linked half-edges each diagonal is checked and removed in constant time.
+
+// p_triangles index into p_vertices and are wound counter-clockwise, as manifold::Triangulate
+// returns them. Pieces are appended to r_pieces as indices into p_vertices, also counter-clockwise,
+// so pieces that meet share their vertices.
+static inline void convex_partition(const std::vector<manifold::vec2> &p_vertices, const std::vector<manifold::ivec3> &p_triangles, std::vector<std::vector<int32_t>> &r_pieces) {
+	const size_t half_edge_count = p_triangles.size() * 3;
+	const auto from = [&](size_t p_half_edge) -> int32_t {
+		return p_triangles[p_half_edge / 3][p_half_edge % 3];
+	};
+	const auto to = [&](size_t p_half_edge) -> int32_t {
+		return p_triangles[p_half_edge / 3][(p_half_edge + 1) % 3];
+	};
+
+	std::vector<uint32_t> next(half_edge_count);
+	std::vector<uint32_t> prev(half_edge_count);
+	for (size_t i = 0; i < half_edge_count; i++) {
+		next[i] = uint32_t(i - i % 3 + (i + 1) % 3);
+		prev[i] = uint32_t(i - i % 3 + (i + 2) % 3);
+	}
+
+	// pair up the two halves of each diagonal by sorting on the undirected edge; an edge used by any
+	// other number of triangles (only possible with degenerate input) is left alone
+	std::vector<std::pair<uint64_t, uint32_t>> edges(half_edge_count);
+	for (size_t i = 0; i < half_edge_count; i++) {
+		const uint64_t a = uint32_t(std::min(from(i), to(i)));
+		const uint64_t b = uint32_t(std::max(from(i), to(i)));
+		edges[i] = { a << 32 | b, uint32_t(i) };
+	}
+	std::sort(edges.begin(), edges.end());
+
+	const auto turn = [&](uint32_t p_in, uint32_t p_out) -> double {
+		const manifold::vec2 a = p_vertices[from(p_in)];
+		const manifold::vec2 b = p_vertices[to(p_in)];
+		const manifold::vec2 c = p_vertices[to(p_out)];
+		return (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+	};
+
+	std::vector<uint8_t> removed(half_edge_count, 0);
+	for (size_t i = 0; i < half_edge_count;) {
+		size_t end = i + 1;
+		while (end < half_edge_count && edges[end].first == edges[i].first) {
+			end++;
+		}
+		if (end - i == 2 && from(edges[i].second) == to(edges[i + 1].second)) {
+			const uint32_t h = edges[i].second;
+			const uint32_t twin = edges[i + 1].second;
+			// the last two checks catch a spike left by degenerate triangles
+			if (turn(prev[h], next[twin]) >= 0.0 && turn(prev[twin], next[h]) >= 0.0 && prev[h] != twin && next[h] != twin) {
+				next[prev[h]] = next[twin];
+				prev[next[twin]] = prev[h];
+				next[prev[twin]] = next[h];
+				prev[next[h]] = prev[twin];
+				removed[h] = 1;
+				removed[twin] = 1;
+			}
+		}
+		i = end;
+	}
+
+	for (size_t i = 0; i < half_edge_count; i++) {
+		if (removed[i]) {
+			continue;
+		}
+		std::vector<int32_t> &piece = r_pieces.emplace_back();
+		uint32_t h = uint32_t(i);
+		do {
+			piece.push_back(from(h));
+			removed[h] = 1;
+			h = next[h];
+		} while (h != i);
+	}
+}
+
+// As above, with the pieces appended to r_pieces as polygons of their own.
+static inline void convex_partition(const std::vector<manifold::vec2> &p_vertices, const std::vector<manifold::ivec3> &p_triangles, manifold::Polygons &r_pieces) {
+	std::vector<std::vector<int32_t>> pieces;
+	convex_partition(p_vertices, p_triangles, pieces);
+	r_pieces.reserve(r_pieces.size() + pieces.size());
+	for (const std::vector<int32_t> &piece : pieces) {
+		manifold::SimplePolygon &polygon = r_pieces.emplace_back();
+		polygon.reserve(piece.size());
+		for (const int32_t vertex : piece) {
+			polygon.push_back(p_vertices[vertex]);
+		}
+	}
+}
+
+// Convex pieces of a whole cross section over one shared vertex array: each component is
+// triangulated once and partitioned, so pieces that meet share their vertices, which is what lets
+// the navigation server join them up and a Polygon2D draw holes. Components are done in parallel.
+// Pieces are counter-clockwise.
+static inline void convex_partition_shared(const manifold::CrossSection &p_cross_section, std::vector<manifold::vec2> &r_vertices, std::vector<std::vector<int32_t>> &r_pieces) {
+	struct Component {
+		std::vector<manifold::vec2> vertices;
+		std::vector<std::vector<int32_t>> pieces;
+	};
+
+	const std::vector<manifold::CrossSection> sections = p_cross_section.Decompose();
+	std::vector<Component> components(sections.size());
+	parallel_for(uint32_t(sections.size()), [&](uint32_t p_component) {
+		const manifold::Polygons polygons = sections[p_component].ToPolygons();
+		Component &component = components[p_component];
+		for (const manifold::SimplePolygon &polygon : polygons) {
+			component.vertices.insert(component.vertices.end(), polygon.begin(), polygon.end());
+		}
+		convex_partition(component.vertices, manifold::Triangulate(polygons), component.pieces);
+	});
+
+	for (Component &component : components) {
+		const int32_t first_vertex = int32_t(r_vertices.size());
+		r_vertices.insert(r_vertices.end(), component.vertices.begin(), component.vertices.end());
+		for (std::vector<int32_t> &piece : component.pieces) {
+			for (int32_t &vertex : piece) {
+				vertex += first_vertex;
+			}
+			r_pieces.push_back(std::move(piece));
+		}
+	}
+}
@@ -1,13 +1,26 @@
+#include "godot_manifold_cache.h"
 #include "godot_manifold_converters.h"
+#include "godot_manifold_convex_partition.h"
 #include "godot_manifold_defs.h"
+#include "godot_manifold_edge_grid.h"
+#include "godot_manifold_marching_squares.h"
+#include "godot_manifold_navigation.h"
+#include "godot_manifold_parallel.h"
+#include "godot_manifold_rasterizer.h"
 
 #include <godot_cpp/core/class_db.hpp>
 
-#include <godot_cpp/classes/geometry2d.hpp>
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/convex_polygon_shape2d.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/navigation_polygon.hpp>
+#include <godot_cpp/classes/polygon2d.hpp>
 
+#include <clipper2/clipper.h>
 #include <manifold/cross_section.h>
+#include <manifold/polygon.h>
 
-#include <polypartition.h>
+#include <mutex>
 
 using namespace godot;
 
@@ -28,12 +41,38 @@ void CrossSection::_bind_methods() {
 	static_assert(MITER == int(manifold::CrossSection::JoinType::Miter));
 	BIND_ENUM_CONSTANT(MITER);
 
+	static_assert(END_POLYGON == int(Clipper2Lib::EndType::Polygon));
+	BIND_ENUM_CONSTANT(END_POLYGON);
+	static_assert(END_JOINED == int(Clipper2Lib::EndType::Joined));
+	BIND_ENUM_CONSTANT(END_JOINED);
+	static_assert(END_BUTT == int(Clipper2Lib::EndType::Butt));
+	BIND_ENUM_CONSTANT(END_BUTT);
+	static_assert(END_SQUARE == int(Clipper2Lib::EndType::Square));
+	BIND_ENUM_CONSTANT(END_SQUARE);
+	static_assert(END_ROUND == int(Clipper2Lib::EndType::Round));
+	BIND_ENUM_CONSTANT(END_ROUND);
+
+	BIND_ENUM_CONSTANT(IMAGE_MASK);
+	BIND_ENUM_CONSTANT(IMAGE_COVERAGE);
+	BIND_ENUM_CONSTANT(IMAGE_SIGNED_DISTANCE);
+
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("from_simple_polygon", "simple_polygon", "fill_rule"), &CrossSection::from_simple_polygon, DEFVAL(POSITIVE));
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("from_polygons", "polygons", "fill_rule"), &CrossSection::from_polygons, DEFVAL(POSITIVE));
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("from_rect", "rect"), &CrossSection::from_rect);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("from_image", "image", "threshold", "channel", "simplify_epsilon"), &CrossSection::from_image, DEFVAL(0.5), DEFVAL(3), DEFVAL(0.5));
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("from_polyline_offset", "polyline", "width", "join_type", "end_type", "miter_limit", "circular_segments"), &CrossSection::from_polyline_offset, DEFVAL(2.0), DEFVAL(0));
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("from_polylines_offset", "polylines", "width", "join_type", "end_type", "miter_limit", "circular_segments"), &CrossSection::from_polylines_offset, DEFVAL(2.0), DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("to_polygons"), &CrossSection::to_polygons);
-	ClassDB::bind_method(D_METHOD("to_convex_polygons"), &CrossSection::to_convex_polygons);
+	ClassDB::bind_method(D_METHOD("to_convex_polygons", "max_pieces"), &CrossSection::to_convex_polygons, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("to_convex_shapes", "max_pieces"), &CrossSection::to_convex_shapes, DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("to_triangles"), &CrossSection::to_triangles);
+	ClassDB::bind_method(D_METHOD("to_mesh_arrays", "uv_rect"), &CrossSection::to_mesh_arrays, DEFVAL(Rect2()));
+	ClassDB::bind_method(D_METHOD("to_mesh_2d", "uv_rect"), &CrossSection::to_mesh_2d, DEFVAL(Rect2()));
+	ClassDB::bind_method(D_METHOD("to_image", "size", "transform", "mode"), &CrossSection::to_image, DEFVAL(Transform2D()), DEFVAL(IMAGE_MASK));
+	ClassDB::bind_method(D_METHOD("to_navigation_polygon", "agent_radius", "region"), &CrossSection::to_navigation_polygon, DEFVAL(10.0), DEFVAL(Rect2()));
+	ClassDB::bind_method(D_METHOD("fill_polygon_2d", "polygon_2d"), &CrossSection::fill_polygon_2d);
+	ClassDB::bind_method(D_METHOD("to_collision_polygons", "build_mode", "max_pieces"), &CrossSection::to_collision_polygons, DEFVAL(CollisionPolygon2D::BUILD_SOLIDS), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("to_occluder_polygons", "cull_mode"), &CrossSection::to_occluder_polygons, DEFVAL(OccluderPolygon2D::CULL_DISABLED));
 
 	ClassDB::bind_method(D_METHOD("decompose"), &CrossSection::decompose);
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("compose", "cross_sections"), &CrossSection::compose);
@@ -45,6 +84,8 @@ void CrossSection::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_contour_count"), &CrossSection::get_contour_count);
 	ClassDB::bind_method(D_METHOD("get_bounds"), &CrossSection::get_bounds);
 	ClassDB::bind_method(D_METHOD("get_area"), &CrossSection::get_area);
+	ClassDB::bind_method(D_METHOD("contains_points", "points"), &CrossSection::contains_points);
+	ClassDB::bind_method(D_METHOD("distance_to_points", "points", "signed"), &CrossSection::distance_to_points, DEFVAL(false));
 
 	ClassDB::bind_method(D_METHOD("translate", "offset"), &CrossSection::translate);
 	ClassDB::bind_method(D_METHOD("rotate", "degrees"), &CrossSection::rotate);
@@ -55,6 +96,9 @@ void CrossSection::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("warp_batch", "warp_vertices"), &CrossSection::warp_batch);
 	ClassDB::bind_method(D_METHOD("simplify", "epsilon"), &CrossSection::simplify, DEFVAL(1e-6));
 	ClassDB::bind_method(D_METHOD("offset", "delta", "join_type", "miter_limit", "circular_segments"), &CrossSection::offset, DEFVAL(2.0), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("offset_many", "deltas", "join_type", "miter_limit", "circular_segments"), &CrossSection::offset_many, DEFVAL(2.0), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("rect_clip", "rect"), &CrossSection::rect_clip);
+	ClassDB::bind_method(D_METHOD("rect_clip_many", "rects"), &CrossSection::rect_clip_many);
 
 	ClassDB::bind_method(D_METHOD("union", "with"), &CrossSection::union_with);
 	ClassDB::bind_method(D_METHOD("intersection", "with"), &CrossSection::intersection_with);
@@ -68,6 +112,19 @@ void CrossSection::_bind_methods() {
 
 struct CrossSection::Inner {
 	manifold::CrossSection _cross_section;
+	ManifoldCacheKey _content_hash;
+	bool _has_content_hash = false;
+
+	// built on the first point query
+	std::once_flag _edge_grid_built;
+	EdgeGrid _edge_grid;
+
+	const EdgeGrid &get_edge_grid() {
+		std::call_once(_edge_grid_built, [this]() {
+			_edge_grid.build(_cross_section.ToPolygons());
+		});
+		return _edge_grid;
+	}
 };
 
 CrossSection::CrossSection() {
@@ -82,6 +139,10 @@ CrossSection::~CrossSection() {
 	_inner = nullptr;
 }
 
+const manifold::CrossSection &CrossSection::_get_cross_section() const {
+	return _inner->_cross_section;
+}
+
 Ref<CrossSection> CrossSection::from_simple_polygon(const PackedVector2Array &p_simple_polygon, FillRule p_fill_rule) {
 	return memnew(CrossSection(manifold::CrossSection(to_simple_polygon(p_simple_polygon), manifold::CrossSection::FillRule(p_fill_rule))));
 }
@@ -91,6 +152,100 @@ Ref<CrossSection> CrossSection::from_polygons(const TypedArray<PackedVector2Arra
 Ref<CrossSection> CrossSection::from_rect(const Rect2 &p_rect) {
 	return memnew(CrossSection(manifold::CrossSection(to_rect(p_rect))));
 }
+
+// image rows traced or filled by each task
+constexpr int32_t IMAGE_BAND_ROWS = 64;
+
+Ref<CrossSection> CrossSection::from_image(const Ref<Image> &p_image, double p_threshold, int32_t p_channel, double p_simplify_epsilon) {
+	ERR_FAIL_COND_V(p_image.is_null() || p_image->is_empty(), nullptr);
+	ERR_FAIL_INDEX_V(p_channel, 4, nullptr);
+	ERR_FAIL_COND_V(p_threshold < 0.0 || p_threshold >= 1.0, nullptr);
+
+	Ref<Image> image = p_image;
+	if (image->get_format() != Image::FORMAT_RGBA8) {
+		image = p_image->duplicate();
+		if (image->is_compressed()) {
+			ERR_FAIL_COND_V(image->decompress() != OK, nullptr);
+		}
+		image->convert(Image::FORMAT_RGBA8);
+	}
+
+	// the first mipmap level comes first in the data
+	const int32_t width = image->get_width();
+	const int32_t height = image->get_height();
+	const PackedByteArray data = image->get_data();
+	const uint8_t *pixels = data.ptr();
+	const auto value = [&](int32_t p_x, int32_t p_y) -> float {
+		return pixels[(size_t(p_y) * width + p_x) * 4 + p_channel] * (1.0f / 255.0f);
+	};
+
+	// cell rows run from -1, outside the top of the image, to the last pixel row
+	std::vector<std::vector<MarchingSquaresSegment>> bands((height + IMAGE_BAND_ROWS) / IMAGE_BAND_ROWS);
+	parallel_for(uint32_t(bands.size()), [&](uint32_t p_band) {
+		const int32_t first_row = int32_t(p_band) * IMAGE_BAND_ROWS - 1;
+		marching_squares_band(width, height, float(p_threshold), first_row, MIN(first_row + IMAGE_BAND_ROWS, height), value, bands[p_band]);
+	});
+
+	manifold::CrossSection cross_section(stitch_marching_squares(bands), manifold::CrossSection::FillRule::NonZero);
+	if (p_simplify_epsilon > 0.0) {
+		cross_section = cross_section.Simplify(p_simplify_epsilon);
+	}
+	return memnew(CrossSection(cross_section));
+}
+
+// manifold keeps its cross sections in Clipper2 with this many decimal places, and offsets them the
+// same way; see CrossSection::Offset in manifold
+constexpr int32_t CLIPPER_PRECISION = 8;
+
+static constexpr Clipper2Lib::JoinType clipper_join_types[] = { Clipper2Lib::JoinType::Square, Clipper2Lib::JoinType::Round, Clipper2Lib::JoinType::Miter };
+
+// the (scaled) arc tolerance that gives back the requested number of segments per full circle
+static double clipper_arc_tolerance(double p_delta, int32_t p_circular_segments) {
+	const double delta = std::abs(p_delta);
+	const int32_t segments = p_circular_segments > 2 ? p_circular_segments : manifold::Quality::GetCircularSegments(delta);
+	return (1.0 - std::cos(Math_PI / segments)) * delta * std::pow(10.0, CLIPPER_PRECISION);
+}
+
+static manifold::CrossSection from_clipper_paths(const Clipper2Lib::PathsD &p_paths) {
+	manifold::Polygons polygons;
+	polygons.reserve(p_paths.size());
+	for (const Clipper2Lib::PathD &path : p_paths) {
+		manifold::SimplePolygon &polygon = polygons.emplace_back();
+		polygon.reserve(path.size());
+		for (const Clipper2Lib::PointD &point : path) {
+			polygon.push_back({ point.x, point.y });
+		}
+	}
+	// offset holes come out wound the other way
+	return manifold::CrossSection(polygons, manifold::CrossSection::FillRule::NonZero);
+}
+
+Ref<CrossSection> CrossSection::from_polyline_offset(const PackedVector2Array &p_polyline, double p_width, JoinType p_join_type, EndType p_end_type, double p_miter_limit, int32_t p_circular_segments) {
+	TypedArray<PackedVector2Array> polylines;
+	polylines.push_back(p_polyline);
+	return from_polylines_offset(polylines, p_width, p_join_type, p_end_type, p_miter_limit, p_circular_segments);
+}
+Ref<CrossSection> CrossSection::from_polylines_offset(const TypedArray<PackedVector2Array> &p_polylines, double p_width, JoinType p_join_type, EndType p_end_type, double p_miter_limit, int32_t p_circular_segments) {
+	ERR_FAIL_COND_V(p_width <= 0.0, nullptr);
+	ERR_FAIL_INDEX_V(p_join_type, MITER + 1, nullptr);
+	ERR_FAIL_INDEX_V(p_end_type, END_ROUND + 1, nullptr);
+
+	Clipper2Lib::PathsD paths;
+	paths.reserve(p_polylines.size());
+	for (int64_t i = 0; i < p_polylines.size(); i++) {
+		const PackedVector2Array polyline = p_polylines[i];
+		Clipper2Lib::PathD &path = paths.emplace_back();
+		path.reserve(polyline.size());
+		for (const Vector2 &point : polyline) {
+			path.emplace_back(point.x, point.y);
+		}
+	}
+
+	const double delta = p_width * 0.5;
+	const double arc_tolerance = p_join_type == ROUND || p_end_type == END_ROUND ? clipper_arc_tolerance(delta, p_circular_segments) : 0.0;
+	const Clipper2Lib::PathsD inflated = Clipper2Lib::InflatePaths(paths, delta, clipper_join_types[p_join_type], Clipper2Lib::EndType(p_end_type), p_miter_limit, CLIPPER_PRECISION, arc_tolerance);
+	return memnew(CrossSection(from_clipper_paths(inflated)));
+}
 TypedArray<PackedVector2Array> CrossSection::to_polygons() const {
 	return ::from_polygons(_inner->_cross_section.ToPolygons());
 }
@@ -105,113 +260,394 @@ TypedArray<CrossSection> CrossSection::decompose() const {
 	return wrapped_sections;
 }
 
-// This will eventually be available in Godot directly once https://github.com/godotengine/godot/pull/104407 is merged, but why wait?
-TypedArray<PackedVector2Array> CrossSection::to_convex_polygons() const {
-	const TypedArray<PackedVector2Array> polygons_and_holes = to_polygons();
-
-	TypedArray<PackedVector2Array> decomp;
-	TPPLPolyList in_poly, out_poly;
-
-	for (int64_t i = 0; i < polygons_and_holes.size(); i++) {
-		const PackedVector2Array polygon_or_hole = polygons_and_holes[i];
-
-		TPPLPoly inp;
-		inp.Init(polygon_or_hole.size());
-		for (int64_t j = 0; j < polygon_or_hole.size(); j++) {
-			inp[j].x = polygon_or_hole[j].x;
-			inp[j].y = polygon_or_hole[j].y;
+ManifoldCacheKey CrossSection::_get_content_hash() const {
+	if (unlikely(!_inner->_has_content_hash)) {
+		ManifoldHasher hasher;
+		for (const manifold::SimplePolygon &polygon : _inner->_cross_section.ToPolygons()) {
+			hasher.add_vector(polygon);
 		}
-
-		if (Geometry2D::get_singleton()->is_polygon_clockwise(polygon_or_hole)) {
-			inp.SetOrientation(TPPL_ORIENTATION_CW);
-			inp.SetHole(true);
-		} else {
-			inp.SetOrientation(TPPL_ORIENTATION_CCW);
+		_inner->_content_hash = hasher.finish();
+		_inner->_has_content_hash = true;
+	}
+	return _inner->_content_hash;
+}
+
+// when there would be too many convex pieces, the cross section is simplified with this tolerance
+// (relative to the longest side of its bounds), doubled up to this many times
+constexpr double CONVEX_FIRST_TOLERANCE = 0.002;
+constexpr int32_t CONVEX_MAX_SIMPLIFY_STEPS = 8;
+
+// Partitions each component separately, in parallel, returning the pieces of every component.
+static std::vector<manifold::Polygons> partition_components(const std::vector<manifold::CrossSection> &p_components) {
+	std::vector<manifold::Polygons> pieces(p_components.size());
+	parallel_for(uint32_t(p_components.size()), [&](uint32_t p_component) {
+		const manifold::Polygons polygons = p_components[p_component].ToPolygons();
+		std::vector<manifold::vec2> vertices;
+		for (const manifold::SimplePolygon &polygon : polygons) {
+			vertices.insert(vertices.end(), polygon.begin(), polygon.end());
 		}
+		convex_partition(vertices, manifold::Triangulate(polygons), pieces[p_component]);
+	});
+	return pieces;
+}
+
+static manifold::Polygons convex_pieces(const manifold::CrossSection &p_cross_section, int32_t p_max_pieces) {
+	std::vector<manifold::CrossSection> components = p_cross_section.Decompose();
+	std::vector<manifold::Polygons> pieces = partition_components(components);
+	const auto count_pieces = [&]() {
+		size_t count = 0;
+		for (const manifold::Polygons &component : pieces) {
+			count += component.size();
+		}
+		return count;
+	};
 
-		DEV_ASSERT(inp.Valid());
-
-		in_poly.push_back(inp);
+	if (p_max_pieces > 0 && count_pieces() > size_t(p_max_pieces)) {
+		const manifold::vec2 size = p_cross_section.Bounds().Size();
+		double tolerance = std::max(size.x, size.y) * CONVEX_FIRST_TOLERANCE;
+		for (int32_t step = 0; step < CONVEX_MAX_SIMPLIFY_STEPS && count_pieces() > size_t(p_max_pieces); step++) {
+			components = p_cross_section.Simplify(tolerance).Decompose();
+			pieces = partition_components(components);
+			tolerance *= 2.0;
+		}
 	}
 
-	TPPLPartition tpart;
-	if (tpart.ConvexPartition_HM(&in_poly, &out_poly) == 0) {
-		ERR_PRINT("Convex decomposing failed!");
-		return decomp;
+	manifold::Polygons all_pieces;
+	for (manifold::Polygons &component : pieces) {
+		std::move(component.begin(), component.end(), std::back_inserter(all_pieces));
+	}
+	if (p_max_pieces <= 0 || all_pieces.size() <= size_t(p_max_pieces)) {
+		return all_pieces;
 	}
 
-	decomp.resize(out_poly.size());
-	int idx = 0;
-	for (const TPPLPoly &tp : out_poly) {
-		PackedVector2Array dp;
-		dp.resize(tp.GetNumPoints());
-
-		for (int64_t i = 0; i < tp.GetNumPoints(); i++) {
-			dp[i].x = static_cast<real_t>(tp.GetPoint(i).x);
-			dp[i].y = static_cast<real_t>(tp.GetPoint(i).y);
+	// still too many: the smallest pieces are dropped. That leaves gaps where they were, but unlike
+	// replacing a component with its hull it never fills in holes or concavities
+	std::vector<double> areas(all_pieces.size());
+	for (size_t i = 0; i < all_pieces.size(); i++) {
+		const manifold::SimplePolygon &piece = all_pieces[i];
+		double area = 0.0;
+		for (size_t j = 0, k = piece.size() - 1; j < piece.size(); k = j++) {
+			area += piece[k].x * piece[j].y - piece[j].x * piece[k].y;
 		}
+		areas[i] = area;
+	}
+	std::vector<size_t> order(all_pieces.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	std::nth_element(order.begin(), order.begin() + p_max_pieces, order.end(), [&](size_t p_a, size_t p_b) {
+		return areas[p_a] > areas[p_b];
+	});
+	std::sort(order.begin(), order.begin() + p_max_pieces);
+
+	WARN_PRINT(vformat("The cross section still has %d convex pieces after simplifying; only the largest %d are kept.", int64_t(all_pieces.size()), p_max_pieces));
+	manifold::Polygons kept;
+	kept.reserve(p_max_pieces);
+	for (int32_t i = 0; i < p_max_pieces; i++) {
+		kept.push_back(std::move(all_pieces[order[i]]));
+	}
+	return kept;
+}
 
-		decomp[idx] = dp;
-
-		idx++;
+// convex_pieces through the cache; p_content_hash is only called when the cache is on
+static manifold::Polygons cached_convex_pieces(const manifold::CrossSection &p_cross_section, int32_t p_max_pieces, const std::function<ManifoldCacheKey()> &p_content_hash) {
+	if (likely(!ManifoldCache::is_enabled())) {
+		return convex_pieces(p_cross_section, p_max_pieces);
 	}
 
-	return decomp;
+	ManifoldHasher hasher;
+	hasher.add_all("CrossSection.to_convex_polygons", p_content_hash(), uint64_t(p_max_pieces));
+	const ManifoldCacheKey key = hasher.finish();
+
+	manifold::Polygons pieces;
+	if (!ManifoldCache::lookup_polygons(key, pieces)) {
+		pieces = convex_pieces(p_cross_section, p_max_pieces);
+		ManifoldCache::store_polygons(key, pieces);
+	}
+	return pieces;
 }
 
-PackedVector2Array CrossSection::to_triangles() const {
-	const TypedArray<PackedVector2Array> polygons_and_holes = to_polygons();
+TypedArray<PackedVector2Array> CrossSection::to_convex_polygons(int32_t p_max_pieces) const {
+	ERR_FAIL_COND_V(p_max_pieces < 0, TypedArray<PackedVector2Array>());
+	return ::from_polygons(cached_convex_pieces(_inner->_cross_section, p_max_pieces, [this]() { return _get_content_hash(); }));
+}
 
-	PackedVector2Array decomp;
-	TPPLPolyList in_poly, out_poly;
+TypedArray<ConvexPolygonShape2D> CrossSection::to_convex_shapes(int32_t p_max_pieces) const {
+	const TypedArray<PackedVector2Array> pieces = to_convex_polygons(p_max_pieces);
 
-	for (int64_t i = 0; i < polygons_and_holes.size(); i++) {
-		const PackedVector2Array polygon_or_hole = polygons_and_holes[i];
+	TypedArray<ConvexPolygonShape2D> shapes;
+	shapes.resize(pieces.size());
+	for (int64_t i = 0; i < pieces.size(); i++) {
+		Ref<ConvexPolygonShape2D> shape;
+		shape.instantiate();
+		shape->set_points(pieces[i]);
+		shapes[i] = shape;
+	}
+	return shapes;
+}
+
+// Triangulates each component separately (they can't share triangles) with manifold's triangulator,
+// which copes with the degenerate and near-touching contours boolean results are full of. The
+// vertices are the contour vertices, each used once, and the indices refer to them.
+static void triangulate(const manifold::CrossSection &p_cross_section, PackedVector2Array &r_vertices, PackedInt32Array &r_indices) {
+	struct Component {
+		manifold::Polygons polygons;
+		std::vector<manifold::ivec3> triangles;
+		int32_t first_vertex = 0;
+		int32_t first_index = 0;
+	};
 
-		TPPLPoly inp;
-		inp.Init(polygon_or_hole.size());
-		for (int64_t j = 0; j < polygon_or_hole.size(); j++) {
-			inp[j].x = polygon_or_hole[j].x;
-			inp[j].y = polygon_or_hole[j].y;
+	std::vector<Component> components;
+	if (p_cross_section.NumContour() > 1) {
+		const std::vector<manifold::CrossSection> sections = p_cross_section.Decompose();
+		components.resize(sections.size());
+		for (size_t i = 0; i < sections.size(); i++) {
+			components[i].polygons = sections[i].ToPolygons();
 		}
+	} else {
+		components.resize(1);
+		components[0].polygons = p_cross_section.ToPolygons();
+	}
 
-		if (Geometry2D::get_singleton()->is_polygon_clockwise(polygon_or_hole)) {
-			inp.SetOrientation(TPPL_ORIENTATION_CW);
-			inp.SetHole(true);
-		} else {
-			inp.SetOrientation(TPPL_ORIENTATION_CCW);
+	parallel_for(uint32_t(components.size()), [&](uint32_t p_component) {
+		Component &component = components[p_component];
+		component.triangles = manifold::Triangulate(component.polygons);
+	});
+
+	int32_t vertex_count = 0;
+	int32_t index_count = 0;
+	for (Component &component : components) {
+		component.first_vertex = vertex_count;
+		component.first_index = index_count;
+		for (const manifold::SimplePolygon &polygon : component.polygons) {
+			vertex_count += int32_t(polygon.size());
 		}
+		index_count += int32_t(component.triangles.size() * 3);
+	}
 
-		DEV_ASSERT(inp.Valid());
+	r_vertices.resize(vertex_count);
+	r_indices.resize(index_count);
+	Vector2 *vertices = r_vertices.ptrw();
+	int32_t *indices = r_indices.ptrw();
+	parallel_for(uint32_t(components.size()), [&](uint32_t p_component) {
+		const Component &component = components[p_component];
+		Vector2 *vertex = vertices + component.first_vertex;
+		for (const manifold::SimplePolygon &polygon : component.polygons) {
+			vertex = std::transform(polygon.cbegin(), polygon.cend(), vertex, &from_vec2);
+		}
+		int32_t *index = indices + component.first_index;
+		for (const manifold::ivec3 &triangle : component.triangles) {
+			*index++ = component.first_vertex + triangle.x;
+			*index++ = component.first_vertex + triangle.y;
+			*index++ = component.first_vertex + triangle.z;
+		}
+	});
+}
 
-		in_poly.push_back(inp);
+PackedVector2Array CrossSection::to_triangles() const {
+	PackedVector2Array vertices;
+	PackedInt32Array indices;
+	triangulate(_inner->_cross_section, vertices, indices);
+
+	const Vector2 *vertex = vertices.ptr();
+	PackedVector2Array triangles;
+	triangles.resize(indices.size());
+	std::transform(indices.begin(), indices.end(), triangles.ptrw(), [vertex](int32_t p_index) {
+		return vertex[p_index];
+	});
+	return triangles;
+}
+
+Array CrossSection::to_mesh_arrays(const Rect2 &p_uv_rect) const {
+	PackedVector2Array vertices;
+	PackedInt32Array indices;
+	triangulate(_inner->_cross_section, vertices, indices);
+
+	// an empty rect maps the cross section's own bounds onto the texture
+	const Rect2 uv_rect = p_uv_rect.has_area() ? p_uv_rect : get_bounds();
+	const Vector2 uv_scale = uv_rect.has_area() ? Vector2(1.0, 1.0) / uv_rect.size : Vector2();
+	PackedVector2Array uvs;
+	uvs.resize(vertices.size());
+	std::transform(vertices.begin(), vertices.end(), uvs.ptrw(), [&](const Vector2 &p_vertex) {
+		return (p_vertex - uv_rect.position) * uv_scale;
+	});
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_TEX_UV] = uvs;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+	return arrays;
+}
+
+Ref<ArrayMesh> CrossSection::to_mesh_2d(const Rect2 &p_uv_rect) const {
+	Ref<ArrayMesh> mesh;
+	mesh.instantiate();
+	if (!is_empty()) {
+		mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, to_mesh_arrays(p_uv_rect));
+	}
+	return mesh;
+}
+
+// p_transform takes the cross section into pixels; pixel (x, y) covers [x, x + 1) by [y, y + 1).
+// The mask and coverage modes give an L8 image; the signed distance mode gives an RF image of the
+// distance in pixels from each pixel's centre to the nearest edge, negative inside.
+Ref<Image> CrossSection::to_image(const Vector2i &p_size, const Transform2D &p_transform, ImageMode p_mode) const {
+	ERR_FAIL_COND_V(p_size.x <= 0 || p_size.y <= 0, Ref<Image>());
+	ERR_FAIL_INDEX_V(p_mode, IMAGE_SIGNED_DISTANCE + 1, Ref<Image>());
+
+	const manifold::Polygons polygons = _inner->_cross_section.Transform(to_mat2x3(p_transform)).ToPolygons();
+	ScanlineRasterizer rasterizer;
+	rasterizer.build(polygons, p_size.x, p_size.y, IMAGE_BAND_ROWS);
+	const uint32_t band_count = uint32_t(rasterizer.get_band_count());
+	const size_t band_pixels = size_t(p_size.x) * IMAGE_BAND_ROWS;
+
+	PackedByteArray data;
+	if (p_mode != IMAGE_SIGNED_DISTANCE) {
+		data.resize(int64_t(p_size.x) * p_size.y);
+		uint8_t *pixels = data.ptrw();
+		parallel_for(band_count, [&](uint32_t p_band) {
+			if (p_mode == IMAGE_MASK) {
+				rasterizer.fill_mask(int32_t(p_band), pixels + p_band * band_pixels);
+			} else {
+				rasterizer.fill_coverage(int32_t(p_band), pixels + p_band * band_pixels);
+			}
+		});
+		return Image::create_from_data(p_size.x, p_size.y, false, Image::FORMAT_L8, data);
 	}
 
-	TPPLPartition tpart;
-	if (tpart.Triangulate_EC(&in_poly, &out_poly) == 0) {
-		ERR_PRINT("Triangulation failed!");
-		return decomp;
+	data.resize(int64_t(p_size.x) * p_size.y * int64_t(sizeof(float)));
+	float *distances = reinterpret_cast<float *>(data.ptrw());
+
+	// with no edges at all every pixel would be infinitely far outside; the image diagonal is
+	// farther than any edge the image could show, and keeps the values finite for shaders and blurs
+	if (polygons.empty()) {
+		std::fill(distances, distances + int64_t(p_size.x) * p_size.y, float(Vector2(p_size).length()));
+		return Image::create_from_data(p_size.x, p_size.y, false, Image::FORMAT_RF, data);
 	}
 
-	decomp.resize(out_poly.size() * 3);
-	int idx = 0;
-	for (const TPPLPoly &tp : out_poly) {
-		DEV_ASSERT(tp.GetNumPoints() == 3);
+	// exact distances from a grid over the edges in pixel space, signed by the mask so the sign
+	// agrees with IMAGE_MASK
+	EdgeGrid grid;
+	grid.build(polygons);
+	parallel_for(band_count, [&](uint32_t p_band) {
+		const int32_t first_row = int32_t(p_band) * IMAGE_BAND_ROWS;
+		const int32_t end_row = MIN(first_row + IMAGE_BAND_ROWS, p_size.y);
+		std::vector<uint8_t> mask(band_pixels);
+		rasterizer.fill_mask(int32_t(p_band), mask.data());
+		for (int32_t y = first_row; y < end_row; y++) {
+			for (int32_t x = 0; x < p_size.x; x++) {
+				const size_t pixel = size_t(y - first_row) * p_size.x + x;
+				const float distance = float(grid.distance(manifold::vec2(x + 0.5, y + 0.5)));
+				distances[p_band * band_pixels + pixel] = mask[pixel] ? -distance : distance;
+			}
+		}
+	});
+	return Image::create_from_data(p_size.x, p_size.y, false, Image::FORMAT_RF, data);
+}
 
-		decomp[idx].x = static_cast<real_t>(tp.GetPoint(0).x);
-		decomp[idx].y = static_cast<real_t>(tp.GetPoint(0).y);
-		idx++;
+// Shrinks the cross section by the agent's radius and splits it into convex polygons sharing their
+// vertices. With a region, only that rect is baked, looking at no more than twice the radius around
+// it, so a large area can be rebaked one region at a time and the regions still meet edge to edge.
+Ref<NavigationPolygon> CrossSection::to_navigation_polygon(double p_agent_radius, const Rect2 &p_region) const {
+	ERR_FAIL_COND_V(p_agent_radius < 0.0, Ref<NavigationPolygon>());
 
-		decomp[idx].x = static_cast<real_t>(tp.GetPoint(1).x);
-		decomp[idx].y = static_cast<real_t>(tp.GetPoint(1).y);
-		idx++;
+	manifold::CrossSection walkable = _inner->_cross_section;
+	if (p_region.has_area()) {
+		walkable = walkable.RectClip(to_rect(p_region.grow(p_agent_radius * 2.0)));
+	}
+	if (p_agent_radius > 0.0) {
+		// mitred like Godot's own baker
+		walkable = walkable.Offset(-p_agent_radius, manifold::CrossSection::JoinType::Miter);
+	}
+	if (p_region.has_area()) {
+		walkable = walkable.RectClip(to_rect(p_region));
+	}
 
-		decomp[idx].x = static_cast<real_t>(tp.GetPoint(2).x);
-		decomp[idx].y = static_cast<real_t>(tp.GetPoint(2).y);
-		idx++;
+	std::vector<manifold::vec2> vertices;
+	std::vector<std::vector<int32_t>> polygons;
+	convex_partition_shared(walkable, vertices, polygons);
+
+	Ref<NavigationPolygon> navigation_polygon;
+	navigation_polygon.instantiate();
+	navigation_polygon->set_agent_radius(p_agent_radius);
+	PackedVector2Array wrapped_vertices;
+	wrapped_vertices.resize(vertices.size());
+	std::transform(vertices.begin(), vertices.end(), wrapped_vertices.ptrw(), &from_vec2);
+	navigation_polygon->set_vertices(wrapped_vertices);
+	for (const std::vector<int32_t> &polygon : polygons) {
+		PackedInt32Array indices;
+		indices.resize(polygon.size());
+		std::copy(polygon.begin(), polygon.end(), indices.ptrw());
+		navigation_polygon->add_polygon(indices);
+	}
+	return navigation_polygon;
+}
+
+// Sets the polygon of a Polygon2D to the cross section's vertices, and its polygons to convex pieces
+// indexing them, which is how a Polygon2D draws holes. Its UVs and vertex colors are cleared, since
+// they no longer line up with the vertices; everything else about it is left as it was.
+void CrossSection::fill_polygon_2d(Polygon2D *p_polygon_2d) const {
+	ERR_FAIL_NULL(p_polygon_2d);
+
+	std::vector<manifold::vec2> vertices;
+	std::vector<std::vector<int32_t>> pieces;
+	convex_partition_shared(_inner->_cross_section, vertices, pieces);
+
+	PackedVector2Array polygon;
+	polygon.resize(vertices.size());
+	std::transform(vertices.begin(), vertices.end(), polygon.ptrw(), &from_vec2);
+	Array polygons;
+	polygons.resize(pieces.size());
+	for (size_t i = 0; i < pieces.size(); i++) {
+		PackedInt32Array indices;
+		indices.resize(pieces[i].size());
+		std::copy(pieces[i].begin(), pieces[i].end(), indices.ptrw());
+		polygons[i] = indices;
 	}
 
-	return decomp;
+	p_polygon_2d->set_uv(PackedVector2Array());
+	p_polygon_2d->set_vertex_colors(PackedColorArray());
+	p_polygon_2d->set_internal_vertex_count(0);
+	p_polygon_2d->set_polygon(polygon);
+	p_polygon_2d->set_polygons(polygons);
+}
+
+// New CollisionPolygon2D nodes for the caller to add to the tree. Solids can't have holes, so they
+// get one node per convex piece (as from to_convex_polygons()), which also spares them decomposing
+// the polygon again; segments get one node per contour, holes included.
+TypedArray<CollisionPolygon2D> CrossSection::to_collision_polygons(CollisionPolygon2D::BuildMode p_build_mode, int32_t p_max_pieces) const {
+	ERR_FAIL_INDEX_V(p_build_mode, CollisionPolygon2D::BUILD_SEGMENTS + 1, TypedArray<CollisionPolygon2D>());
+	ERR_FAIL_COND_V(p_max_pieces < 0, TypedArray<CollisionPolygon2D>());
+
+	// solids get one node per convex piece, which CollisionPolygon2D's own decomposition keeps whole
+	const manifold::Polygons polygons = p_build_mode == CollisionPolygon2D::BUILD_SOLIDS ? cached_convex_pieces(_inner->_cross_section, p_max_pieces, [this]() { return _get_content_hash(); }) : _inner->_cross_section.ToPolygons();
+	TypedArray<CollisionPolygon2D> nodes;
+	nodes.resize(polygons.size());
+	for (size_t i = 0; i < polygons.size(); i++) {
+		CollisionPolygon2D *node = memnew(CollisionPolygon2D);
+		node->set_build_mode(p_build_mode);
+		node->set_polygon(from_simple_polygon(polygons[i]));
+		nodes[i] = node;
+	}
+	return nodes;
+}
+
+// One closed occluder per contour. Holes wind the other way to outlines, so culling one side of the
+// occluders culls the same side of the cross section's edges everywhere.
+TypedArray<OccluderPolygon2D> CrossSection::to_occluder_polygons(OccluderPolygon2D::CullMode p_cull_mode) const {
+	ERR_FAIL_INDEX_V(p_cull_mode, OccluderPolygon2D::CULL_COUNTER_CLOCKWISE + 1, TypedArray<OccluderPolygon2D>());
+
+	TypedArray<OccluderPolygon2D> occluders;
+	for (const manifold::SimplePolygon &contour : _inner->_cross_section.ToPolygons()) {
+		Ref<OccluderPolygon2D> occluder;
+		occluder.instantiate();
+		occluder->set_closed(true);
+		occluder->set_cull_mode(p_cull_mode);
+		occluder->set_polygon(from_simple_polygon(contour));
+		occluders.push_back(occluder);
+	}
+	return occluders;
 }
 
 Ref<CrossSection> CrossSection::compose(const TypedArray<CrossSection> &p_cross_sections) {
@@ -247,6 +683,40 @@ double CrossSection::get_area() const {
 	return _inner->_cross_section.Area();
 }
 
+// points are queried in batches of this many, each batch on one thread
+constexpr uint32_t POINT_QUERY_BATCH = 1024;
+
+PackedByteArray CrossSection::contains_points(const PackedVector2Array &p_points) const {
+	const EdgeGrid &grid = _inner->get_edge_grid();
+	PackedByteArray contained;
+	contained.resize(p_points.size());
+	const Vector2 *points = p_points.ptr();
+	uint8_t *results = contained.ptrw();
+	parallel_for(uint32_t((p_points.size() + POINT_QUERY_BATCH - 1) / POINT_QUERY_BATCH), [&](uint32_t p_batch) {
+		const int64_t end = MIN(int64_t(p_batch + 1) * POINT_QUERY_BATCH, p_points.size());
+		for (int64_t i = int64_t(p_batch) * POINT_QUERY_BATCH; i < end; i++) {
+			results[i] = grid.contains(to_vec2(points[i]));
+		}
+	});
+	return contained;
+}
+PackedFloat32Array CrossSection::distance_to_points(const PackedVector2Array &p_points, bool p_signed) const {
+	const EdgeGrid &grid = _inner->get_edge_grid();
+	PackedFloat32Array distances;
+	distances.resize(p_points.size());
+	const Vector2 *points = p_points.ptr();
+	float *results = distances.ptrw();
+	parallel_for(uint32_t((p_points.size() + POINT_QUERY_BATCH - 1) / POINT_QUERY_BATCH), [&](uint32_t p_batch) {
+		const int64_t end = MIN(int64_t(p_batch + 1) * POINT_QUERY_BATCH, p_points.size());
+		for (int64_t i = int64_t(p_batch) * POINT_QUERY_BATCH; i < end; i++) {
+			const manifold::vec2 point = to_vec2(points[i]);
+			const double distance = grid.distance(point);
+			results[i] = float(p_signed && grid.contains(point) ? -distance : distance);
+		}
+	});
+	return distances;
+}
+
 Ref<CrossSection> CrossSection::translate(const Vector2 &p_offset) const {
 	return memnew(CrossSection(_inner->_cross_section.Translate(to_vec2(p_offset))));
 }
@@ -287,6 +757,52 @@ Ref<CrossSection> CrossSection::simplify(double p_epsilon) const {
 Ref<CrossSection> CrossSection::offset(double p_delta, JoinType p_join_type, double p_miter_limit, int32_t p_circular_segments) const {
 	return memnew(CrossSection(_inner->_cross_section.Offset(p_delta, manifold::CrossSection::JoinType(p_join_type), p_miter_limit, p_circular_segments)));
 }
+TypedArray<CrossSection> CrossSection::offset_many(const PackedFloat64Array &p_deltas, JoinType p_join_type, double p_miter_limit, int32_t p_circular_segments) const {
+	ERR_FAIL_INDEX_V(p_join_type, MITER + 1, TypedArray<CrossSection>());
+
+	// applies any pending transform now, so it is done once and the threads share the result.
+	// Each offset goes through manifold's own Offset: the public CrossSection constructors union
+	// their polygons again, which Offset avoids by keeping Clipper2's result as it is
+	const manifold::CrossSection &cross_section = _inner->_cross_section;
+	cross_section.NumContour();
+
+	std::vector<manifold::CrossSection> offsets(p_deltas.size());
+	const double *deltas = p_deltas.ptr();
+	parallel_for(uint32_t(offsets.size()), [&](uint32_t p_delta) {
+		offsets[p_delta] = cross_section.Offset(deltas[p_delta], manifold::CrossSection::JoinType(p_join_type), p_miter_limit, p_circular_segments);
+	});
+
+	TypedArray<CrossSection> wrapped_sections;
+	wrapped_sections.resize(offsets.size());
+	for (size_t i = 0; i < offsets.size(); i++) {
+		wrapped_sections[i] = Ref<CrossSection>(memnew(CrossSection(offsets[i])));
+	}
+	return wrapped_sections;
+}
+Ref<CrossSection> CrossSection::rect_clip(const Rect2 &p_rect) const {
+	return memnew(CrossSection(_inner->_cross_section.RectClip(to_rect(p_rect))));
+}
+TypedArray<CrossSection> CrossSection::rect_clip_many(const TypedArray<Rect2> &p_rects) const {
+	// applies any pending transform now, before the threads share the cross section
+	const manifold::CrossSection &cross_section = _inner->_cross_section;
+	cross_section.NumContour();
+
+	std::vector<manifold::CrossSection> clipped(p_rects.size());
+	std::vector<manifold::Rect> rects(p_rects.size());
+	for (size_t i = 0; i < rects.size(); i++) {
+		rects[i] = to_rect(p_rects[i]);
+	}
+	parallel_for(uint32_t(rects.size()), [&](uint32_t p_rect) {
+		clipped[p_rect] = cross_section.RectClip(rects[p_rect]);
+	});
+
+	TypedArray<CrossSection> wrapped_sections;
+	wrapped_sections.resize(clipped.size());
+	for (size_t i = 0; i < clipped.size(); i++) {
+		wrapped_sections[i] = Ref<CrossSection>(memnew(CrossSection(clipped[i])));
+	}
+	return wrapped_sections;
+}
 
 Ref<CrossSection> CrossSection::union_with(const Ref<CrossSection> &p_with) const {
 	ERR_FAIL_COND_V(p_with.is_null(), nullptr);
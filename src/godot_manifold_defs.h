@@ -3,13 +3,23 @@
 #include <gdextension_interface.h>
 
 #include <functional>
+#include <vector>
 
+#include <godot_cpp/classes/collision_polygon2d.hpp>
+#include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/material.hpp>
 #include <godot_cpp/classes/mesh.hpp>
+#include <godot_cpp/classes/occluder_polygon2d.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #include <godot_cpp/templates/pair.hpp>
 
 namespace godot {
 class ArrayMesh;
+class ConvexPolygonShape2D;
+class Image;
+class NavigationMesh;
+class NavigationPolygon;
+class Polygon2D;
 }
 
 namespace manifold {
@@ -20,6 +30,9 @@ class Manifold;
 } //namespace manifold
 
 class Manifold;
+struct ManifoldCacheKey;
+class ManifoldHasher;
+struct ExportSurface;
 
 class CrossSection : public godot::RefCounted {
 	GDCLASS(CrossSection, godot::RefCounted);
@@ -41,6 +54,20 @@ public:
 		MITER,
 	};
 
+	enum EndType {
+		END_POLYGON,
+		END_JOINED,
+		END_BUTT,
+		END_SQUARE,
+		END_ROUND,
+	};
+
+	enum ImageMode {
+		IMAGE_MASK,
+		IMAGE_COVERAGE,
+		IMAGE_SIGNED_DISTANCE,
+	};
+
 	CrossSection();
 	CrossSection(const manifold::CrossSection &p_cross_section);
 	~CrossSection();
@@ -48,9 +75,20 @@ public:
 	static godot::Ref<CrossSection> from_simple_polygon(const godot::PackedVector2Array &p_simple_polygon, FillRule p_fill_rule = POSITIVE);
 	static godot::Ref<CrossSection> from_polygons(const godot::TypedArray<godot::PackedVector2Array> &p_polygons, FillRule p_fill_rule = POSITIVE);
 	static godot::Ref<CrossSection> from_rect(const godot::Rect2 &p_rect);
+	static godot::Ref<CrossSection> from_image(const godot::Ref<godot::Image> &p_image, double p_threshold = 0.5, int32_t p_channel = 3, double p_simplify_epsilon = 0.5);
+	static godot::Ref<CrossSection> from_polyline_offset(const godot::PackedVector2Array &p_polyline, double p_width, JoinType p_join_type, EndType p_end_type, double p_miter_limit = 2.0, int32_t p_circular_segments = 0);
+	static godot::Ref<CrossSection> from_polylines_offset(const godot::TypedArray<godot::PackedVector2Array> &p_polylines, double p_width, JoinType p_join_type, EndType p_end_type, double p_miter_limit = 2.0, int32_t p_circular_segments = 0);
 	godot::TypedArray<godot::PackedVector2Array> to_polygons() const;
-	godot::TypedArray<godot::PackedVector2Array> to_convex_polygons() const;
+	godot::TypedArray<godot::PackedVector2Array> to_convex_polygons(int32_t p_max_pieces = 0) const;
+	godot::TypedArray<godot::ConvexPolygonShape2D> to_convex_shapes(int32_t p_max_pieces = 0) const;
 	godot::PackedVector2Array to_triangles() const;
+	godot::Array to_mesh_arrays(const godot::Rect2 &p_uv_rect = godot::Rect2()) const;
+	godot::Ref<godot::ArrayMesh> to_mesh_2d(const godot::Rect2 &p_uv_rect = godot::Rect2()) const;
+	godot::Ref<godot::Image> to_image(const godot::Vector2i &p_size, const godot::Transform2D &p_transform = godot::Transform2D(), ImageMode p_mode = IMAGE_MASK) const;
+	godot::Ref<godot::NavigationPolygon> to_navigation_polygon(double p_agent_radius = 10.0, const godot::Rect2 &p_region = godot::Rect2()) const;
+	void fill_polygon_2d(godot::Polygon2D *p_polygon_2d) const;
+	godot::TypedArray<godot::CollisionPolygon2D> to_collision_polygons(godot::CollisionPolygon2D::BuildMode p_build_mode = godot::CollisionPolygon2D::BUILD_SOLIDS, int32_t p_max_pieces = 0) const;
+	godot::TypedArray<godot::OccluderPolygon2D> to_occluder_polygons(godot::OccluderPolygon2D::CullMode p_cull_mode = godot::OccluderPolygon2D::CULL_DISABLED) const;
 
 	godot::TypedArray<CrossSection> decompose() const;
 	static godot::Ref<CrossSection> compose(const godot::TypedArray<CrossSection> &p_cross_sections);
@@ -62,6 +100,8 @@ public:
 	uint64_t get_contour_count() const;
 	godot::Rect2 get_bounds() const;
 	double get_area() const;
+	godot::PackedByteArray contains_points(const godot::PackedVector2Array &p_points) const;
+	godot::PackedFloat32Array distance_to_points(const godot::PackedVector2Array &p_points, bool p_signed = false) const;
 
 	godot::Ref<CrossSection> translate(const godot::Vector2 &p_offset) const;
 	godot::Ref<CrossSection> rotate(double p_degrees) const;
@@ -72,6 +112,9 @@ public:
 	godot::Ref<CrossSection> warp_batch(const godot::Callable &p_warp_vertices) const;
 	godot::Ref<CrossSection> simplify(double p_epsilon = 1e-6) const;
 	godot::Ref<CrossSection> offset(double p_delta, JoinType p_join_type, double p_miter_limit = 2.0, int32_t p_circular_segments = 0) const;
+	godot::TypedArray<CrossSection> offset_many(const godot::PackedFloat64Array &p_deltas, JoinType p_join_type, double p_miter_limit = 2.0, int32_t p_circular_segments = 0) const;
+	godot::Ref<CrossSection> rect_clip(const godot::Rect2 &p_rect) const;
+	godot::TypedArray<CrossSection> rect_clip_many(const godot::TypedArray<godot::Rect2> &p_rects) const;
 
 	godot::Ref<CrossSection> union_with(const godot::Ref<CrossSection> &p_with) const;
 	godot::Ref<CrossSection> intersection_with(const godot::Ref<CrossSection> &p_with) const;
@@ -85,9 +128,16 @@ public:
 private:
 	struct Inner;
 	Inner *_inner;
+
+	friend class Manifold;
+	friend class ManifoldMesh;
+	const manifold::CrossSection &_get_cross_section() const;
+	ManifoldCacheKey _get_content_hash() const;
 };
 VARIANT_ENUM_CAST(CrossSection::FillRule);
 VARIANT_ENUM_CAST(CrossSection::JoinType);
+VARIANT_ENUM_CAST(CrossSection::EndType);
+VARIANT_ENUM_CAST(CrossSection::ImageMode);
 
 class ManifoldMesh32 : public godot::Resource {
 	GDCLASS(ManifoldMesh32, godot::Resource);
@@ -202,9 +252,17 @@ public:
 	static godot::Ref<Manifold> level_set(const std::function<double(godot::Vector3)> &p_sdf, godot::AABB p_bounds, double p_edge_length, double p_level = 0, double p_tolerance = -1);
 
 	godot::TypedArray<godot::PackedVector2Array> slice(double p_height = 0) const;
+	godot::TypedArray<CrossSection> slice_many(const godot::PackedFloat64Array &p_heights) const;
 	godot::TypedArray<godot::PackedVector2Array> project() const;
 	static godot::Ref<Manifold> extrude(const godot::TypedArray<godot::PackedVector2Array> &p_cross_section, double p_height, int p_num_divisions = 0, double p_twist_degrees = 0.0, godot::Vector2 p_scale_top = godot::Vector2(1.0f, 1.0f));
 	static godot::Ref<Manifold> revolve(const godot::TypedArray<godot::PackedVector2Array> &p_cross_section, int p_circular_segments = 0, double p_revolve_degrees = 360.0f);
+	godot::Ref<CrossSection> slice_cross_section(double p_height = 0) const;
+	godot::Ref<CrossSection> project_cross_section() const;
+	static godot::Ref<Manifold> extrude_cross_section(const godot::Ref<CrossSection> &p_cross_section, double p_height, int p_num_divisions = 0, double p_twist_degrees = 0.0, godot::Vector2 p_scale_top = godot::Vector2(1.0f, 1.0f));
+	static godot::Ref<Manifold> revolve_cross_section(const godot::Ref<CrossSection> &p_cross_section, int p_circular_segments = 0, double p_revolve_degrees = 360.0f);
+
+	godot::Error export_to_file(const godot::String &p_path) const;
+	int64_t export_to_file_async(const godot::String &p_path) const;
 
 	enum Error {
 		NO_ERROR = 0,
@@ -283,6 +341,11 @@ private:
 	struct Inner;
 	Inner *_inner;
 	friend struct Inner;
+
+	static void _export_task(const godot::Ref<Manifold> &p_manifold, const godot::String &p_path);
+
+	ManifoldCacheKey _get_content_hash() const;
+	static godot::Ref<Manifold> _cached_result(const std::vector<const Manifold *> &p_operands, const std::function<void(ManifoldHasher &)> &p_key, const std::function<manifold::Manifold()> &p_compute, bool p_adds_ids = false);
 };
 VARIANT_ENUM_CAST(Manifold::Error);
 
@@ -304,6 +367,12 @@ public:
 #endif
 	static_assert(std::is_same_v<Precision, godot::real_t>);
 
+	enum RetentionPolicy {
+		RETAIN_ALL,
+		RETAIN_GEOMETRY_ONLY,
+		RETAIN_RENDER_ONLY,
+	};
+
 	static uint32_t get_material_original_id(const godot::Ref<godot::Material> &p_material);
 
 private:
@@ -311,6 +380,10 @@ private:
 	godot::PackedInt32Array _surface_original_ids;
 	godot::TypedArray<godot::Material> _surface_materials;
 	godot::PackedStringArray _surface_names;
+	RetentionPolicy _retention_policy = RETAIN_ALL;
+	bool _generate_lods = true;
+	bool _create_shadow_mesh = true;
+	bool _optimize_vertex_cache = true;
 
 public:
 	ManifoldMesh();
@@ -324,11 +397,23 @@ public:
 	godot::TypedArray<godot::Material> get_surface_materials() const;
 	void set_surface_names(const godot::PackedStringArray &p_surface_names);
 	godot::PackedStringArray get_surface_names() const;
+	void set_retention_policy(RetentionPolicy p_retention_policy);
+	RetentionPolicy get_retention_policy() const;
+	void set_generate_lods(bool p_generate_lods);
+	bool get_generate_lods() const;
+	void set_create_shadow_mesh(bool p_create_shadow_mesh);
+	bool get_create_shadow_mesh() const;
+	void set_optimize_vertex_cache(bool p_optimize_vertex_cache);
+	bool get_optimize_vertex_cache() const;
+	godot::Dictionary get_vertex_cache_statistics() const;
 
 	bool is_valid() const;
 	bool is_empty() const;
 	void remove_unused_materials();
 
+	godot::Dictionary get_memory_usage() const;
+	static godot::Dictionary get_total_memory_usage();
+
 	void set_num_prop(I p_num_prop);
 	I get_num_prop() const;
 
@@ -379,6 +464,7 @@ public:
 	godot::RID _get_rid() const override;
 
 	static godot::Ref<ManifoldMesh> from_mesh(const godot::Ref<godot::Mesh> &p_mesh);
+	static godot::Ref<ManifoldMesh> import_from_file(const godot::String &p_path, double p_weld_tolerance = 0.0);
 	godot::Ref<godot::ArrayMesh> to_mesh(bool p_generate_lods = true, bool p_create_shadow_mesh = true, const godot::TypedArray<godot::Material> &p_skip_material = {}) const;
 
 	godot::TypedArray<ManifoldMesh> decompose() const;
@@ -389,9 +475,18 @@ public:
 	static godot::Ref<ManifoldMesh> level_set(const godot::Callable &p_sdf, const godot::AABB &p_bounds, double p_edge_length, double p_level = 0.0, double p_tolerance = -1.0, const godot::Ref<godot::Material> &p_material = nullptr);
 
 	godot::TypedArray<godot::PackedVector2Array> slice(double p_height = 0.0) const;
+	godot::TypedArray<CrossSection> slice_many(const godot::PackedFloat64Array &p_heights) const;
 	godot::TypedArray<godot::PackedVector2Array> project() const;
 	static godot::Ref<ManifoldMesh> extrude(const godot::TypedArray<godot::PackedVector2Array> &p_cross_section, double p_height, int32_t p_divisions = 0, double p_twist_degrees = 0.0, const godot::Vector2 &p_scale_top = godot::Vector2(1.0f, 1.0f), const godot::Ref<godot::Material> &p_material = nullptr);
 	static godot::Ref<ManifoldMesh> revolve(const godot::TypedArray<godot::PackedVector2Array> &p_cross_section, int32_t p_circular_segments = 0, double p_revolve_degrees = 360.0, const godot::Ref<godot::Material> &p_material = nullptr);
+	godot::Ref<CrossSection> slice_cross_section(double p_height = 0.0) const;
+	godot::Ref<CrossSection> project_cross_section() const;
+	static godot::Ref<ManifoldMesh> extrude_cross_section(const godot::Ref<CrossSection> &p_cross_section, double p_height, int32_t p_divisions = 0, double p_twist_degrees = 0.0, const godot::Vector2 &p_scale_top = godot::Vector2(1.0f, 1.0f), const godot::Ref<godot::Material> &p_material = nullptr);
+	static godot::Ref<ManifoldMesh> revolve_cross_section(const godot::Ref<CrossSection> &p_cross_section, int32_t p_circular_segments = 0, double p_revolve_degrees = 360.0, const godot::Ref<godot::Material> &p_material = nullptr);
+	godot::Ref<godot::NavigationMesh> to_navigation_mesh(double p_agent_height = 1.5, double p_agent_radius = 0.5, double p_max_slope = 45.0, const godot::AABB &p_region = godot::AABB()) const;
+
+	godot::Error export_to_file(const godot::String &p_path) const;
+	int64_t export_to_file_async(const godot::String &p_path) const;
 
 	uint64_t get_vertex_count() const;
 	uint64_t get_edge_count() const;
@@ -447,9 +542,12 @@ private:
 	void _ensure_manifold() const;
 	void _ensure_meshgl() const;
 	void _reallocate_original_ids();
+	void _apply_retention_policy() const;
 
 	void _commit_to_arrays() const;
-	void _unpack_to_arrays(uint32_t original_id, godot::PackedVector3Array &positions, godot::PackedVector3Array &normals, godot::PackedVector2Array &tex_uv, godot::PackedVector2Array &tex_uv2, godot::PackedColorArray &colors, godot::PackedColorArray &custom0, godot::PackedColorArray &custom1, godot::PackedColorArray &custom2, godot::PackedColorArray &custom3) const;
+	void _ensure_lods() const;
+	void _ensure_shadow() const;
+	void _unpack_to_arrays(const godot::LocalVector<uint32_t> &runs, godot::LocalVector<int32_t> &local_index, godot::LocalVector<uint32_t> &vertices, godot::PackedInt32Array &indices, godot::PackedVector3Array &positions, godot::PackedVector3Array &normals, godot::PackedVector2Array &tex_uv, godot::PackedVector2Array &tex_uv2, godot::PackedColorArray &colors, godot::PackedColorArray &custom0, godot::PackedColorArray &custom1, godot::PackedColorArray &custom2, godot::PackedColorArray &custom3) const;
 
 	void _init_normals(const godot::Array &arrays, I vertex, I stride);
 	void _init_tex_uv(const godot::Array &arrays, I vertex, I stride);
@@ -462,5 +560,17 @@ private:
 	godot::Ref<ManifoldMesh> _new_manifold(const manifold::Manifold &new_manifold) const;
 
 	godot::Ref<ManifoldMesh> _modify_color(const int32_t min_prop, const godot::Callable &p_modify) const;
-	godot::Ref<ManifoldMesh> _halfspace(const godot::Plane &p_plane, const godot::Ref<godot::Material> &p_material) const;
+	manifold::Manifold _halfspace(const godot::Plane &p_plane, uint32_t p_original_id) const;
+	godot::Ref<ManifoldMesh> _new_cut_manifold(const manifold::Manifold &new_manifold, const godot::Ref<godot::Material> &p_material) const;
+
+	std::vector<ExportSurface> _get_export_surfaces() const;
+
+	ManifoldCacheKey _get_content_hash() const;
+	godot::Ref<ManifoldMesh> _duplicate_result(const ManifoldCacheKey &p_key) const;
+	void _copy_settings(const ManifoldMesh *p_source);
+	void _store_pending_result() const;
+	void _save_cache_entry(const godot::Ref<godot::FileAccess> &p_file) const;
+	static godot::Ref<ManifoldMesh> _load_cache_entry(const godot::Ref<godot::FileAccess> &p_file);
+	static godot::Ref<ManifoldMesh> _cached_result(const ManifoldMesh *p_source, const std::function<void(ManifoldHasher &)> &p_key, const std::function<godot::Ref<ManifoldMesh>()> &p_compute);
 };
+VARIANT_ENUM_CAST(ManifoldMesh::RetentionPolicy);
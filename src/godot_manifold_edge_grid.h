@@ -0,0 +1,216 @@
+#pragma once
+
+#include <manifold/common.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// A uniform grid over a cross section's contour edges, for point queries that shouldn't look at
+// every edge. Each cell lists the edges whose bounds overlap it, and knows whether a reference point
+// inside it is in the cross section; a query then only needs to count the crossings between that
+// reference point and itself, which all fall in its cell. The contours of a cross section never
+// overlap, so the even-odd crossing count gives the answer for any fill rule.
+class EdgeGrid {
+	struct Edge {
+		manifold::vec2 a;
+		manifold::vec2 b;
+	};
+
+	std::vector<Edge> _edges;
+	manifold::vec2 _origin = manifold::vec2(0.0);
+	manifold::vec2 _cell_size = manifold::vec2(1.0);
+	int32_t _width = 0;
+	int32_t _height = 0;
+	std::vector<uint32_t> _cell_first;
+	std::vector<uint32_t> _cell_edges;
+	std::vector<uint8_t> _cell_inside;
+
+	// the reference point's place in its cell; deliberately not the middle, so it is unlikely to sit
+	// exactly on an axis-aligned edge
+	static constexpr double REFERENCE_X = 0.5137;
+	static constexpr double REFERENCE_Y = 0.4771;
+
+	static double _orient(const manifold::vec2 &p_a, const manifold::vec2 &p_b, const manifold::vec2 &p_c) {
+		return (p_b.x - p_a.x) * (p_c.y - p_a.y) - (p_b.y - p_a.y) * (p_c.x - p_a.x);
+	}
+
+	// Vertices on the line through p_from and p_to count as being on one side of it, so a path through
+	// a vertex crosses either both of its edges or neither.
+	static bool _crosses(const Edge &p_edge, const manifold::vec2 &p_from, const manifold::vec2 &p_to) {
+		if ((_orient(p_from, p_to, p_edge.a) > 0.0) == (_orient(p_from, p_to, p_edge.b) > 0.0)) {
+			return false;
+		}
+		return (_orient(p_edge.a, p_edge.b, p_from) > 0.0) != (_orient(p_edge.a, p_edge.b, p_to) > 0.0);
+	}
+
+	static double _distance_squared(const Edge &p_edge, const manifold::vec2 &p_point) {
+		const manifold::vec2 edge = p_edge.b - p_edge.a;
+		const double length_squared = manifold::la::dot(edge, edge);
+		const double t = length_squared > 0.0 ? std::clamp(manifold::la::dot(p_point - p_edge.a, edge) / length_squared, 0.0, 1.0) : 0.0;
+		const manifold::vec2 offset = p_edge.a + edge * t - p_point;
+		return manifold::la::dot(offset, offset);
+	}
+
+	int32_t _column(double p_x) const {
+		return std::clamp(int32_t(std::floor((p_x - _origin.x) / _cell_size.x)), 0, _width - 1);
+	}
+	int32_t _row(double p_y) const {
+		return std::clamp(int32_t(std::floor((p_y - _origin.y) / _cell_size.y)), 0, _height - 1);
+	}
+	manifold::vec2 _reference(int32_t p_column, int32_t p_row) const {
+		return _origin + manifold::vec2((p_column + REFERENCE_X) * _cell_size.x, (p_row + REFERENCE_Y) * _cell_size.y);
+	}
+
+public:
+	void build(const manifold::Polygons &p_polygons) {
+		_edges.clear();
+		manifold::vec2 min(std::numeric_limits<double>::infinity());
+		manifold::vec2 max(-std::numeric_limits<double>::infinity());
+		for (const manifold::SimplePolygon &polygon : p_polygons) {
+			for (size_t i = 0; i < polygon.size(); i++) {
+				_edges.push_back({ polygon[i], polygon[(i + 1) % polygon.size()] });
+				min = manifold::la::min(min, polygon[i]);
+				max = manifold::la::max(max, polygon[i]);
+			}
+		}
+		if (_edges.empty()) {
+			_width = 0;
+			_height = 0;
+			return;
+		}
+
+		// about one edge per cell, with square-ish cells
+		const manifold::vec2 size = manifold::la::max(max - min, manifold::vec2(1e-9));
+		const double cells = double(_edges.size());
+		_width = std::clamp(int32_t(std::ceil(std::sqrt(cells * size.x / size.y))), 1, 1024);
+		_height = std::clamp(int32_t(std::ceil(cells / _width)), 1, 1024);
+		_origin = min;
+		_cell_size = size / manifold::vec2(_width, _height);
+
+		const size_t cell_count = size_t(_width) * _height;
+		_cell_first.assign(cell_count + 1, 0);
+		const auto for_each_cell = [&](const Edge &p_edge, auto p_function) {
+			const int32_t first_column = _column(std::min(p_edge.a.x, p_edge.b.x));
+			const int32_t last_column = _column(std::max(p_edge.a.x, p_edge.b.x));
+			const int32_t first_row = _row(std::min(p_edge.a.y, p_edge.b.y));
+			const int32_t last_row = _row(std::max(p_edge.a.y, p_edge.b.y));
+			for (int32_t row = first_row; row <= last_row; row++) {
+				for (int32_t column = first_column; column <= last_column; column++) {
+					p_function(size_t(row) * _width + column);
+				}
+			}
+		};
+		for (const Edge &edge : _edges) {
+			for_each_cell(edge, [&](size_t p_cell) { _cell_first[p_cell + 1]++; });
+		}
+		for (size_t cell = 0; cell < cell_count; cell++) {
+			_cell_first[cell + 1] += _cell_first[cell];
+		}
+		_cell_edges.resize(_cell_first[cell_count]);
+		{
+			std::vector<uint32_t> filled(_cell_first.begin(), _cell_first.end() - 1);
+			for (size_t i = 0; i < _edges.size(); i++) {
+				for_each_cell(_edges[i], [&](size_t p_cell) { _cell_edges[filled[p_cell]++] = uint32_t(i); });
+			}
+		}
+
+		// walk each row from the left: the first reference point is outside everything once its ray
+		// leaves the grid, and every next one differs by the crossings between the two, which all lie in
+		// those two cells (an edge in both is only counted once)
+		_cell_inside.assign(cell_count, 0);
+		std::vector<uint32_t> seen(_edges.size(), 0);
+		uint32_t stamp = 0;
+		for (int32_t row = 0; row < _height; row++) {
+			const manifold::vec2 first = _reference(0, row);
+			bool inside = false;
+			for (uint32_t i = _cell_first[size_t(row) * _width]; i < _cell_first[size_t(row) * _width + 1]; i++) {
+				inside ^= _crosses(_edges[_cell_edges[i]], first, manifold::vec2(_origin.x - _cell_size.x, first.y));
+			}
+			_cell_inside[size_t(row) * _width] = inside;
+
+			for (int32_t column = 1; column < _width; column++) {
+				const manifold::vec2 from = _reference(column - 1, row);
+				const manifold::vec2 to = _reference(column, row);
+				stamp++;
+				for (size_t cell = size_t(row) * _width + column - 1; cell <= size_t(row) * _width + column; cell++) {
+					for (uint32_t i = _cell_first[cell]; i < _cell_first[cell + 1]; i++) {
+						if (seen[_cell_edges[i]] != stamp) {
+							seen[_cell_edges[i]] = stamp;
+							inside ^= _crosses(_edges[_cell_edges[i]], from, to);
+						}
+					}
+				}
+				_cell_inside[size_t(row) * _width + column] = inside;
+			}
+		}
+	}
+
+	bool is_empty() const {
+		return _edges.empty();
+	}
+
+	bool contains(const manifold::vec2 &p_point) const {
+		if (_edges.empty() || p_point.x < _origin.x || p_point.y < _origin.y || p_point.x > _origin.x + _cell_size.x * _width || p_point.y > _origin.y + _cell_size.y * _height) {
+			return false;
+		}
+		const int32_t column = _column(p_point.x);
+		const int32_t row = _row(p_point.y);
+		const size_t cell = size_t(row) * _width + column;
+		const manifold::vec2 reference = _reference(column, row);
+		bool inside = _cell_inside[cell];
+		for (uint32_t i = _cell_first[cell]; i < _cell_first[cell + 1]; i++) {
+			inside ^= _crosses(_edges[_cell_edges[i]], reference, p_point);
+		}
+		return inside;
+	}
+
+	// Distance to the nearest edge, searching outwards from the point's cell one ring of cells at a
+	// time until no unsearched cell can be closer.
+	double distance(const manifold::vec2 &p_point) const {
+		double best = std::numeric_limits<double>::infinity();
+		if (_edges.empty()) {
+			return best;
+		}
+
+		const int32_t column = _column(p_point.x);
+		const int32_t row = _row(p_point.y);
+		for (int32_t ring = 0;; ring++) {
+			const int32_t first_column = column - ring;
+			const int32_t last_column = column + ring;
+			const int32_t first_row = row - ring;
+			const int32_t last_row = row + ring;
+			for (int32_t r = std::max(first_row, 0); r <= std::min(last_row, _height - 1); r++) {
+				for (int32_t c = std::max(first_column, 0); c <= std::min(last_column, _width - 1); c++) {
+					if (r != first_row && r != last_row && c != first_column && c != last_column) {
+						continue;
+					}
+					const size_t cell = size_t(r) * _width + c;
+					for (uint32_t i = _cell_first[cell]; i < _cell_first[cell + 1]; i++) {
+						best = std::min(best, _distance_squared(_edges[_cell_edges[i]], p_point));
+					}
+				}
+			}
+
+			// the nearest any cell outside the searched block can be
+			double bound = std::numeric_limits<double>::infinity();
+			if (first_column > 0) {
+				bound = std::min(bound, p_point.x - (_origin.x + first_column * _cell_size.x));
+			}
+			if (last_column < _width - 1) {
+				bound = std::min(bound, _origin.x + (last_column + 1) * _cell_size.x - p_point.x);
+			}
+			if (first_row > 0) {
+				bound = std::min(bound, p_point.y - (_origin.y + first_row * _cell_size.y));
+			}
+			if (last_row < _height - 1) {
+				bound = std::min(bound, _origin.y + (last_row + 1) * _cell_size.y - p_point.y);
+			}
+			if (std::isinf(bound) || (bound > 0.0 && bound * bound >= best)) {
+				return std::sqrt(best);
+			}
+		}
+	}
+};
@@ -0,0 +1,75 @@
+#ifdef TOOLS_ENABLED
+
+#include "godot_manifold_editor.h"
+#include "godot_manifold_defs.h"
+
+#include <godot_cpp/classes/resource_saver.hpp>
+
+using namespace godot;
+
+String ManifoldMeshImportPlugin::_get_importer_name() const {
+	return "manifold.mesh";
+}
+String ManifoldMeshImportPlugin::_get_visible_name() const {
+	return "ManifoldMesh";
+}
+PackedStringArray ManifoldMeshImportPlugin::_get_recognized_extensions() const {
+	PackedStringArray extensions;
+	extensions.append("stl");
+	extensions.append("obj");
+	extensions.append("3mf");
+	return extensions;
+}
+String ManifoldMeshImportPlugin::_get_save_extension() const {
+	return "res";
+}
+String ManifoldMeshImportPlugin::_get_resource_type() const {
+	return "ManifoldMesh";
+}
+double ManifoldMeshImportPlugin::_get_priority() const {
+	// stay behind Godot's own OBJ importer unless the user picks this one
+	return 0.5;
+}
+int32_t ManifoldMeshImportPlugin::_get_import_order() const {
+	return 0;
+}
+int32_t ManifoldMeshImportPlugin::_get_preset_count() const {
+	return 1;
+}
+String ManifoldMeshImportPlugin::_get_preset_name(int32_t p_preset_index) const {
+	return "Default";
+}
+TypedArray<Dictionary> ManifoldMeshImportPlugin::_get_import_options(const String &p_path, int32_t p_preset_index) const {
+	Dictionary weld_tolerance;
+	weld_tolerance["name"] = "weld_tolerance";
+	weld_tolerance["default_value"] = 0.0;
+	weld_tolerance["property_hint"] = PROPERTY_HINT_RANGE;
+	weld_tolerance["hint_string"] = "0,1,0.0001,or_greater,suffix:m";
+
+	TypedArray<Dictionary> options;
+	options.append(weld_tolerance);
+	return options;
+}
+bool ManifoldMeshImportPlugin::_get_option_visibility(const String &p_path, const StringName &p_option_name, const Dictionary &p_options) const {
+	return true;
+}
+bool ManifoldMeshImportPlugin::_can_import_threaded() const {
+	return true;
+}
+godot::Error ManifoldMeshImportPlugin::_import(const String &p_source_file, const String &p_save_path, const Dictionary &p_options, const TypedArray<String> &p_platform_variants, const TypedArray<String> &p_gen_files) const {
+	const Ref<ManifoldMesh> mesh = ManifoldMesh::import_from_file(p_source_file, p_options.get("weld_tolerance", 0.0));
+	ERR_FAIL_COND_V(mesh.is_null(), ERR_FILE_CORRUPT);
+
+	return ResourceSaver::get_singleton()->save(mesh, p_save_path + "." + _get_save_extension());
+}
+
+void ManifoldEditorPlugin::_enter_tree() {
+	_import_plugin.instantiate();
+	add_import_plugin(_import_plugin);
+}
+void ManifoldEditorPlugin::_exit_tree() {
+	remove_import_plugin(_import_plugin);
+	_import_plugin.unref();
+}
+
+#endif // TOOLS_ENABLED
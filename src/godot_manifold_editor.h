@@ -0,0 +1,43 @@
+#pragma once
+
+#ifdef TOOLS_ENABLED
+
+#include <godot_cpp/classes/editor_import_plugin.hpp>
+#include <godot_cpp/classes/editor_plugin.hpp>
+
+class ManifoldMeshImportPlugin : public godot::EditorImportPlugin {
+	GDCLASS(ManifoldMeshImportPlugin, godot::EditorImportPlugin);
+
+protected:
+	static void _bind_methods() {}
+
+public:
+	godot::String _get_importer_name() const override;
+	godot::String _get_visible_name() const override;
+	godot::PackedStringArray _get_recognized_extensions() const override;
+	godot::String _get_save_extension() const override;
+	godot::String _get_resource_type() const override;
+	double _get_priority() const override;
+	int32_t _get_import_order() const override;
+	int32_t _get_preset_count() const override;
+	godot::String _get_preset_name(int32_t p_preset_index) const override;
+	godot::TypedArray<godot::Dictionary> _get_import_options(const godot::String &p_path, int32_t p_preset_index) const override;
+	bool _get_option_visibility(const godot::String &p_path, const godot::StringName &p_option_name, const godot::Dictionary &p_options) const override;
+	bool _can_import_threaded() const override;
+	godot::Error _import(const godot::String &p_source_file, const godot::String &p_save_path, const godot::Dictionary &p_options, const godot::TypedArray<godot::String> &p_platform_variants, const godot::TypedArray<godot::String> &p_gen_files) const override;
+};
+
+class ManifoldEditorPlugin : public godot::EditorPlugin {
+	GDCLASS(ManifoldEditorPlugin, godot::EditorPlugin);
+
+	godot::Ref<ManifoldMeshImportPlugin> _import_plugin;
+
+protected:
+	static void _bind_methods() {}
+
+public:
+	void _enter_tree() override;
+	void _exit_tree() override;
+};
+
+#endif // TOOLS_ENABLED
@@ -0,0 +1,574 @@
+#pragma once
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/classes/zip_packer.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/callable_custom.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <manifold/manifold.h>
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+struct ExportSurface {
+	uint32_t original_id;
+	godot::String name;
+};
+
+// Collects serialized output in a fixed-size buffer and hands it to the sink whenever it fills up,
+// so an export never holds more than one chunk of encoded data in memory.
+class ExportBuffer {
+public:
+	using Sink = std::function<godot::Error(const godot::PackedByteArray &)>;
+	static constexpr int64_t CAPACITY = 1 << 20;
+
+private:
+	Sink _sink;
+	godot::PackedByteArray _buffer;
+	int64_t _used = 0;
+	godot::Error _error = godot::OK;
+
+public:
+	ExportBuffer(const Sink &p_sink) :
+			_sink(p_sink) {
+		_buffer.resize(CAPACITY);
+	}
+
+	void write(const void *p_data, size_t p_size) {
+		const uint8_t *data = static_cast<const uint8_t *>(p_data);
+		while (p_size > 0) {
+			const int64_t chunk = std::min(int64_t(p_size), CAPACITY - _used);
+			memcpy(_buffer.ptrw() + _used, data, chunk);
+			_used += chunk;
+			data += chunk;
+			p_size -= chunk;
+			if (_used == CAPACITY) {
+				flush();
+			}
+		}
+	}
+	void write_u16(uint16_t p_value) {
+		write(&p_value, sizeof(p_value));
+	}
+	void write_u32(uint32_t p_value) {
+		write(&p_value, sizeof(p_value));
+	}
+	void write_f32(float p_value) {
+		write(&p_value, sizeof(p_value));
+	}
+	void write_string(const char *p_string) {
+		write(p_string, strlen(p_string));
+	}
+	void write_string(const godot::String &p_string) {
+		const godot::CharString utf8 = p_string.utf8();
+		write(utf8.get_data(), utf8.length());
+	}
+	// a formatting failure fails the whole export, since going on would write a corrupt file
+	void print(const char *p_format, ...) {
+		char line[256];
+		va_list args, retry;
+		va_start(args, p_format);
+		va_copy(retry, args);
+		const int length = vsnprintf(line, sizeof(line), p_format, args);
+		va_end(args);
+		if (likely(length >= 0 && length < int(sizeof(line)))) {
+			write(line, length);
+		} else if (length >= 0) {
+			std::vector<char> long_line(size_t(length) + 1);
+			vsnprintf(long_line.data(), long_line.size(), p_format, retry);
+			write(long_line.data(), length);
+		} else {
+			_error = godot::ERR_INVALID_DATA;
+			ERR_PRINT(vformat("Cannot format \"%s\" for export", p_format));
+		}
+		va_end(retry);
+	}
+
+	godot::Error flush() {
+		if (_used == 0 || _error != godot::OK) {
+			_used = 0;
+			return _error;
+		}
+		_error = _used == CAPACITY ? _sink(_buffer) : _sink(_buffer.slice(0, _used));
+		_used = 0;
+		return _error;
+	}
+};
+
+template <typename Precision, typename I>
+static _FORCE_INLINE_ manifold::vec3 export_position(const manifold::MeshGLP<Precision, I> &p_mesh, size_t p_vert) {
+	const Precision *vert = &p_mesh.vertProperties[p_vert * p_mesh.numProp];
+	return { double(vert[0]), double(vert[1]), double(vert[2]) };
+}
+
+// Calls p_func(first_index, last_index) for each run that belongs to p_original_id, or for every run if
+// there is no surface list (plain Manifold exports).
+template <typename Precision, typename I, typename F>
+static void export_for_each_run(const manifold::MeshGLP<Precision, I> &p_mesh, const ExportSurface *p_surface, F p_func) {
+	if (p_mesh.runIndex.size() < 2) {
+		if (!p_surface || p_mesh.runOriginalID.empty() || p_mesh.runOriginalID[0] == p_surface->original_id) {
+			p_func(size_t(0), p_mesh.triVerts.size());
+		}
+		return;
+	}
+	for (size_t run = 0; run + 1 < p_mesh.runIndex.size(); run++) {
+		if (p_surface && p_mesh.runOriginalID[run] != p_surface->original_id) {
+			continue;
+		}
+		p_func(size_t(p_mesh.runIndex[run]), size_t(p_mesh.runIndex[run + 1]));
+	}
+}
+
+template <typename Precision, typename I>
+godot::Error export_stl(ExportBuffer &p_out, const manifold::MeshGLP<Precision, I> &p_mesh) {
+	char header[80] = {};
+	snprintf(header, sizeof(header), "binary STL exported by godot4-manifold");
+	p_out.write(header, sizeof(header));
+	p_out.write_u32(uint32_t(p_mesh.NumTri()));
+
+	for (size_t tri = 0; tri < p_mesh.NumTri(); tri++) {
+		const manifold::vec3 a = export_position(p_mesh, p_mesh.triVerts[tri * 3 + 0]);
+		const manifold::vec3 b = export_position(p_mesh, p_mesh.triVerts[tri * 3 + 1]);
+		const manifold::vec3 c = export_position(p_mesh, p_mesh.triVerts[tri * 3 + 2]);
+		const manifold::vec3 cross = manifold::la::cross(b - a, c - a);
+		const double length = manifold::la::length(cross);
+		const manifold::vec3 normal = length > 0.0 ? cross / length : manifold::vec3(0.0);
+
+		for (const manifold::vec3 &v : { normal, a, b, c }) {
+			p_out.write_f32(float(v.x));
+			p_out.write_f32(float(v.y));
+			p_out.write_f32(float(v.z));
+		}
+		p_out.write_u16(0);
+	}
+
+	return p_out.flush();
+}
+
+template <typename Precision, typename I>
+static std::vector<uint32_t> export_canonical_vertices(const manifold::MeshGLP<Precision, I> &p_mesh, uint32_t &r_count) {
+	// shared positions are written once; a merged vertex may stand in for its canonical vertex if it
+	// comes first, since both have the same position
+	std::vector<uint32_t> canonical(p_mesh.NumVert());
+	std::iota(canonical.begin(), canonical.end(), 0);
+	for (size_t i = 0; i < p_mesh.mergeFromVert.size(); i++) {
+		canonical[p_mesh.mergeFromVert[i]] = p_mesh.mergeToVert[i];
+	}
+
+	std::vector<uint32_t> index(canonical.size());
+	r_count = 0;
+	for (size_t vert = 0; vert < canonical.size(); vert++) {
+		if (canonical[vert] == vert) {
+			index[vert] = r_count++;
+		}
+	}
+	for (size_t vert = 0; vert < canonical.size(); vert++) {
+		index[vert] = index[canonical[vert]];
+	}
+	return index;
+}
+
+template <typename Precision, typename I>
+godot::Error export_obj(ExportBuffer &p_out, const manifold::MeshGLP<Precision, I> &p_mesh, const std::vector<ExportSurface> &p_surfaces, bool p_has_attributes) {
+	const size_t num_prop = p_mesh.numProp;
+	const bool has_normal = p_has_attributes && num_prop >= 6;
+	const bool has_uv = p_has_attributes && num_prop >= 8;
+
+	uint32_t num_positions;
+	const std::vector<uint32_t> position_index = export_canonical_vertices(p_mesh, num_positions);
+
+	p_out.write_string("# exported by godot4-manifold\n");
+	for (size_t vert = 0, next = 0; vert < p_mesh.NumVert(); vert++) {
+		if (position_index[vert] != next) {
+			continue;
+		}
+		const manifold::vec3 position = export_position(p_mesh, vert);
+		p_out.print("v %.9g %.9g %.9g\n", position.x, position.y, position.z);
+		next++;
+	}
+	if (has_uv) {
+		for (size_t vert = 0; vert < p_mesh.NumVert(); vert++) {
+			// OBJ puts the UV origin at the bottom left
+			p_out.print("vt %.9g %.9g\n", double(p_mesh.vertProperties[vert * num_prop + 6]), 1.0 - double(p_mesh.vertProperties[vert * num_prop + 7]));
+		}
+	}
+	if (has_normal) {
+		for (size_t vert = 0; vert < p_mesh.NumVert(); vert++) {
+			p_out.print("vn %.9g %.9g %.9g\n", double(p_mesh.vertProperties[vert * num_prop + 3]), double(p_mesh.vertProperties[vert * num_prop + 4]), double(p_mesh.vertProperties[vert * num_prop + 5]));
+		}
+	}
+
+	const auto write_faces = [&](size_t p_first, size_t p_last) {
+		for (size_t i = p_first; i < p_last; i += 3) {
+			p_out.write_string("f");
+			for (size_t j = i; j < i + 3; j++) {
+				const size_t vert = p_mesh.triVerts[j];
+				const uint32_t position = position_index[vert] + 1;
+				if (has_uv && has_normal) {
+					p_out.print(" %u/%zu/%zu", position, vert + 1, vert + 1);
+				} else if (has_normal) {
+					p_out.print(" %u//%zu", position, vert + 1);
+				} else {
+					p_out.print(" %u", position);
+				}
+			}
+			p_out.write_string("\n");
+		}
+	};
+
+	if (p_surfaces.empty()) {
+		export_for_each_run(p_mesh, nullptr, write_faces);
+	}
+	for (const ExportSurface &surface : p_surfaces) {
+		p_out.write_string("usemtl ");
+		p_out.write_string(surface.name.replace(" ", "_"));
+		p_out.write_string("\n");
+		export_for_each_run(p_mesh, &surface, write_faces);
+	}
+
+	return p_out.flush();
+}
+
+static inline godot::Error export_zip_text(const godot::Ref<godot::ZIPPacker> &p_zip, const godot::String &p_path, const char *p_text) {
+	godot::Error err = p_zip->start_file(p_path);
+	ERR_FAIL_COND_V(err != godot::OK, err);
+	err = p_zip->write_file(godot::String::utf8(p_text).to_utf8_buffer());
+	ERR_FAIL_COND_V(err != godot::OK, err);
+	return p_zip->close_file();
+}
+
+template <typename Precision, typename I>
+godot::Error export_3mf(const godot::String &p_path, const manifold::MeshGLP<Precision, I> &p_mesh, const std::vector<ExportSurface> &p_surfaces) {
+	godot::Ref<godot::ZIPPacker> zip;
+	zip.instantiate();
+	godot::Error err = zip->open(p_path);
+	ERR_FAIL_COND_V_MSG(err != godot::OK, err, vformat("Cannot open %s for writing", p_path));
+
+	err = export_zip_text(zip, "[Content_Types].xml", R"(<?xml version="1.0" encoding="UTF-8"?>
+<Types xmlns="http://schemas.openxmlformats.org/package/2006/content-types"><Default Extension="rels" ContentType="application/vnd.openxmlformats-package.relationships+xml"/><Default Extension="model" ContentType="application/vnd.ms-package.3dmanufacturing-3dmodel+xml"/></Types>
+)");
+	ERR_FAIL_COND_V(err != godot::OK, err);
+	err = export_zip_text(zip, "_rels/.rels", R"(<?xml version="1.0" encoding="UTF-8"?>
+<Relationships xmlns="http://schemas.openxmlformats.org/package/2006/relationships"><Relationship Target="/3D/3dmodel.model" Id="rel0" Type="http://schemas.microsoft.com/3dmanufacturing/2013/01/3dmodel"/></Relationships>
+)");
+	ERR_FAIL_COND_V(err != godot::OK, err);
+
+	err = zip->start_file("3D/3dmodel.model");
+	ERR_FAIL_COND_V(err != godot::OK, err);
+
+	ExportBuffer out([zip](const godot::PackedByteArray &p_data) -> godot::Error {
+		return zip->write_file(p_data);
+	});
+
+	uint32_t num_positions;
+	const std::vector<uint32_t> position_index = export_canonical_vertices(p_mesh, num_positions);
+
+	out.write_string("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<model unit=\"meter\" xml:lang=\"en-US\" xmlns=\"http://schemas.microsoft.com/3dmanufacturing/core/2015/02\">\n<resources>\n");
+	if (!p_surfaces.empty()) {
+		out.write_string("<basematerials id=\"1\">\n");
+		for (const ExportSurface &surface : p_surfaces) {
+			out.write_string("<base name=\"");
+			out.write_string(surface.name.xml_escape(true));
+			out.write_string("\" displaycolor=\"#FFFFFFFF\"/>\n");
+		}
+		out.write_string("</basematerials>\n");
+	}
+	out.write_string("<object id=\"2\" type=\"model\">\n<mesh>\n<vertices>\n");
+	for (size_t vert = 0, next = 0; vert < p_mesh.NumVert(); vert++) {
+		if (position_index[vert] != next) {
+			continue;
+		}
+		const manifold::vec3 position = export_position(p_mesh, vert);
+		out.print("<vertex x=\"%.9g\" y=\"%.9g\" z=\"%.9g\"/>\n", position.x, position.y, position.z);
+		next++;
+	}
+	out.write_string("</vertices>\n<triangles>\n");
+
+	const auto write_triangles = [&](size_t p_first, size_t p_last, int64_t p_material) {
+		for (size_t i = p_first; i < p_last; i += 3) {
+			const uint32_t v1 = position_index[p_mesh.triVerts[i + 0]];
+			const uint32_t v2 = position_index[p_mesh.triVerts[i + 1]];
+			const uint32_t v3 = position_index[p_mesh.triVerts[i + 2]];
+			if (p_material >= 0) {
+				out.print("<triangle v1=\"%u\" v2=\"%u\" v3=\"%u\" pid=\"1\" p1=\"%d\"/>\n", v1, v2, v3, int(p_material));
+			} else {
+				out.print("<triangle v1=\"%u\" v2=\"%u\" v3=\"%u\"/>\n", v1, v2, v3);
+			}
+		}
+	};
+	if (p_surfaces.empty()) {
+		export_for_each_run(p_mesh, nullptr, [&](size_t p_first, size_t p_last) {
+			write_triangles(p_first, p_last, -1);
+		});
+	}
+	for (size_t i = 0; i < p_surfaces.size(); i++) {
+		export_for_each_run(p_mesh, &p_surfaces[i], [&](size_t p_first, size_t p_last) {
+			write_triangles(p_first, p_last, i);
+		});
+	}
+	out.write_string("</triangles>\n</mesh>\n</object>\n</resources>\n<build>\n<item objectid=\"2\"/>\n</build>\n</model>\n");
+
+	err = out.flush();
+	ERR_FAIL_COND_V(err != godot::OK, err);
+	err = zip->close_file();
+	ERR_FAIL_COND_V(err != godot::OK, err);
+	return zip->close();
+}
+
+template <typename Precision, typename I>
+godot::Error export_glb(ExportBuffer &p_out, const manifold::MeshGLP<Precision, I> &p_mesh, const std::vector<ExportSurface> &p_surfaces, bool p_has_attributes) {
+	constexpr int64_t GL_ARRAY_BUFFER = 34962;
+	constexpr int64_t GL_ELEMENT_ARRAY_BUFFER = 34963;
+	constexpr int64_t GL_UNSIGNED_INT = 5125;
+	constexpr int64_t GL_FLOAT = 5126;
+
+	const size_t num_vert = p_mesh.NumVert();
+	const size_t num_prop = p_mesh.numProp;
+	const bool has_normal = p_has_attributes && num_prop >= 6;
+	const bool has_uv = p_has_attributes && num_prop >= 8;
+
+	manifold::vec3 min(std::numeric_limits<double>::infinity()), max(-std::numeric_limits<double>::infinity());
+	for (size_t vert = 0; vert < num_vert; vert++) {
+		const manifold::vec3 position = export_position(p_mesh, vert);
+		min = manifold::la::min(min, position);
+		max = manifold::la::max(max, position);
+	}
+
+	// every primitive shares the vertex attributes and only gets its own index buffer
+	std::vector<const ExportSurface *> surfaces;
+	std::vector<size_t> index_counts;
+	if (p_surfaces.empty()) {
+		surfaces.push_back(nullptr);
+	}
+	for (const ExportSurface &surface : p_surfaces) {
+		surfaces.push_back(&surface);
+	}
+	for (const ExportSurface *surface : surfaces) {
+		size_t count = 0;
+		export_for_each_run(p_mesh, surface, [&count](size_t p_first, size_t p_last) {
+			count += p_last - p_first;
+		});
+		index_counts.push_back(count);
+	}
+
+	godot::Array buffer_views, accessors, materials, primitives;
+	uint64_t offset = 0;
+	const auto add_view = [&](uint64_t p_length, int64_t p_target) -> int64_t {
+		godot::Dictionary view;
+		view["buffer"] = 0;
+		view["byteOffset"] = offset;
+		view["byteLength"] = p_length;
+		view["target"] = p_target;
+		buffer_views.push_back(view);
+		offset += p_length;
+		return buffer_views.size() - 1;
+	};
+	const auto add_accessor = [&](int64_t p_view, int64_t p_component_type, uint64_t p_count, const char *p_type) -> godot::Dictionary {
+		godot::Dictionary accessor;
+		accessor["bufferView"] = p_view;
+		accessor["componentType"] = p_component_type;
+		accessor["count"] = p_count;
+		accessor["type"] = p_type;
+		return accessor;
+	};
+
+	godot::Dictionary attributes;
+	godot::Dictionary position_accessor = add_accessor(add_view(num_vert * 12, GL_ARRAY_BUFFER), GL_FLOAT, num_vert, "VEC3");
+	position_accessor["min"] = godot::Array::make(min.x, min.y, min.z);
+	position_accessor["max"] = godot::Array::make(max.x, max.y, max.z);
+	attributes["POSITION"] = accessors.size();
+	accessors.push_back(position_accessor);
+	if (has_normal) {
+		attributes["NORMAL"] = accessors.size();
+		accessors.push_back(add_accessor(add_view(num_vert * 12, GL_ARRAY_BUFFER), GL_FLOAT, num_vert, "VEC3"));
+	}
+	if (has_uv) {
+		attributes["TEXCOORD_0"] = accessors.size();
+		accessors.push_back(add_accessor(add_view(num_vert * 8, GL_ARRAY_BUFFER), GL_FLOAT, num_vert, "VEC2"));
+	}
+	for (size_t i = 0; i < surfaces.size(); i++) {
+		if (index_counts[i] == 0) {
+			continue;
+		}
+
+		godot::Dictionary primitive;
+		primitive["attributes"] = attributes;
+		primitive["indices"] = accessors.size();
+		primitive["mode"] = 4;
+		accessors.push_back(add_accessor(add_view(index_counts[i] * 4, GL_ELEMENT_ARRAY_BUFFER), GL_UNSIGNED_INT, index_counts[i], "SCALAR"));
+
+		if (surfaces[i]) {
+			godot::Dictionary material;
+			material["name"] = surfaces[i]->name;
+			primitive["material"] = materials.size();
+			materials.push_back(material);
+		}
+
+		primitives.push_back(primitive);
+	}
+	ERR_FAIL_COND_V_MSG(primitives.is_empty(), godot::ERR_INVALID_DATA, "No surface has any triangles to export");
+
+	godot::Dictionary asset, scene, node, mesh, buffer, gltf;
+	asset["version"] = "2.0";
+	asset["generator"] = "godot4-manifold";
+	node["mesh"] = 0;
+	scene["nodes"] = godot::Array::make(0);
+	mesh["primitives"] = primitives;
+	buffer["byteLength"] = offset;
+	gltf["asset"] = asset;
+	gltf["scene"] = 0;
+	gltf["scenes"] = godot::Array::make(scene);
+	gltf["nodes"] = godot::Array::make(node);
+	gltf["meshes"] = godot::Array::make(mesh);
+	if (!materials.is_empty()) {
+		gltf["materials"] = materials;
+	}
+	gltf["buffers"] = godot::Array::make(buffer);
+	gltf["bufferViews"] = buffer_views;
+	gltf["accessors"] = accessors;
+
+	godot::PackedByteArray json = godot::JSON::stringify(gltf, "", false).to_utf8_buffer();
+	while (json.size() % 4 != 0) {
+		json.push_back(' ');
+	}
+
+	p_out.write_u32(0x46546C67); // glTF
+	p_out.write_u32(2);
+	p_out.write_u32(uint32_t(12 + 8 + json.size() + 8 + offset));
+	p_out.write_u32(uint32_t(json.size()));
+	p_out.write_u32(0x4E4F534A); // JSON
+	p_out.write(json.ptr(), json.size());
+	p_out.write_u32(uint32_t(offset));
+	p_out.write_u32(0x004E4942); // BIN
+
+	for (size_t vert = 0; vert < num_vert; vert++) {
+		for (size_t i = 0; i < 3; i++) {
+			p_out.write_f32(float(p_mesh.vertProperties[vert * num_prop + i]));
+		}
+	}
+	if (has_normal) {
+		for (size_t vert = 0; vert < num_vert; vert++) {
+			for (size_t i = 3; i < 6; i++) {
+				p_out.write_f32(float(p_mesh.vertProperties[vert * num_prop + i]));
+			}
+		}
+	}
+	if (has_uv) {
+		for (size_t vert = 0; vert < num_vert; vert++) {
+			for (size_t i = 6; i < 8; i++) {
+				p_out.write_f32(float(p_mesh.vertProperties[vert * num_prop + i]));
+			}
+		}
+	}
+	for (const ExportSurface *surface : surfaces) {
+		export_for_each_run(p_mesh, surface, [&](size_t p_first, size_t p_last) {
+			for (size_t i = p_first; i < p_last; i++) {
+				p_out.write_u32(uint32_t(p_mesh.triVerts[i]));
+			}
+		});
+	}
+
+	return p_out.flush();
+}
+
+// Writes p_mesh to p_path in the format given by its extension (stl, obj, 3mf or glb). Nothing is
+// de-indexed or copied up front; everything streams out of the MeshGL through bounded buffers.
+// p_has_attributes says the properties after the position are laid out like ManifoldMesh's
+// (normal, then UV), so they can be written as normals and texture coordinates.
+template <typename Precision, typename I>
+godot::Error export_mesh(const godot::String &p_path, const manifold::MeshGLP<Precision, I> &p_mesh, const std::vector<ExportSurface> &p_surfaces, bool p_has_attributes) {
+	ERR_FAIL_COND_V_MSG(p_mesh.NumTri() == 0, godot::ERR_INVALID_DATA, "Cannot export an empty mesh");
+	ERR_FAIL_COND_V_MSG(p_mesh.numProp < 3, godot::ERR_INVALID_DATA, "Cannot export a mesh without positions");
+
+	const godot::String extension = p_path.get_extension().to_lower();
+	if (extension == "3mf") {
+		return export_3mf(p_path, p_mesh, p_surfaces);
+	}
+	ERR_FAIL_COND_V_MSG(extension != "stl" && extension != "obj" && extension != "glb", godot::ERR_FILE_UNRECOGNIZED, vformat("Cannot export %s: supported extensions are stl, obj, 3mf and glb", p_path));
+
+	const godot::Ref<godot::FileAccess> file = godot::FileAccess::open(p_path, godot::FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), godot::FileAccess::get_open_error(), vformat("Cannot open %s for writing", p_path));
+
+	ExportBuffer out([file](const godot::PackedByteArray &p_data) -> godot::Error {
+		file->store_buffer(p_data);
+		return file->get_error();
+	});
+
+	if (extension == "stl") {
+		return export_stl(out, p_mesh);
+	}
+	if (extension == "obj") {
+		return export_obj(out, p_mesh, p_surfaces, p_has_attributes);
+	}
+	return export_glb(out, p_mesh, p_surfaces, p_has_attributes);
+}
+
+// A WorkerThreadPool task that exports a MeshGL it holds a reference to, so the export never reads
+// a mesh that the main thread may rebuild or drop while it runs. When done, the object's
+// export_finished signal is emitted on the main thread with the path and the error.
+template <typename Precision, typename I>
+class ExportMeshCallable : public godot::CallableCustom {
+	std::shared_ptr<const manifold::MeshGLP<Precision, I>> _mesh;
+	std::vector<ExportSurface> _surfaces;
+	bool _has_attributes;
+	godot::String _path;
+	godot::Callable _emit_signal;
+
+	static bool _compare_equal(const godot::CallableCustom *p_a, const godot::CallableCustom *p_b) {
+		return p_a == p_b;
+	}
+	static bool _compare_less(const godot::CallableCustom *p_a, const godot::CallableCustom *p_b) {
+		return p_a < p_b;
+	}
+
+public:
+	ExportMeshCallable(std::shared_ptr<const manifold::MeshGLP<Precision, I>> p_mesh, std::vector<ExportSurface> p_surfaces, bool p_has_attributes, const godot::String &p_path, godot::Object *p_object) :
+			_mesh(std::move(p_mesh)), _surfaces(std::move(p_surfaces)), _has_attributes(p_has_attributes), _path(p_path), _emit_signal(p_object, "emit_signal") {}
+
+	uint32_t hash() const override {
+		return uint32_t(uintptr_t(this));
+	}
+	godot::String get_as_text() const override {
+		return "ExportMeshCallable";
+	}
+	CompareEqualFunc get_compare_equal_func() const override {
+		return &_compare_equal;
+	}
+	CompareLessFunc get_compare_less_func() const override {
+		return &_compare_less;
+	}
+	bool is_valid() const override {
+		return true;
+	}
+	godot::ObjectID get_object() const override {
+		return godot::ObjectID();
+	}
+	void call(const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) const override {
+		r_call_error.error = GDEXTENSION_CALL_OK;
+		const godot::Error err = export_mesh(_path, *_mesh, _surfaces, _has_attributes);
+		// the callable only holds the object's ID, so nothing is emitted if it was freed meanwhile
+		_emit_signal.call_deferred("export_finished", _path, err);
+	}
+};
+
+// Queues an export of p_mesh on the WorkerThreadPool and returns the task ID; p_object gets the
+// export_finished signal. p_mesh must not be changed by anyone else afterwards.
+template <typename Precision, typename I>
+int64_t export_mesh_async(const godot::String &p_path, std::shared_ptr<const manifold::MeshGLP<Precision, I>> p_mesh, std::vector<ExportSurface> p_surfaces, bool p_has_attributes, godot::Object *p_object) {
+	godot::WorkerThreadPool *pool = godot::WorkerThreadPool::get_singleton();
+	ERR_FAIL_NULL_V(pool, -1);
+	const godot::Callable task(memnew(ExportMeshCallable<Precision, I>(std::move(p_mesh), std::move(p_surfaces), p_has_attributes, p_path, p_object)));
+	return pool->add_task(task, false, vformat("export %s", p_path));
+}
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/xml_parser.hpp>
+#include <godot_cpp/classes/zip_reader.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+
+#include <manifold/manifold.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Welds positions as they are parsed, so the MeshGL never holds duplicate vertices and needs no merge
+// vectors. With a tolerance of zero only bit-identical positions are joined; otherwise positions are
+// bucketed into cells one tolerance wide and the neighbouring cells are searched as well.
+template <typename Precision, typename I>
+class ImportWelder {
+	struct Cell {
+		int64_t x, y, z;
+
+		bool operator==(const Cell &p_other) const {
+			return x == p_other.x && y == p_other.y && z == p_other.z;
+		}
+	};
+	struct CellHasher {
+		static _FORCE_INLINE_ uint32_t hash(const Cell &p_cell) {
+			uint32_t h = godot::hash_murmur3_one_64(uint64_t(p_cell.x));
+			h = godot::hash_murmur3_one_64(uint64_t(p_cell.y), h);
+			h = godot::hash_murmur3_one_64(uint64_t(p_cell.z), h);
+			return godot::hash_fmix32(h);
+		}
+	};
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	manifold::MeshGLP<Precision, I> &_mesh;
+	const double _tolerance;
+	godot::HashMap<Cell, uint32_t, CellHasher> _heads;
+	std::vector<uint32_t> _next;
+
+	Cell _cell(const manifold::vec3 &p_position) const {
+		if (_tolerance <= 0.0) {
+			// adding zero turns -0.0 into 0.0 so both land in the same cell
+			Cell cell;
+			const double x = p_position.x + 0.0, y = p_position.y + 0.0, z = p_position.z + 0.0;
+			memcpy(&cell.x, &x, sizeof(x));
+			memcpy(&cell.y, &y, sizeof(y));
+			memcpy(&cell.z, &z, sizeof(z));
+			return cell;
+		}
+		return { int64_t(std::floor(p_position.x / _tolerance)), int64_t(std::floor(p_position.y / _tolerance)), int64_t(std::floor(p_position.z / _tolerance)) };
+	}
+
+public:
+	ImportWelder(manifold::MeshGLP<Precision, I> &p_mesh, double p_tolerance) :
+			_mesh(p_mesh), _tolerance(p_tolerance) {
+		DEV_ASSERT(p_mesh.numProp == 3);
+	}
+
+	uint32_t add(const manifold::vec3 &p_position) {
+		const Cell cell = _cell(p_position);
+		if (_tolerance <= 0.0) {
+			const uint32_t *existing = _heads.getptr(cell);
+			if (existing) {
+				return *existing;
+			}
+		} else {
+			const double tolerance_squared = _tolerance * _tolerance;
+			for (int64_t dx = -1; dx <= 1; dx++) {
+				for (int64_t dy = -1; dy <= 1; dy++) {
+					for (int64_t dz = -1; dz <= 1; dz++) {
+						const uint32_t *head = _heads.getptr({ cell.x + dx, cell.y + dy, cell.z + dz });
+						for (uint32_t vert = head ? *head : NONE; vert != NONE; vert = _next[vert]) {
+							const Precision *other = &_mesh.vertProperties[vert * 3];
+							const manifold::vec3 offset = p_position - manifold::vec3(other[0], other[1], other[2]);
+							if (manifold::la::dot(offset, offset) <= tolerance_squared) {
+								return vert;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		const uint32_t vert = _next.size();
+		_mesh.vertProperties.push_back(Precision(p_position.x));
+		_mesh.vertProperties.push_back(Precision(p_position.y));
+		_mesh.vertProperties.push_back(Precision(p_position.z));
+
+		uint32_t *head = _heads.getptr(cell);
+		_next.push_back(head ? *head : NONE);
+		if (head) {
+			*head = vert;
+		} else {
+			_heads.insert(cell, vert);
+		}
+		return vert;
+	}
+};
+
+// Triangles are collected per material group and concatenated into runs at the end.
+struct ImportGroups {
+	std::vector<godot::String> names;
+	std::vector<std::vector<uint32_t>> tri_verts;
+	godot::HashMap<godot::String, uint32_t> by_name;
+	uint32_t current = 0;
+
+	ImportGroups() {
+		select(godot::String());
+	}
+
+	void select(const godot::String &p_name) {
+		const uint32_t *existing = by_name.getptr(p_name);
+		if (existing) {
+			current = *existing;
+			return;
+		}
+		current = names.size();
+		by_name.insert(p_name, current);
+		names.push_back(p_name);
+		tri_verts.emplace_back();
+	}
+
+	void add(uint32_t p_a, uint32_t p_b, uint32_t p_c) {
+		// welding can collapse sliver triangles
+		if (unlikely(p_a == p_b || p_b == p_c || p_c == p_a)) {
+			return;
+		}
+		std::vector<uint32_t> &group = tri_verts[current];
+		group.push_back(p_a);
+		group.push_back(p_b);
+		group.push_back(p_c);
+	}
+
+	// Moves the groups into runs of r_mesh. runOriginalID is left as the index into r_names.
+	template <typename Precision, typename I>
+	void finish(manifold::MeshGLP<Precision, I> &r_mesh, std::vector<godot::String> &r_names) {
+		size_t total = 0;
+		for (const std::vector<uint32_t> &group : tri_verts) {
+			total += group.size();
+		}
+		r_mesh.triVerts.reserve(total);
+		r_mesh.runIndex.push_back(0);
+		for (size_t i = 0; i < tri_verts.size(); i++) {
+			if (tri_verts[i].empty()) {
+				continue;
+			}
+			r_mesh.triVerts.insert(r_mesh.triVerts.end(), tri_verts[i].begin(), tri_verts[i].end());
+			r_mesh.runIndex.push_back(r_mesh.triVerts.size());
+			r_mesh.runOriginalID.push_back(r_names.size());
+			r_names.push_back(names[i]);
+			std::vector<uint32_t>().swap(tri_verts[i]);
+		}
+	}
+};
+
+// Hands out a file one line at a time while only ever holding one chunk of it in memory.
+class ImportLineReader {
+	static constexpr int64_t CHUNK = 1 << 20;
+
+	godot::Ref<godot::FileAccess> _file;
+	godot::PackedByteArray _chunk;
+	int64_t _pos = 0;
+
+public:
+	ImportLineReader(const godot::Ref<godot::FileAccess> &p_file) :
+			_file(p_file) {}
+
+	bool next(std::string &r_line) {
+		r_line.clear();
+		while (true) {
+			if (_pos == _chunk.size()) {
+				if (_file->eof_reached() || _file->get_position() >= _file->get_length()) {
+					return !r_line.empty();
+				}
+				_chunk = _file->get_buffer(CHUNK);
+				_pos = 0;
+				if (_chunk.is_empty()) {
+					return !r_line.empty();
+				}
+			}
+
+			const char *data = reinterpret_cast<const char *>(_chunk.ptr());
+			const char *end = static_cast<const char *>(memchr(data + _pos, '\n', _chunk.size() - _pos));
+			if (!end) {
+				r_line.append(data + _pos, _chunk.size() - _pos);
+				_pos = _chunk.size();
+				continue;
+			}
+
+			r_line.append(data + _pos, end - (data + _pos));
+			_pos = end - data + 1;
+			if (!r_line.empty() && r_line.back() == '\r') {
+				r_line.pop_back();
+			}
+			return true;
+		}
+	}
+};
+
+static inline const char *import_skip_space(const char *p_str) {
+	while (*p_str == ' ' || *p_str == '\t') {
+		p_str++;
+	}
+	return p_str;
+}
+
+static inline bool import_keyword(const char *&r_str, const char *p_keyword) {
+	const size_t length = strlen(p_keyword);
+	if (strncmp(r_str, p_keyword, length) != 0 || (r_str[length] != ' ' && r_str[length] != '\t' && r_str[length] != '\0')) {
+		return false;
+	}
+	r_str = import_skip_space(r_str + length);
+	return true;
+}
+
+static inline bool import_vec3(const char *p_str, manifold::vec3 &r_vec) {
+	char *end;
+	for (int i = 0; i < 3; i++) {
+		r_vec[i] = strtod(p_str, &end);
+		if (end == p_str) {
+			return false;
+		}
+		p_str = end;
+	}
+	return true;
+}
+
+template <typename Precision, typename I>
+godot::Error import_stl(const godot::Ref<godot::FileAccess> &p_file, ImportWelder<Precision, I> &p_welder, ImportGroups &p_groups) {
+	constexpr int64_t RECORD = 50;
+	constexpr int64_t RECORDS_PER_CHUNK = 20000;
+
+	// plenty of binary files start with "solid" too, so trust the triangle count if the size matches
+	const uint64_t length = p_file->get_length();
+	if (length >= 84) {
+		p_file->seek(80);
+		const uint64_t count = p_file->get_32();
+		if (length == 84 + count * RECORD) {
+			for (uint64_t first = 0; first < count; first += RECORDS_PER_CHUNK) {
+				const int64_t records = std::min<uint64_t>(RECORDS_PER_CHUNK, count - first);
+				const godot::PackedByteArray chunk = p_file->get_buffer(records * RECORD);
+				ERR_FAIL_COND_V(chunk.size() != records * RECORD, godot::ERR_FILE_CORRUPT);
+
+				for (int64_t record = 0; record < records; record++) {
+					// skip the facet normal; it is recomputed from the welded mesh
+					const uint8_t *data = chunk.ptr() + record * RECORD + 12;
+					uint32_t verts[3];
+					for (int i = 0; i < 3; i++) {
+						float position[3];
+						memcpy(position, data + i * 12, sizeof(position));
+						verts[i] = p_welder.add({ position[0], position[1], position[2] });
+					}
+					p_groups.add(verts[0], verts[1], verts[2]);
+				}
+			}
+			return godot::OK;
+		}
+	}
+
+	p_file->seek(0);
+	ImportLineReader reader(p_file);
+	std::string line;
+	uint32_t verts[3];
+	int corner = 0;
+	while (reader.next(line)) {
+		const char *str = import_skip_space(line.c_str());
+		if (import_keyword(str, "facet")) {
+			corner = 0;
+		} else if (import_keyword(str, "vertex")) {
+			manifold::vec3 position;
+			ERR_FAIL_COND_V(!import_vec3(str, position) || corner >= 3, godot::ERR_PARSE_ERROR);
+			verts[corner++] = p_welder.add(position);
+		} else if (import_keyword(str, "endfacet")) {
+			ERR_FAIL_COND_V(corner != 3, godot::ERR_PARSE_ERROR);
+			p_groups.add(verts[0], verts[1], verts[2]);
+		}
+	}
+	return godot::OK;
+}
+
+template <typename Precision, typename I>
+godot::Error import_obj(const godot::Ref<godot::FileAccess> &p_file, ImportWelder<Precision, I> &p_welder, ImportGroups &p_groups) {
+	// OBJ indices refer to positions in file order; this maps them to welded vertices
+	std::vector<uint32_t> positions;
+	std::vector<uint32_t> face;
+
+	ImportLineReader reader(p_file);
+	std::string line;
+	while (reader.next(line)) {
+		const char *str = import_skip_space(line.c_str());
+		if (import_keyword(str, "v")) {
+			manifold::vec3 position;
+			ERR_FAIL_COND_V(!import_vec3(str, position), godot::ERR_PARSE_ERROR);
+			positions.push_back(p_welder.add(position));
+		} else if (import_keyword(str, "f")) {
+			face.clear();
+			while (*str) {
+				char *end;
+				const long long index = strtoll(str, &end, 10);
+				ERR_FAIL_COND_V(end == str || index == 0, godot::ERR_PARSE_ERROR);
+				const long long resolved = index < 0 ? (long long)positions.size() + index : index - 1;
+				ERR_FAIL_COND_V(resolved < 0 || resolved >= (long long)positions.size(), godot::ERR_PARSE_ERROR);
+				face.push_back(positions[resolved]);
+
+				// texture coordinate and normal indices don't matter for the shape
+				str = end;
+				while (*str && *str != ' ' && *str != '\t') {
+					str++;
+				}
+				str = import_skip_space(str);
+			}
+			ERR_FAIL_COND_V(face.size() < 3, godot::ERR_PARSE_ERROR);
+			for (size_t i = 2; i < face.size(); i++) {
+				p_groups.add(face[0], face[i - 1], face[i]);
+			}
+		} else if (import_keyword(str, "usemtl")) {
+			p_groups.select(godot::String::utf8(str));
+		}
+	}
+	return godot::OK;
+}
+
+static inline double import_3mf_unit_scale(const godot::String &p_unit) {
+	if (p_unit == "micron") {
+		return 1e-6;
+	}
+	if (p_unit == "centimeter") {
+		return 1e-2;
+	}
+	if (p_unit == "inch") {
+		return 0.0254;
+	}
+	if (p_unit == "foot") {
+		return 0.3048;
+	}
+	if (p_unit == "meter") {
+		return 1.0;
+	}
+	// millimeter is the default
+	return 1e-3;
+}
+
+// A 3MF object as written in the file: a mesh in its own coordinates, other objects placed in it
+// as components, or both. Nothing is welded until a build item places it in the scene.
+struct Import3MFObject {
+	struct Component {
+		int64_t object_id;
+		manifold::mat3x4 transform;
+	};
+
+	std::vector<manifold::vec3> positions;
+	std::vector<uint32_t> tri_verts;
+	// the ImportGroups group of each triangle
+	std::vector<uint32_t> tri_groups;
+	std::vector<Component> components;
+};
+
+static inline manifold::mat3x4 import_3mf_identity() {
+	return manifold::mat3x4({ 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 }, { 0.0, 0.0, 0.0 });
+}
+
+// 3MF transforms are "m00 m01 m02 m10 ... m32", applied to row vectors, so row i of the file is
+// column i of the matrix.
+static inline bool import_3mf_transform(const godot::String &p_transform, manifold::mat3x4 &r_transform) {
+	r_transform = import_3mf_identity();
+	const godot::String transform = p_transform.strip_edges();
+	if (transform.is_empty()) {
+		return true;
+	}
+	const godot::PackedFloat64Array values = transform.split_floats(" ", false);
+	if (values.size() != 12) {
+		return false;
+	}
+	for (int column = 0; column < 4; column++) {
+		r_transform[column] = manifold::vec3(values[column * 3 + 0], values[column * 3 + 1], values[column * 3 + 2]);
+	}
+	return true;
+}
+
+static inline manifold::vec3 import_3mf_apply(const manifold::mat3x4 &p_transform, const manifold::vec3 &p_position) {
+	return p_transform[0] * p_position.x + p_transform[1] * p_position.y + p_transform[2] * p_position.z + p_transform[3];
+}
+
+// p_parent applied after p_child
+static inline manifold::mat3x4 import_3mf_compose(const manifold::mat3x4 &p_parent, const manifold::mat3x4 &p_child) {
+	manifold::mat3x4 result;
+	for (int column = 0; column < 3; column++) {
+		result[column] = p_parent[0] * p_child[column].x + p_parent[1] * p_child[column].y + p_parent[2] * p_child[column].z;
+	}
+	result[3] = import_3mf_apply(p_parent, p_child[3]);
+	return result;
+}
+
+// Welds the triangles of p_object_id and everything it contains into the mesh, placed by p_transform.
+// r_stack holds the objects being placed, to catch components that contain themselves.
+template <typename Precision, typename I>
+godot::Error import_3mf_place(const godot::HashMap<int64_t, Import3MFObject> &p_objects, int64_t p_object_id, const manifold::mat3x4 &p_transform, double p_scale, std::vector<int64_t> &r_stack, ImportWelder<Precision, I> &p_welder, ImportGroups &p_groups) {
+	const Import3MFObject *object = p_objects.getptr(p_object_id);
+	ERR_FAIL_NULL_V_MSG(object, godot::ERR_PARSE_ERROR, vformat("3MF object %d does not exist", p_object_id));
+	ERR_FAIL_COND_V_MSG(std::find(r_stack.begin(), r_stack.end(), p_object_id) != r_stack.end(), godot::ERR_PARSE_ERROR, vformat("3MF object %d contains itself", p_object_id));
+
+	if (!object->tri_verts.empty()) {
+		std::vector<uint32_t> verts(object->positions.size());
+		for (size_t i = 0; i < verts.size(); i++) {
+			verts[i] = p_welder.add(import_3mf_apply(p_transform, object->positions[i]) * p_scale);
+		}
+		// a mirroring transform turns the triangles inside out, so they are wound the other way
+		const bool flip = manifold::la::dot(p_transform[0], manifold::la::cross(p_transform[1], p_transform[2])) < 0.0;
+		for (size_t tri = 0; tri < object->tri_groups.size(); tri++) {
+			const uint32_t *tri_verts = &object->tri_verts[tri * 3];
+			p_groups.current = object->tri_groups[tri];
+			if (flip) {
+				p_groups.add(verts[tri_verts[0]], verts[tri_verts[2]], verts[tri_verts[1]]);
+			} else {
+				p_groups.add(verts[tri_verts[0]], verts[tri_verts[1]], verts[tri_verts[2]]);
+			}
+		}
+	}
+
+	r_stack.push_back(p_object_id);
+	for (const Import3MFObject::Component &component : object->components) {
+		const godot::Error err = import_3mf_place(p_objects, component.object_id, import_3mf_compose(p_transform, component.transform), p_scale, r_stack, p_welder, p_groups);
+		if (err != godot::OK) {
+			return err;
+		}
+	}
+	r_stack.pop_back();
+	return godot::OK;
+}
+
+template <typename Precision, typename I>
+godot::Error import_3mf(const godot::String &p_path, ImportWelder<Precision, I> &p_welder, ImportGroups &p_groups) {
+	godot::Ref<godot::ZIPReader> zip;
+	zip.instantiate();
+	godot::Error err = zip->open(p_path);
+	ERR_FAIL_COND_V_MSG(err != godot::OK, err, vformat("Cannot open %s", p_path));
+
+	godot::String model_path = "3D/3dmodel.model";
+	godot::Ref<godot::XMLParser> parser;
+	parser.instantiate();
+	if (zip->file_exists("_rels/.rels")) {
+		parser->open_buffer(zip->read_file("_rels/.rels"));
+		while (parser->read() == godot::OK) {
+			if (parser->get_node_type() == godot::XMLParser::NODE_ELEMENT && parser->get_node_name() == "Relationship" && parser->get_named_attribute_value_safe("Type").ends_with("/3dmodel")) {
+				model_path = parser->get_named_attribute_value_safe("Target").trim_prefix("/");
+				break;
+			}
+		}
+	}
+
+	// ZIPReader can only inflate a whole entry at once, but the XML is walked node by node without
+	// ever building a document tree
+	const godot::PackedByteArray model = zip->read_file(model_path);
+	zip->close();
+	ERR_FAIL_COND_V_MSG(model.is_empty(), godot::ERR_FILE_CORRUPT, vformat("%s has no model part", p_path));
+
+	err = parser->open_buffer(model);
+	ERR_FAIL_COND_V(err != godot::OK, err);
+
+	double scale = 1e-3;
+	godot::HashMap<int64_t, std::vector<godot::String>> base_materials;
+	int64_t current_materials = -1;
+	godot::HashMap<int64_t, Import3MFObject> objects;
+	Import3MFObject *object = nullptr;
+	int64_t object_pid = -1, object_pindex = -1;
+	struct Item {
+		int64_t object_id;
+		manifold::mat3x4 transform;
+	};
+	std::vector<Item> items;
+
+	const auto select_material = [&](int64_t p_pid, int64_t p_index) {
+		const std::vector<godot::String> *materials = base_materials.getptr(p_pid);
+		p_groups.select(materials && p_index >= 0 && p_index < int64_t(materials->size()) ? (*materials)[p_index] : godot::String());
+	};
+
+	while (parser->read() == godot::OK) {
+		if (parser->get_node_type() != godot::XMLParser::NODE_ELEMENT) {
+			continue;
+		}
+
+		const godot::String name = parser->get_node_name();
+		if (name == "model") {
+			scale = import_3mf_unit_scale(parser->get_named_attribute_value_safe("unit"));
+		} else if (name == "basematerials") {
+			current_materials = parser->get_named_attribute_value_safe("id").to_int();
+			base_materials.insert(current_materials, {});
+		} else if (name == "base") {
+			std::vector<godot::String> *materials = base_materials.getptr(current_materials);
+			ERR_FAIL_NULL_V(materials, godot::ERR_PARSE_ERROR);
+			materials->push_back(parser->get_named_attribute_value_safe("name"));
+		} else if (name == "object") {
+			const int64_t id = parser->get_named_attribute_value_safe("id").to_int();
+			ERR_FAIL_COND_V_MSG(objects.has(id), godot::ERR_PARSE_ERROR, vformat("3MF object %d is defined twice", id));
+			object = &objects.insert(id, Import3MFObject())->value;
+			object_pid = parser->has_attribute("pid") ? parser->get_named_attribute_value_safe("pid").to_int() : -1;
+			object_pindex = parser->has_attribute("pindex") ? parser->get_named_attribute_value_safe("pindex").to_int() : -1;
+		} else if (name == "vertex") {
+			ERR_FAIL_NULL_V(object, godot::ERR_PARSE_ERROR);
+			object->positions.emplace_back(parser->get_named_attribute_value_safe("x").to_float(), parser->get_named_attribute_value_safe("y").to_float(), parser->get_named_attribute_value_safe("z").to_float());
+		} else if (name == "triangle") {
+			ERR_FAIL_NULL_V(object, godot::ERR_PARSE_ERROR);
+			const int64_t v1 = parser->get_named_attribute_value_safe("v1").to_int();
+			const int64_t v2 = parser->get_named_attribute_value_safe("v2").to_int();
+			const int64_t v3 = parser->get_named_attribute_value_safe("v3").to_int();
+			const int64_t count = object->positions.size();
+			ERR_FAIL_COND_V(v1 < 0 || v1 >= count || v2 < 0 || v2 >= count || v3 < 0 || v3 >= count, godot::ERR_PARSE_ERROR);
+
+			const int64_t pid = parser->has_attribute("pid") ? parser->get_named_attribute_value_safe("pid").to_int() : object_pid;
+			const int64_t p1 = parser->has_attribute("p1") ? parser->get_named_attribute_value_safe("p1").to_int() : object_pindex;
+			select_material(pid, p1);
+			object->tri_verts.push_back(uint32_t(v1));
+			object->tri_verts.push_back(uint32_t(v2));
+			object->tri_verts.push_back(uint32_t(v3));
+			object->tri_groups.push_back(p_groups.current);
+		} else if (name == "component" || name == "item") {
+			// the production extension can point into other model parts, which aren't read
+			ERR_FAIL_COND_V_MSG(parser->has_attribute("p:path"), godot::ERR_UNAVAILABLE, vformat("%s references another model part, which is not supported", p_path));
+			manifold::mat3x4 transform;
+			ERR_FAIL_COND_V(!import_3mf_transform(parser->get_named_attribute_value_safe("transform"), transform), godot::ERR_PARSE_ERROR);
+			const int64_t object_id = parser->get_named_attribute_value_safe("objectid").to_int();
+			if (name == "item") {
+				items.push_back({ object_id, transform });
+			} else {
+				ERR_FAIL_NULL_V(object, godot::ERR_PARSE_ERROR);
+				object->components.push_back({ object_id, transform });
+			}
+		}
+	}
+
+	// only what the build places ends up in the scene, as often as it is placed
+	std::vector<int64_t> stack;
+	for (const Item &item : items) {
+		err = import_3mf_place(objects, item.object_id, item.transform, scale, stack, p_welder, p_groups);
+		if (err != godot::OK) {
+			return err;
+		}
+	}
+	return godot::OK;
+}
+
+// Parses p_path (stl, obj or 3mf, by extension) straight into a position-only MeshGL with one run per
+// material group. r_group_names receives the name of each run's group, and runOriginalID holds the
+// index into it until the caller assigns real IDs.
+template <typename Precision, typename I>
+godot::Error import_mesh(const godot::String &p_path, double p_weld_tolerance, manifold::MeshGLP<Precision, I> &r_mesh, std::vector<godot::String> &r_group_names) {
+	ERR_FAIL_COND_V(!std::isfinite(p_weld_tolerance) || p_weld_tolerance < 0.0, godot::ERR_INVALID_PARAMETER);
+
+	r_mesh = manifold::MeshGLP<Precision, I>();
+	r_mesh.numProp = 3;
+	ImportWelder<Precision, I> welder(r_mesh, p_weld_tolerance);
+	ImportGroups groups;
+
+	const godot::String extension = p_path.get_extension().to_lower();
+	godot::Error err;
+	if (extension == "3mf") {
+		err = import_3mf(p_path, welder, groups);
+	} else {
+		ERR_FAIL_COND_V_MSG(extension != "stl" && extension != "obj", godot::ERR_FILE_UNRECOGNIZED, vformat("Cannot import %s: supported extensions are stl, obj and 3mf", p_path));
+
+		const godot::Ref<godot::FileAccess> file = godot::FileAccess::open(p_path, godot::FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(file.is_null(), godot::FileAccess::get_open_error(), vformat("Cannot open %s", p_path));
+
+		err = extension == "stl" ? import_stl(file, welder, groups) : import_obj(file, welder, groups);
+	}
+	ERR_FAIL_COND_V_MSG(err != godot::OK, err, vformat("Failed to parse %s", p_path));
+
+	groups.finish(r_mesh, r_group_names);
+	ERR_FAIL_COND_V_MSG(r_mesh.triVerts.empty(), godot::ERR_FILE_CORRUPT, vformat("%s has no triangles", p_path));
+	return godot::OK;
+}
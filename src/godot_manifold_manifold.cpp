@@ -1,8 +1,16 @@
+#include "godot_manifold_cache.h"
 #include "godot_manifold_converters.h"
 #include "godot_manifold_defs.h"
+#include "godot_manifold_export.h"
+#include "godot_manifold_profiler.h"
+#include "godot_manifold_slice.h"
 
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
 
+#include <manifold/cross_section.h>
 #include <manifold/manifold.h>
 
 using namespace godot;
@@ -19,9 +27,18 @@ void Manifold::_bind_methods() {
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("level_set", "sdf", "bounds", "edge_length", "level", "tolerance"), &Manifold::level_set_bind, DEFVAL(0), DEFVAL(-1));
 
 	ClassDB::bind_method(D_METHOD("slice", "height"), &Manifold::slice, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("slice_many", "heights"), &Manifold::slice_many);
 	ClassDB::bind_method(D_METHOD("project"), &Manifold::project);
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("extrude", "cross_section", "height", "num_divisions", "twist_degrees", "scale_top"), &Manifold::extrude, DEFVAL(0), DEFVAL(0.0), DEFVAL(Vector2(1.0f, 1.0f)));
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("revolve", "cross_section", "circular_segments", "revolve_degrees"), &Manifold::revolve, DEFVAL(0), DEFVAL(360.0f));
+	ClassDB::bind_method(D_METHOD("slice_cross_section", "height"), &Manifold::slice_cross_section, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("project_cross_section"), &Manifold::project_cross_section);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("extrude_cross_section", "cross_section", "height", "num_divisions", "twist_degrees", "scale_top"), &Manifold::extrude_cross_section, DEFVAL(0), DEFVAL(0.0), DEFVAL(Vector2(1.0f, 1.0f)));
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("revolve_cross_section", "cross_section", "circular_segments", "revolve_degrees"), &Manifold::revolve_cross_section, DEFVAL(0), DEFVAL(360.0f));
+
+	ClassDB::bind_method(D_METHOD("export_to_file", "path"), &Manifold::export_to_file);
+	ClassDB::bind_method(D_METHOD("export_to_file_async", "path"), &Manifold::export_to_file_async);
+	ADD_SIGNAL(MethodInfo("export_finished", PropertyInfo(Variant::STRING, "path"), PropertyInfo(Variant::INT, "error")));
 
 	BIND_ENUM_CONSTANT(NO_ERROR);
 	BIND_ENUM_CONSTANT(ERROR_NON_FINITE_VERTEX);
@@ -93,6 +110,66 @@ void Manifold::_bind_methods() {
 
 struct Manifold::Inner {
 	manifold::Manifold _manifold;
+	ManifoldCacheKey _content_hash;
+	bool _has_content_hash = false;
+	// a cache miss that hasn't been evaluated yet; see _cached_result
+	bool _pending_store = false;
+	// set along with the content hash, which leaves the actual IDs out: the original IDs of the runs
+	// in order of first appearance, or for a result, those of its operands
+	std::vector<uint32_t> _original_ids;
+
+	// for anything that evaluates the manifold anyway, which is when a pending result can be sized
+	// and stored without forcing work that lazy CSG would have batched away
+	const manifold::Manifold &evaluated() {
+		if (unlikely(_pending_store)) {
+			_pending_store = false;
+			ManifoldCache::store(_content_hash, _manifold, _original_ids);
+		}
+		return _manifold;
+	}
+	// primitives are keyed on their parameters, so using one as an operand doesn't hash its mesh
+	static Ref<Manifold> keyed_leaf(const manifold::Manifold &p_manifold, const std::function<void(ManifoldHasher &)> &p_key) {
+		Ref<Manifold> wrapped = memnew(Manifold(p_manifold));
+		if (unlikely(ManifoldCache::is_memory_enabled())) {
+			ManifoldHasher hasher;
+			p_key(hasher);
+			wrapped->_inner->_content_hash = hasher.finish();
+			wrapped->_inner->_has_content_hash = true;
+			// every call reserves a fresh ID, which a cache hit built on this one has to carry
+			const int original_id = p_manifold.OriginalID();
+			if (original_id >= 0) {
+				wrapped->_inner->_original_ids.push_back(uint32_t(original_id));
+			}
+		}
+		return wrapped;
+	}
+	// a cached result carries the original IDs of the operands it was computed from; this moves its
+	// runs onto the IDs of the operands at hand, matched by position. IDs the result introduced
+	// itself (hull, the cap of a trim) get fresh ones, as computing it again would have.
+	static manifold::Manifold with_original_ids(const manifold::Manifold &p_manifold, const std::vector<uint32_t> &p_from, const std::vector<uint32_t> &p_to) {
+		manifold::MeshGL64 mesh = p_manifold.GetMeshGL64();
+		HashMap<uint32_t, uint32_t> to_id;
+		for (size_t i = 0; i < p_from.size(); i++) {
+			to_id.insert(p_from[i], p_to[i]);
+		}
+		for (uint32_t &id : mesh.runOriginalID) {
+			HashMap<uint32_t, uint32_t>::Iterator it = to_id.find(id);
+			if (!it) {
+				it = to_id.insert(id, manifold::Manifold::ReserveIDs(1));
+			}
+			id = it->value;
+		}
+		return manifold::Manifold(mesh);
+	}
+	static std::vector<const Manifold *> operands(const TypedArray<Manifold> &p_manifolds) {
+		std::vector<const Manifold *> v;
+		v.reserve(p_manifolds.size());
+		for (int64_t i = 0; i < p_manifolds.size(); i++) {
+			const Ref<Manifold> manifold = p_manifolds[i];
+			v.push_back(manifold.ptr());
+		}
+		return v;
+	}
 
 	static _FORCE_INLINE_ std::vector<manifold::Manifold> to_manifold_vec(const TypedArray<Manifold> &p_manifolds) {
 		std::vector<manifold::Manifold> v;
@@ -104,6 +181,15 @@ struct Manifold::Inner {
 		});
 		return v;
 	}
+	static void add_content_hashes(ManifoldHasher &r_key, const char *p_operation, const TypedArray<Manifold> &p_manifolds) {
+		r_key.add(p_operation);
+		r_key.add(uint64_t(p_manifolds.size()));
+		for (int64_t i = 0; i < p_manifolds.size(); i++) {
+			const Ref<Manifold> manifold = p_manifolds[i];
+			// null entries are skipped by to_manifold_vec (with an error), so they still need a slot here
+			r_key.add(manifold.is_valid() ? manifold->_get_content_hash() : ManifoldCacheKey());
+		}
+	}
 	static _FORCE_INLINE_ TypedArray<Manifold> from_manifold_vec(const std::vector<manifold::Manifold> &p_manifolds) {
 		TypedArray<Manifold> a;
 		a.resize(p_manifolds.size());
@@ -127,26 +213,34 @@ Manifold::~Manifold() {
 }
 
 Ref<ManifoldMesh32> Manifold::to_mesh32(int p_normal_idx) const {
-	return memnew(ManifoldMesh32(_inner->_manifold.GetMeshGL(p_normal_idx)));
+	return memnew(ManifoldMesh32(_inner->evaluated().GetMeshGL(p_normal_idx)));
 }
 Ref<ManifoldMesh64> Manifold::to_mesh64(int p_normal_idx) const {
-	return memnew(ManifoldMesh64(_inner->_manifold.GetMeshGL64(p_normal_idx)));
+	return memnew(ManifoldMesh64(_inner->evaluated().GetMeshGL64(p_normal_idx)));
 }
 
 TypedArray<Manifold> Manifold::decompose() const {
-	return Inner::from_manifold_vec(_inner->_manifold.Decompose());
+	return Inner::from_manifold_vec(_inner->evaluated().Decompose());
 }
 Ref<Manifold> Manifold::tetrahedron() {
-	return memnew(Manifold(manifold::Manifold::Tetrahedron()));
+	return Inner::keyed_leaf(manifold::Manifold::Tetrahedron(), [](ManifoldHasher &r_key) {
+		r_key.add("Manifold.tetrahedron");
+	});
 }
 Ref<Manifold> Manifold::cube(Vector3 p_size, bool p_center) {
-	return memnew(Manifold(manifold::Manifold::Cube(to_vec3(p_size), p_center)));
+	return Inner::keyed_leaf(manifold::Manifold::Cube(to_vec3(p_size), p_center), [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.cube", p_size, uint64_t(p_center));
+	});
 }
 Ref<Manifold> Manifold::cylinder(double p_height, double p_radius_low, double p_radius_high, int p_circular_segments, bool p_center) {
-	return memnew(Manifold(manifold::Manifold::Cylinder(p_height, p_radius_low, p_radius_high, p_circular_segments, p_center)));
+	return Inner::keyed_leaf(manifold::Manifold::Cylinder(p_height, p_radius_low, p_radius_high, p_circular_segments, p_center), [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.cylinder", p_height, p_radius_low, p_radius_high, uint64_t(p_circular_segments), uint64_t(p_center));
+	});
 }
 Ref<Manifold> Manifold::sphere(double p_radius, int p_circular_segments) {
-	return memnew(Manifold(manifold::Manifold::Sphere(p_radius, p_circular_segments)));
+	return Inner::keyed_leaf(manifold::Manifold::Sphere(p_radius, p_circular_segments), [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.sphere", p_radius, uint64_t(p_circular_segments));
+	});
 }
 Ref<Manifold> Manifold::level_set_bind(const Callable &p_sdf, AABB p_bounds, double p_edge_length, double p_level, double p_tolerance) {
 	return level_set([p_sdf](Vector3 p_vec) -> double {
@@ -162,10 +256,24 @@ Ref<Manifold> Manifold::level_set(const std::function<double(Vector3)> &p_sdf, A
 }
 
 TypedArray<PackedVector2Array> Manifold::slice(double p_height) const {
-	return from_polygons(_inner->_manifold.Slice(p_height));
+	return from_polygons(_inner->evaluated().Slice(p_height));
+}
+TypedArray<CrossSection> Manifold::slice_many(const PackedFloat64Array &p_heights) const {
+	const std::vector<double> heights(p_heights.ptr(), p_heights.ptr() + p_heights.size());
+	for (const double height : heights) {
+		ERR_FAIL_COND_V(!Math::is_finite(height), TypedArray<CrossSection>());
+	}
+
+	const std::vector<manifold::CrossSection> layers = slice_mesh(_inner->evaluated().GetMeshGL64(), heights);
+	TypedArray<CrossSection> wrapped_layers;
+	wrapped_layers.resize(layers.size());
+	for (size_t i = 0; i < layers.size(); i++) {
+		wrapped_layers[i] = Ref<CrossSection>(memnew(CrossSection(layers[i])));
+	}
+	return wrapped_layers;
 }
 TypedArray<PackedVector2Array> Manifold::project() const {
-	return from_polygons(_inner->_manifold.Project());
+	return from_polygons(_inner->evaluated().Project());
 }
 Ref<Manifold> Manifold::extrude(const TypedArray<PackedVector2Array> &p_cross_section, double p_height, int p_num_divisions, double p_twist_degrees, Vector2 p_scale_top) {
 	return memnew(Manifold(manifold::Manifold::Extrude(to_polygons(p_cross_section), p_height, p_num_divisions, p_twist_degrees, to_vec2(p_scale_top))));
@@ -174,56 +282,162 @@ Ref<Manifold> Manifold::revolve(const TypedArray<PackedVector2Array> &p_cross_se
 	return memnew(Manifold(manifold::Manifold::Revolve(to_polygons(p_cross_section), p_circular_segments, p_revolve_degrees)));
 }
 
+Ref<CrossSection> Manifold::slice_cross_section(double p_height) const {
+	return memnew(CrossSection(manifold::CrossSection(_inner->evaluated().Slice(p_height), manifold::CrossSection::FillRule::Positive)));
+}
+Ref<CrossSection> Manifold::project_cross_section() const {
+	return memnew(CrossSection(manifold::CrossSection(_inner->evaluated().Project(), manifold::CrossSection::FillRule::Positive)));
+}
+Ref<Manifold> Manifold::extrude_cross_section(const Ref<CrossSection> &p_cross_section, double p_height, int p_num_divisions, double p_twist_degrees, Vector2 p_scale_top) {
+	ERR_FAIL_NULL_V(*p_cross_section, Ref<Manifold>());
+	return memnew(Manifold(manifold::Manifold::Extrude(p_cross_section->_get_cross_section().ToPolygons(), p_height, p_num_divisions, p_twist_degrees, to_vec2(p_scale_top))));
+}
+Ref<Manifold> Manifold::revolve_cross_section(const Ref<CrossSection> &p_cross_section, int p_circular_segments, double p_revolve_degrees) {
+	ERR_FAIL_NULL_V(*p_cross_section, Ref<Manifold>());
+	return memnew(Manifold(manifold::Manifold::Revolve(p_cross_section->_get_cross_section().ToPolygons(), p_circular_segments, p_revolve_degrees)));
+}
+
+godot::Error Manifold::export_to_file(const String &p_path) const {
+	// manifold keeps no MeshGL of its own, so one gets built; STL and glb store single precision
+	// anyway, so they get the half-size one
+	const String extension = p_path.get_extension().to_lower();
+	if (extension == "stl" || extension == "glb") {
+		return export_mesh(p_path, _inner->evaluated().GetMeshGL(), {}, false);
+	}
+	return export_mesh(p_path, _inner->evaluated().GetMeshGL64(), {}, false);
+}
+int64_t Manifold::export_to_file_async(const String &p_path) const {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	ERR_FAIL_NULL_V(pool, -1);
+
+	// the bound reference keeps this Manifold alive until the task is done with it
+	return pool->add_task(callable_mp_static(&Manifold::_export_task).bind(Ref<Manifold>(const_cast<Manifold *>(this)), p_path), false, vformat("export %s", p_path));
+}
+void Manifold::_export_task(const Ref<Manifold> &p_manifold, const String &p_path) {
+	const godot::Error err = p_manifold->export_to_file(p_path);
+	p_manifold->call_deferred("emit_signal", "export_finished", p_path, err);
+}
+
+ManifoldCacheKey Manifold::_get_content_hash() const {
+	if (unlikely(!_inner->_has_content_hash)) {
+		manifold::MeshGL64 mesh = _inner->_manifold.GetMeshGL64();
+		ManifoldHasher hasher;
+		hasher.add_mesh(mesh);
+		// reserved original IDs depend on the order things were created in, so only which runs share
+		// an ID goes into the key; the same shape rebuilt later then finds the earlier result, and
+		// _cached_result moves it onto the IDs of the shape at hand
+		HashMap<uint32_t, uint32_t> renumbered;
+		_inner->_original_ids.clear();
+		for (uint32_t &id : mesh.runOriginalID) {
+			HashMap<uint32_t, uint32_t>::Iterator it = renumbered.find(id);
+			if (!it) {
+				it = renumbered.insert(id, renumbered.size());
+				_inner->_original_ids.push_back(id);
+			}
+			id = it->value;
+		}
+		hasher.add_vector(mesh.runOriginalID);
+		_inner->_content_hash = hasher.finish();
+		_inner->_has_content_hash = true;
+	}
+	return _inner->_content_hash;
+}
+Ref<Manifold> Manifold::_cached_result(const std::vector<const Manifold *> &p_operands, const std::function<void(ManifoldHasher &)> &p_key, const std::function<manifold::Manifold()> &p_compute, bool p_adds_ids) {
+	// Manifold results never go to disk, so with only the disk cache on there is nothing to look up
+	if (likely(!ManifoldCache::is_memory_enabled())) {
+		return memnew(Manifold(p_compute()));
+	}
+
+	ManifoldHasher hasher;
+	p_key(hasher);
+	// the operands' content hashes leave their original IDs out, but which of them share one still
+	// shapes the result's runs
+	std::vector<uint32_t> original_ids;
+	HashMap<uint32_t, uint32_t> index_of_id;
+	for (const Manifold *operand : p_operands) {
+		if (!operand) {
+			continue;
+		}
+		operand->_get_content_hash();
+		hasher.add(uint64_t(operand->_inner->_original_ids.size()));
+		for (const uint32_t id : operand->_inner->_original_ids) {
+			HashMap<uint32_t, uint32_t>::Iterator it = index_of_id.find(id);
+			if (!it) {
+				it = index_of_id.insert(id, original_ids.size());
+				original_ids.push_back(id);
+			}
+			hasher.add(uint64_t(it->value));
+		}
+	}
+	const ManifoldCacheKey key = hasher.finish();
+
+	// the key describes the result up to its original IDs, so it can stand in for hashing its mesh
+	manifold::Manifold result;
+	std::vector<uint32_t> cached_ids;
+	const bool hit = ManifoldCache::lookup(key, result, cached_ids);
+	if (hit && (p_adds_ids || cached_ids != original_ids)) {
+		result = Inner::with_original_ids(result, cached_ids, original_ids);
+	}
+	Ref<Manifold> wrapped = memnew(Manifold(hit ? result : p_compute()));
+	wrapped->_inner->_content_hash = key;
+	wrapped->_inner->_has_content_hash = true;
+	wrapped->_inner->_original_ids = std::move(original_ids);
+	// sizing a miss would evaluate it, and an intermediate in a chain of booleans is never evaluated
+	// on its own; so it only goes into the cache once something evaluates it anyway
+	wrapped->_inner->_pending_store = !hit;
+	return wrapped;
+}
+
 Manifold::Error Manifold::status() const {
-	return static_cast<Error>(_inner->_manifold.Status());
+	return static_cast<Error>(_inner->evaluated().Status());
 }
 bool Manifold::is_empty() const {
-	return _inner->_manifold.IsEmpty();
+	return _inner->evaluated().IsEmpty();
 }
 int64_t Manifold::num_vert() const {
-	return _inner->_manifold.NumVert();
+	return _inner->evaluated().NumVert();
 }
 int64_t Manifold::num_edge() const {
-	return _inner->_manifold.NumEdge();
+	return _inner->evaluated().NumEdge();
 }
 int64_t Manifold::num_tri() const {
-	return _inner->_manifold.NumTri();
+	return _inner->evaluated().NumTri();
 }
 int64_t Manifold::num_prop() const {
-	return _inner->_manifold.NumProp();
+	return _inner->evaluated().NumProp();
 }
 int64_t Manifold::num_prop_vert() const {
-	return _inner->_manifold.NumPropVert();
+	return _inner->evaluated().NumPropVert();
 }
 AABB Manifold::bounding_box() const {
-	return from_box(_inner->_manifold.BoundingBox());
+	return from_box(_inner->evaluated().BoundingBox());
 }
 int Manifold::genus() const {
-	return _inner->_manifold.Genus();
+	return _inner->evaluated().Genus();
 }
 double Manifold::get_tolerance() const {
-	return _inner->_manifold.GetTolerance();
+	return _inner->evaluated().GetTolerance();
 }
 
 double Manifold::surface_area() const {
-	return _inner->_manifold.SurfaceArea();
+	return _inner->evaluated().SurfaceArea();
 }
 double Manifold::volume() const {
-	return _inner->_manifold.Volume();
+	return _inner->evaluated().Volume();
 }
 double Manifold::min_gap(const Ref<Manifold> &p_other, double p_search_length) const {
 	ERR_FAIL_NULL_V(*p_other, 0);
-	return _inner->_manifold.MinGap(p_other->_inner->_manifold, p_search_length);
+	return _inner->evaluated().MinGap(p_other->_inner->evaluated(), p_search_length);
 }
 
 int Manifold::original_id() const {
-	return _inner->_manifold.OriginalID();
+	return _inner->evaluated().OriginalID();
 }
 Ref<Manifold> Manifold::as_original() const {
-	return memnew(Manifold(_inner->_manifold.AsOriginal()));
+	return memnew(Manifold(_inner->evaluated().AsOriginal()));
 }
 Ref<Manifold> Manifold::merge_runs() const {
-	manifold::MeshGL64 mesh = _inner->_manifold.GetMeshGL64();
+	manifold::MeshGL64 mesh = _inner->evaluated().GetMeshGL64();
 	mesh.faceID.clear();
 	mesh.runTransform.clear();
 	for (size_t i = 1; i < mesh.runOriginalID.size();) {
@@ -245,19 +459,34 @@ uint32_t Manifold::reserve_ids(uint32_t p_count) {
 }
 
 Ref<Manifold> Manifold::translate(Vector3 p_offset) const {
-	return memnew(Manifold(_inner->_manifold.Translate(to_vec3(p_offset))));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.translate", _get_content_hash(), p_offset);
+	},
+			[&]() { return _inner->_manifold.Translate(to_vec3(p_offset)); });
 }
 Ref<Manifold> Manifold::scale(Vector3 p_scale) const {
-	return memnew(Manifold(_inner->_manifold.Scale(to_vec3(p_scale))));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.scale", _get_content_hash(), p_scale);
+	},
+			[&]() { return _inner->_manifold.Scale(to_vec3(p_scale)); });
 }
 Ref<Manifold> Manifold::rotate(double p_x_degrees, double p_y_degrees, double p_z_degrees) const {
-	return memnew(Manifold(_inner->_manifold.Rotate(p_x_degrees, p_y_degrees, p_z_degrees)));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.rotate", _get_content_hash(), p_x_degrees, p_y_degrees, p_z_degrees);
+	},
+			[&]() { return _inner->_manifold.Rotate(p_x_degrees, p_y_degrees, p_z_degrees); });
 }
 Ref<Manifold> Manifold::mirror(Vector3 p_axis) const {
-	return memnew(Manifold(_inner->_manifold.Mirror(to_vec3(p_axis))));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.mirror", _get_content_hash(), p_axis);
+	},
+			[&]() { return _inner->_manifold.Mirror(to_vec3(p_axis)); });
 }
 Ref<Manifold> Manifold::transform(const Transform3D &p_transform) const {
-	return memnew(Manifold(_inner->_manifold.Transform(to_mat3x4(p_transform))));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.transform", _get_content_hash(), p_transform);
+	},
+			[&]() { return _inner->_manifold.Transform(to_mat3x4(p_transform)); });
 }
 Ref<Manifold> Manifold::warp_bind(const Callable &p_func) const {
 	return warp([p_func](Vector3 p_coord) -> Vector3 {
@@ -268,43 +497,71 @@ Ref<Manifold> Manifold::warp(const std::function<Vector3(Vector3)> &p_func) cons
 	const auto func = [p_func](manifold::vec3 &p_coord) -> void {
 		p_coord = to_vec3(p_func(from_vec3(p_coord)));
 	};
-	return memnew(Manifold(_inner->_manifold.Warp(func)));
+	return memnew(Manifold(_inner->evaluated().Warp(func)));
 }
 Ref<Manifold> Manifold::set_tolerance(double p_tolerance) const {
-	return memnew(Manifold(_inner->_manifold.SetTolerance(p_tolerance)));
+	return memnew(Manifold(_inner->evaluated().SetTolerance(p_tolerance)));
 }
 Ref<Manifold> Manifold::simplify(double p_tolerance) const {
-	return memnew(Manifold(_inner->_manifold.Simplify(p_tolerance)));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.simplify", _get_content_hash(), p_tolerance);
+	},
+			[&]() { return _inner->evaluated().Simplify(p_tolerance); });
 }
 
 Ref<Manifold> Manifold::union_with(const Ref<Manifold> &p_second) const {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	ERR_FAIL_NULL_V(*p_second, const_cast<Manifold *>(this));
-	return memnew(Manifold(_inner->_manifold.Boolean(p_second->_inner->_manifold, manifold::OpType::Add)));
+	return _cached_result({ this, p_second.ptr() }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.union_with", _get_content_hash(), p_second->_get_content_hash());
+	},
+			[&]() { return _inner->_manifold.Boolean(p_second->_inner->_manifold, manifold::OpType::Add); });
 }
 Ref<Manifold> Manifold::union_batch(const TypedArray<Manifold> &p_manifolds) {
-	return memnew(Manifold(manifold::Manifold::BatchBoolean(Inner::to_manifold_vec(p_manifolds), manifold::OpType::Add)));
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
+	return _cached_result(Inner::operands(p_manifolds), [&](ManifoldHasher &r_key) {
+		Inner::add_content_hashes(r_key, "Manifold.union_batch", p_manifolds);
+	},
+			[&]() { return manifold::Manifold::BatchBoolean(Inner::to_manifold_vec(p_manifolds), manifold::OpType::Add); });
 }
 Ref<Manifold> Manifold::intersection_with(const Ref<Manifold> &p_second) const {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	ERR_FAIL_NULL_V(*p_second, const_cast<Manifold *>(this));
-	return memnew(Manifold(_inner->_manifold.Boolean(p_second->_inner->_manifold, manifold::OpType::Intersect)));
+	return _cached_result({ this, p_second.ptr() }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.intersection_with", _get_content_hash(), p_second->_get_content_hash());
+	},
+			[&]() { return _inner->_manifold.Boolean(p_second->_inner->_manifold, manifold::OpType::Intersect); });
 }
 Ref<Manifold> Manifold::intersection_batch(const TypedArray<Manifold> &p_manifolds) {
-	return memnew(Manifold(manifold::Manifold::BatchBoolean(Inner::to_manifold_vec(p_manifolds), manifold::OpType::Intersect)));
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
+	return _cached_result(Inner::operands(p_manifolds), [&](ManifoldHasher &r_key) {
+		Inner::add_content_hashes(r_key, "Manifold.intersection_batch", p_manifolds);
+	},
+			[&]() { return manifold::Manifold::BatchBoolean(Inner::to_manifold_vec(p_manifolds), manifold::OpType::Intersect); });
 }
 Ref<Manifold> Manifold::difference_with(const Ref<Manifold> &p_second) const {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	ERR_FAIL_NULL_V(*p_second, const_cast<Manifold *>(this));
-	return memnew(Manifold(_inner->_manifold.Boolean(p_second->_inner->_manifold, manifold::OpType::Subtract)));
+	return _cached_result({ this, p_second.ptr() }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.difference_with", _get_content_hash(), p_second->_get_content_hash());
+	},
+			[&]() { return _inner->_manifold.Boolean(p_second->_inner->_manifold, manifold::OpType::Subtract); });
 }
 Ref<Manifold> Manifold::difference_batch(const TypedArray<Manifold> &p_manifolds) {
-	return memnew(Manifold(manifold::Manifold::BatchBoolean(Inner::to_manifold_vec(p_manifolds), manifold::OpType::Subtract)));
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
+	return _cached_result(Inner::operands(p_manifolds), [&](ManifoldHasher &r_key) {
+		Inner::add_content_hashes(r_key, "Manifold.difference_batch", p_manifolds);
+	},
+			[&]() { return manifold::Manifold::BatchBoolean(Inner::to_manifold_vec(p_manifolds), manifold::OpType::Subtract); });
 }
 TypedArray<Manifold> Manifold::split_bind(const Ref<Manifold> &p_manifold) const {
 	const Pair<Ref<Manifold>, Ref<Manifold>> s = split(p_manifold);
 	return Array::make(s.first, s.second);
 }
 Pair<Ref<Manifold>, Ref<Manifold>> Manifold::split(const Ref<Manifold> &p_manifold) const {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	ERR_FAIL_NULL_V(*p_manifold, {});
-	const std::pair<manifold::Manifold, manifold::Manifold> s = _inner->_manifold.Split(p_manifold->_inner->_manifold);
+	const std::pair<manifold::Manifold, manifold::Manifold> s = _inner->evaluated().Split(p_manifold->_inner->evaluated());
 	return { memnew(Manifold(s.first)), memnew(Manifold(s.second)) };
 }
 TypedArray<Manifold> Manifold::split_by_plane_bind(Plane p_plane) const {
@@ -312,11 +569,15 @@ TypedArray<Manifold> Manifold::split_by_plane_bind(Plane p_plane) const {
 	return Array::make(s.first, s.second);
 }
 Pair<Ref<Manifold>, Ref<Manifold>> Manifold::split_by_plane(Plane p_plane) const {
-	const std::pair<manifold::Manifold, manifold::Manifold> s = _inner->_manifold.SplitByPlane(to_vec3(p_plane.normal), p_plane.d);
+	const std::pair<manifold::Manifold, manifold::Manifold> s = _inner->evaluated().SplitByPlane(to_vec3(p_plane.normal), p_plane.d);
 	return { memnew(Manifold(s.first)), memnew(Manifold(s.second)) };
 }
 Ref<Manifold> Manifold::trim_by_plane(Plane p_plane) const {
-	return memnew(Manifold(_inner->_manifold.TrimByPlane(to_vec3(p_plane.normal), p_plane.d)));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.trim_by_plane", _get_content_hash(), p_plane);
+	},
+			[&]() { return _inner->evaluated().TrimByPlane(to_vec3(p_plane.normal), p_plane.d); },
+			true);
 }
 
 Ref<Manifold> Manifold::set_properties_bind(int p_num_prop, const Callable &p_prop_func) const {
@@ -326,43 +587,60 @@ Ref<Manifold> Manifold::set_properties_bind(int p_num_prop, const Callable &p_pr
 }
 Ref<Manifold> Manifold::set_properties(int p_num_prop, const std::function<PackedFloat64Array(Vector3, const PackedFloat64Array &)> &p_prop_func) const {
 	PackedFloat64Array old_props;
-	const size_t num_old_props = _inner->_manifold.NumProp();
+	const size_t num_old_props = _inner->evaluated().NumProp();
 	old_props.resize(num_old_props);
 	const auto prop_func = [p_prop_func, p_num_prop, &old_props, num_old_props](double *p_new_props, manifold::vec3 p_coord, const double *p_old_props) -> void {
 		memcpy(old_props.ptrw(), p_old_props, sizeof(double) * num_old_props);
 		const PackedFloat64Array new_props = p_prop_func(from_vec3(p_coord), old_props);
 		memcpy(p_new_props, new_props.ptr(), sizeof(double) * Math::min(int(new_props.size()), p_num_prop));
 	};
-	return memnew(Manifold(_inner->_manifold.SetProperties(p_num_prop, prop_func)));
+	return memnew(Manifold(_inner->evaluated().SetProperties(p_num_prop, prop_func)));
 }
 Ref<Manifold> Manifold::calculate_curvature(int p_gaussian_idx, int p_mean_idx) const {
-	return memnew(Manifold(_inner->_manifold.CalculateCurvature(p_gaussian_idx, p_mean_idx)));
+	return memnew(Manifold(_inner->evaluated().CalculateCurvature(p_gaussian_idx, p_mean_idx)));
 }
 Ref<Manifold> Manifold::calculate_normals(int p_normal_idx, double p_min_sharp_angle) const {
-	return memnew(Manifold(_inner->_manifold.CalculateNormals(p_normal_idx, p_min_sharp_angle)));
+	return memnew(Manifold(_inner->evaluated().CalculateNormals(p_normal_idx, p_min_sharp_angle)));
 }
 
 Ref<Manifold> Manifold::refine(int p_splits) const {
-	return memnew(Manifold(_inner->_manifold.Refine(p_splits)));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.refine", _get_content_hash(), uint64_t(p_splits));
+	},
+			[&]() { return _inner->evaluated().Refine(p_splits); });
 }
 Ref<Manifold> Manifold::refine_to_length(double p_length) const {
-	return memnew(Manifold(_inner->_manifold.RefineToLength(p_length)));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.refine_to_length", _get_content_hash(), p_length);
+	},
+			[&]() { return _inner->evaluated().RefineToLength(p_length); });
 }
 Ref<Manifold> Manifold::refine_to_tolerance(double p_tolerance) const {
-	return memnew(Manifold(_inner->_manifold.RefineToTolerance(p_tolerance)));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.refine_to_tolerance", _get_content_hash(), p_tolerance);
+	},
+			[&]() { return _inner->evaluated().RefineToTolerance(p_tolerance); });
 }
 Ref<Manifold> Manifold::smooth_by_normals(int p_normal_idx) const {
-	return memnew(Manifold(_inner->_manifold.SmoothByNormals(p_normal_idx)));
+	return memnew(Manifold(_inner->evaluated().SmoothByNormals(p_normal_idx)));
 }
 Ref<Manifold> Manifold::smooth_out(double p_min_sharp_angle, double p_min_smoothness) const {
-	return memnew(Manifold(_inner->_manifold.SmoothOut(p_min_sharp_angle, p_min_smoothness)));
+	return memnew(Manifold(_inner->evaluated().SmoothOut(p_min_sharp_angle, p_min_smoothness)));
 }
 
 Ref<Manifold> Manifold::hull() const {
-	return memnew(Manifold(_inner->_manifold.Hull()));
+	return _cached_result({ this }, [&](ManifoldHasher &r_key) {
+		r_key.add_all("Manifold.hull", _get_content_hash());
+	},
+			[&]() { return _inner->evaluated().Hull(); },
+			true);
 }
 Ref<Manifold> Manifold::hull_batch(const TypedArray<Manifold> &p_manifolds) {
-	return memnew(Manifold(manifold::Manifold::Hull(Inner::to_manifold_vec(p_manifolds))));
+	return _cached_result(Inner::operands(p_manifolds), [&](ManifoldHasher &r_key) {
+		Inner::add_content_hashes(r_key, "Manifold.hull_batch", p_manifolds);
+	},
+			[&]() { return manifold::Manifold::Hull(Inner::to_manifold_vec(p_manifolds)); },
+			true);
 }
 Ref<Manifold> Manifold::hull_points(const PackedVector3Array &p_points) {
 	std::vector<manifold::vec3> points;
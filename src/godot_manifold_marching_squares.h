@@ -0,0 +1,136 @@
+#pragma once
+
+#include <manifold/common.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Marching squares over a grid of samples, traced in bands of rows that can run on separate
+// threads, then stitched into closed contours. Samples sit at pixel centres and the grid is
+// surrounded by samples that are outside, so every contour closes; a fully covered image gives
+// (nearly, the corners are cut) the rectangle from (0, 0) to (width, height). Every contour keeps
+// the covered side on the same hand, so outlines and holes wind opposite ways and a non-zero fill
+// rule sorts them out.
+//
+// A crossing is identified by the grid edge it lies on, which is what lets the segments of
+// different bands be joined exactly.
+struct MarchingSquaresSegment {
+	uint64_t from;
+	uint64_t to;
+	manifold::vec2 position;
+};
+
+// p_value(x, y) returns the sample at (x, y), for x in [0, p_width) and y in [0, p_height). Cells are
+// numbered from -1, so cell (x, y) spans samples x and x + 1 horizontally, and y and y + 1
+// vertically; a band covers cell rows [p_first_row, p_end_row).
+template <typename Value>
+void marching_squares_band(int32_t p_width, int32_t p_height, float p_threshold, int32_t p_first_row, int32_t p_end_row, const Value &p_value, std::vector<MarchingSquaresSegment> &r_segments) {
+	const auto sample = [&](int32_t p_x, int32_t p_y) -> float {
+		return p_x < 0 || p_y < 0 || p_x >= p_width || p_y >= p_height ? 0.0f : p_value(p_x, p_y);
+	};
+	// keys count from the padding sample at -1; horizontal edges are even, vertical ones odd
+	const uint64_t row_stride = uint64_t(p_width) + 2;
+	const auto horizontal = [&](int32_t p_x, int32_t p_y) -> uint64_t {
+		return ((uint64_t(p_y + 1) * row_stride + uint64_t(p_x + 1)) << 1);
+	};
+	const auto vertical = [&](int32_t p_x, int32_t p_y) -> uint64_t {
+		return ((uint64_t(p_y + 1) * row_stride + uint64_t(p_x + 1)) << 1) | 1;
+	};
+	const auto crossing = [&](float p_a, float p_b, const manifold::vec2 &p_from, const manifold::vec2 &p_to) -> manifold::vec2 {
+		const double t = std::clamp(double(p_threshold - p_a) / double(p_b - p_a), 0.0, 1.0);
+		return p_from + (p_to - p_from) * t;
+	};
+
+	std::vector<float> above(p_width + 2);
+	std::vector<float> below(p_width + 2);
+	for (int32_t x = -1; x <= p_width; x++) {
+		below[x + 1] = sample(x, p_first_row);
+	}
+	for (int32_t y = p_first_row; y < p_end_row; y++) {
+		std::swap(above, below);
+		for (int32_t x = -1; x <= p_width; x++) {
+			below[x + 1] = sample(x, y + 1);
+		}
+
+		for (int32_t x = -1; x < p_width; x++) {
+			// corners clockwise from the top left, as the image shows them
+			const float values[4] = { above[x + 1], above[x + 2], below[x + 2], below[x + 1] };
+			const bool inside[4] = { values[0] > p_threshold, values[1] > p_threshold, values[2] > p_threshold, values[3] > p_threshold };
+			if (inside[0] == inside[1] && inside[1] == inside[2] && inside[2] == inside[3]) {
+				continue;
+			}
+
+			const manifold::vec2 corners[4] = {
+				manifold::vec2(x + 0.5, y + 0.5),
+				manifold::vec2(x + 1.5, y + 0.5),
+				manifold::vec2(x + 1.5, y + 1.5),
+				manifold::vec2(x + 0.5, y + 1.5),
+			};
+			const uint64_t edges[4] = { horizontal(x, y), vertical(x + 1, y), horizontal(x, y + 1), vertical(x, y) };
+
+			// the crossings met walking clockwise round the cell; each leaves or enters the covered area
+			struct Crossing {
+				uint64_t edge;
+				manifold::vec2 position;
+				bool leaving;
+			};
+			Crossing crossings[4];
+			int32_t count = 0;
+			for (int32_t side = 0; side < 4; side++) {
+				const int32_t next = (side + 1) % 4;
+				if (inside[side] != inside[next]) {
+					crossings[count++] = { edges[side], crossing(values[side], values[next], corners[side], corners[next]), inside[side] };
+				}
+			}
+
+			// a segment always runs from where the walk leaves the covered area to where it enters it;
+			// at a saddle the middle decides whether the covered corners join up, which pairs each
+			// leaving crossing with the entering one after it rather than the one before it
+			const int32_t first_leaving = crossings[0].leaving ? 0 : 1;
+			const bool joined = count == 4 && (values[0] + values[1] + values[2] + values[3]) * 0.25f > p_threshold;
+			for (int32_t i = first_leaving; i < count; i += 2) {
+				const Crossing &leaving = crossings[i];
+				const Crossing &entering = crossings[(count == 2 || joined) ? (i + 1) % count : (i + count - 1) % count];
+				r_segments.push_back({ leaving.edge, entering.edge, leaving.position });
+			}
+		}
+	}
+}
+
+// Joins the segments of every band into contours.
+static inline manifold::Polygons stitch_marching_squares(const std::vector<std::vector<MarchingSquaresSegment>> &p_bands) {
+	std::unordered_map<uint64_t, const MarchingSquaresSegment *> segment_from;
+	size_t count = 0;
+	for (const std::vector<MarchingSquaresSegment> &band : p_bands) {
+		count += band.size();
+	}
+	segment_from.reserve(count);
+	for (const std::vector<MarchingSquaresSegment> &band : p_bands) {
+		for (const MarchingSquaresSegment &segment : band) {
+			segment_from.emplace(segment.from, &segment);
+		}
+	}
+
+	manifold::Polygons polygons;
+	for (const std::vector<MarchingSquaresSegment> &band : p_bands) {
+		for (const MarchingSquaresSegment &start : band) {
+			if (!segment_from.count(start.from)) {
+				continue;
+			}
+			manifold::SimplePolygon polygon;
+			const MarchingSquaresSegment *segment = &start;
+			while (segment) {
+				polygon.push_back(segment->position);
+				segment_from.erase(segment->from);
+				const auto next = segment_from.find(segment->to);
+				segment = next != segment_from.end() ? next->second : nullptr;
+			}
+			if (polygon.size() >= 3) {
+				polygons.push_back(std::move(polygon));
+			}
+		}
+	}
+	return polygons;
+}
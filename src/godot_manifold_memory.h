@@ -0,0 +1,77 @@
+#pragma once
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/variant.hpp>
+
+#include <manifold/manifold.h>
+
+// Byte counts for the representations a mesh can be held in. Vectors are counted by capacity,
+// since that is what is actually allocated; the manifold::Manifold internals are not exposed, so
+// that one is an estimate from its element counts.
+
+static inline uint64_t memory_of_arrays(const godot::Array &p_arrays) {
+	using namespace godot;
+
+	uint64_t bytes = 0;
+	for (int64_t i = 0; i < p_arrays.size(); i++) {
+		const Variant &array = p_arrays[i];
+		switch (array.get_type()) {
+			case Variant::PACKED_BYTE_ARRAY:
+				bytes += PackedByteArray(array).size();
+				break;
+			case Variant::PACKED_INT32_ARRAY:
+				bytes += PackedInt32Array(array).size() * sizeof(int32_t);
+				break;
+			case Variant::PACKED_FLOAT32_ARRAY:
+				bytes += PackedFloat32Array(array).size() * sizeof(float);
+				break;
+			case Variant::PACKED_FLOAT64_ARRAY:
+				bytes += PackedFloat64Array(array).size() * sizeof(double);
+				break;
+			case Variant::PACKED_VECTOR2_ARRAY:
+				bytes += PackedVector2Array(array).size() * sizeof(Vector2);
+				break;
+			case Variant::PACKED_VECTOR3_ARRAY:
+				bytes += PackedVector3Array(array).size() * sizeof(Vector3);
+				break;
+			case Variant::PACKED_COLOR_ARRAY:
+				bytes += PackedColorArray(array).size() * sizeof(Color);
+				break;
+			default:
+				break;
+		}
+	}
+
+	return bytes;
+}
+
+template <typename T>
+static inline uint64_t memory_of_vector(const std::vector<T> &p_vector) {
+	return p_vector.capacity() * sizeof(T);
+}
+
+template <typename Precision, typename I>
+static inline uint64_t memory_of_meshgl(const manifold::MeshGLP<Precision, I> &p_mesh) {
+	return memory_of_vector(p_mesh.vertProperties) +
+			memory_of_vector(p_mesh.triVerts) +
+			memory_of_vector(p_mesh.mergeFromVert) +
+			memory_of_vector(p_mesh.mergeToVert) +
+			memory_of_vector(p_mesh.runIndex) +
+			memory_of_vector(p_mesh.runOriginalID) +
+			memory_of_vector(p_mesh.runTransform) +
+			memory_of_vector(p_mesh.faceID) +
+			memory_of_vector(p_mesh.halfedgeTangent);
+}
+
+static inline uint64_t memory_of_manifold(const manifold::Manifold &p_manifold) {
+	// per vertex: position and normal (2 x vec3)
+	// per triangle: three halfedges (4 ints each), three tangents (vec4), face normal, TriRef and
+	// roughly two collider BVH boxes
+	// per property vertex: NumProp doubles
+	constexpr uint64_t vert_bytes = 2 * 3 * sizeof(double);
+	constexpr uint64_t tri_bytes = 3 * 4 * sizeof(int) + 3 * 4 * sizeof(double) + 3 * sizeof(double) + 4 * sizeof(int) + 2 * 6 * sizeof(double);
+
+	return p_manifold.NumVert() * vert_bytes +
+			p_manifold.NumTri() * tri_bytes +
+			p_manifold.NumPropVert() * p_manifold.NumProp() * sizeof(double);
+}
@@ -1,21 +1,46 @@
+#include "godot_manifold_cache.h"
 #include "godot_manifold_converters.h"
+#include "godot_manifold_convex_partition.h"
 #include "godot_manifold_defs.h"
+#include "godot_manifold_export.h"
+#include "godot_manifold_import.h"
+#include "godot_manifold_memory.h"
+#include "godot_manifold_navigation.h"
+#include "godot_manifold_profiler.h"
+#include "godot_manifold_slice.h"
+#include "godot_manifold_vertex_cache.h"
 
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
 #include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
 
 #include <godot_cpp/classes/array_mesh.hpp>
 #include <godot_cpp/classes/importer_mesh.hpp>
+#include <godot_cpp/classes/navigation_mesh.hpp>
 #include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/classes/standard_material3d.hpp>
 #include <godot_cpp/classes/surface_tool.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 
+#include <manifold/cross_section.h>
 #include <manifold/manifold.h>
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
 using namespace godot;
 
 const static uint32_t NULL_MATERIAL_ORIGINAL_ID = manifold::Manifold::ReserveIDs(1);
 static HashMap<ObjectID, uint32_t> material_original_id;
+static uint32_t material_original_id_sweep_size = 64;
+
+// every live ManifoldMesh, so get_total_memory_usage can sum them
+static std::mutex live_meshes_mutex;
+static HashSet<const ManifoldMesh *> live_meshes;
 
 uint32_t ManifoldMesh::get_material_original_id(const Ref<Material> &p_material) {
 	if (unlikely(p_material.is_null())) {
@@ -27,12 +52,16 @@ uint32_t ManifoldMesh::get_material_original_id(const Ref<Material> &p_material)
 		return material_original_id.get(object_id);
 	}
 
-	// clean up any deleted materials
-	for (auto it = material_original_id.begin(), next = it; it; it = next) {
-		++next;
-		if (unlikely(!ObjectDB::get_instance(it->key))) {
-			material_original_id.remove(it);
+	// clean up any deleted materials, but only once the map has doubled since the last sweep so that
+	// a run of new materials stays amortized constant time
+	if (unlikely(material_original_id.size() >= material_original_id_sweep_size)) {
+		for (auto it = material_original_id.begin(), next = it; it; it = next) {
+			++next;
+			if (unlikely(!ObjectDB::get_instance(it->key))) {
+				material_original_id.remove(it);
+			}
 		}
+		material_original_id_sweep_size = MAX(64u, material_original_id.size() * 2);
 	}
 
 	const uint32_t original_id = manifold::Manifold::ReserveIDs(1);
@@ -40,6 +69,24 @@ uint32_t ManifoldMesh::get_material_original_id(const Ref<Material> &p_material)
 	return original_id;
 }
 
+// materials loaded from a file are keyed by path; anything else only lives as long as this process
+static void add_material_key(ManifoldHasher &r_key, const Ref<Material> &p_material) {
+	if (p_material.is_null()) {
+		r_key.add(uint64_t(0));
+		return;
+	}
+
+	const String path = p_material->get_path();
+	if (path.is_empty() || path.contains("::")) {
+		r_key.add(p_material->get_instance_id());
+		r_key.mark_transient();
+		return;
+	}
+
+	const CharString utf8 = path.utf8();
+	r_key.add_bytes(utf8.get_data(), utf8.length());
+}
+
 void ManifoldMesh::_bind_methods() {
 	DEV_ASSERT(NULL_MATERIAL_ORIGINAL_ID == 1);
 
@@ -61,6 +108,24 @@ void ManifoldMesh::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_STRING_ARRAY, "surface_names"), "set_surface_names", "get_surface_names");
 
 	ADD_GROUP("", "");
+	ClassDB::bind_method(D_METHOD("set_retention_policy", "retention_policy"), &ManifoldMesh::set_retention_policy);
+	ClassDB::bind_method(D_METHOD("get_retention_policy"), &ManifoldMesh::get_retention_policy);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "retention_policy", PROPERTY_HINT_ENUM, "All,Geometry Only,Render Only"), "set_retention_policy", "get_retention_policy");
+	ClassDB::bind_method(D_METHOD("set_generate_lods", "generate_lods"), &ManifoldMesh::set_generate_lods);
+	ClassDB::bind_method(D_METHOD("get_generate_lods"), &ManifoldMesh::get_generate_lods);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "generate_lods"), "set_generate_lods", "get_generate_lods");
+	ClassDB::bind_method(D_METHOD("set_create_shadow_mesh", "create_shadow_mesh"), &ManifoldMesh::set_create_shadow_mesh);
+	ClassDB::bind_method(D_METHOD("get_create_shadow_mesh"), &ManifoldMesh::get_create_shadow_mesh);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "create_shadow_mesh"), "set_create_shadow_mesh", "get_create_shadow_mesh");
+	ClassDB::bind_method(D_METHOD("set_optimize_vertex_cache", "optimize_vertex_cache"), &ManifoldMesh::set_optimize_vertex_cache);
+	ClassDB::bind_method(D_METHOD("get_optimize_vertex_cache"), &ManifoldMesh::get_optimize_vertex_cache);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "optimize_vertex_cache"), "set_optimize_vertex_cache", "get_optimize_vertex_cache");
+	ClassDB::bind_method(D_METHOD("get_vertex_cache_statistics"), &ManifoldMesh::get_vertex_cache_statistics);
+
+	BIND_ENUM_CONSTANT(RETAIN_ALL);
+	BIND_ENUM_CONSTANT(RETAIN_GEOMETRY_ONLY);
+	BIND_ENUM_CONSTANT(RETAIN_RENDER_ONLY);
+
 	ClassDB::bind_method(D_METHOD("is_valid"), &ManifoldMesh::is_valid);
 	ClassDB::bind_method(D_METHOD("is_empty"), &ManifoldMesh::is_empty);
 	ClassDB::bind_method(D_METHOD("remove_unused_materials"), &ManifoldMesh::remove_unused_materials);
@@ -88,6 +153,7 @@ void ManifoldMesh::_bind_methods() {
 
 	ADD_GROUP("", "");
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("from_mesh", "mesh"), &ManifoldMesh::from_mesh);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("import_from_file", "path", "weld_tolerance"), &ManifoldMesh::import_from_file, DEFVAL(0.0));
 	ClassDB::bind_method(D_METHOD("to_mesh", "generate_lods", "create_shadow_mesh", "skip_material"), &ManifoldMesh::to_mesh, DEFVAL(true), DEFVAL(true), DEFVAL(TypedArray<Material>()));
 
 	ClassDB::bind_method(D_METHOD("decompose"), &ManifoldMesh::decompose);
@@ -98,9 +164,19 @@ void ManifoldMesh::_bind_methods() {
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("level_set", "sdf", "bounds", "edge_length", "level", "tolerance", "material"), &ManifoldMesh::level_set, DEFVAL(0.0), DEFVAL(-1.0), DEFVAL(nullptr));
 
 	ClassDB::bind_method(D_METHOD("slice", "height"), &ManifoldMesh::slice, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("slice_many", "heights"), &ManifoldMesh::slice_many);
 	ClassDB::bind_method(D_METHOD("project"), &ManifoldMesh::project);
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("extrude", "cross_section", "height", "divisions", "twist_degrees", "scale_top", "material"), &ManifoldMesh::extrude, DEFVAL(0), DEFVAL(0.0), DEFVAL(Vector2(1.0f, 1.0f)), DEFVAL(nullptr));
 	ClassDB::bind_static_method(get_class_static(), D_METHOD("revolve", "cross_section", "circular_segments", "revolve_degrees", "material"), &ManifoldMesh::revolve, DEFVAL(0), DEFVAL(360.0), DEFVAL(nullptr));
+	ClassDB::bind_method(D_METHOD("slice_cross_section", "height"), &ManifoldMesh::slice_cross_section, DEFVAL(0.0));
+	ClassDB::bind_method(D_METHOD("project_cross_section"), &ManifoldMesh::project_cross_section);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("extrude_cross_section", "cross_section", "height", "divisions", "twist_degrees", "scale_top", "material"), &ManifoldMesh::extrude_cross_section, DEFVAL(0), DEFVAL(0.0), DEFVAL(Vector2(1.0f, 1.0f)), DEFVAL(nullptr));
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("revolve_cross_section", "cross_section", "circular_segments", "revolve_degrees", "material"), &ManifoldMesh::revolve_cross_section, DEFVAL(0), DEFVAL(360.0), DEFVAL(nullptr));
+	ClassDB::bind_method(D_METHOD("to_navigation_mesh", "agent_height", "agent_radius", "max_slope", "region"), &ManifoldMesh::to_navigation_mesh, DEFVAL(1.5), DEFVAL(0.5), DEFVAL(45.0), DEFVAL(AABB()));
+
+	ClassDB::bind_method(D_METHOD("export_to_file", "path"), &ManifoldMesh::export_to_file);
+	ClassDB::bind_method(D_METHOD("export_to_file_async", "path"), &ManifoldMesh::export_to_file_async);
+	ADD_SIGNAL(MethodInfo("export_finished", PropertyInfo(Variant::STRING, "path"), PropertyInfo(Variant::INT, "error")));
 
 	ClassDB::bind_method(D_METHOD("get_vertex_count"), &ManifoldMesh::get_vertex_count);
 	ClassDB::bind_method(D_METHOD("get_edge_count"), &ManifoldMesh::get_edge_count);
@@ -148,27 +224,153 @@ void ManifoldMesh::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("modify_custom3", "modify"), &ManifoldMesh::modify_custom3);
 }
 
+// A MeshGL that async exports and cached duplicates can hold on to while the owner moves on:
+// assigning installs a new mesh, and writing to one that is shared copies it first.
+template <typename Mesh>
+class SharedMeshGL {
+	std::shared_ptr<Mesh> _mesh = std::make_shared<Mesh>();
+
+public:
+	SharedMeshGL &operator=(Mesh &&p_mesh) {
+		_mesh = std::make_shared<Mesh>(std::move(p_mesh));
+		return *this;
+	}
+
+	const Mesh &operator*() const { return *_mesh; }
+	const Mesh *operator->() const { return _mesh.get(); }
+	Mesh &write() {
+		if (_mesh.use_count() > 1) {
+			_mesh = std::make_shared<Mesh>(*_mesh);
+		}
+		return *_mesh;
+	}
+	std::shared_ptr<const Mesh> share() const { return _mesh; }
+};
+
 struct ManifoldMesh::Inner {
 	manifold::Manifold _manifold;
-	manifold::MeshGLP<Precision, I> _meshgl;
+	SharedMeshGL<manifold::MeshGLP<Precision, I>> _meshgl;
 	bool _manifold_dirty = false;
 	bool _meshgl_dirty = false;
 	bool _has_bad_original_ids = true;
 	bool _rid_dirty = true;
+	// _meshgl was thrown away by the retention policy, not invalidated by an edit
+	bool _meshgl_dropped = false;
 
 	Vector<Array> _arrays;
+	// the property vertex behind each vertex of _arrays
+	LocalVector<LocalVector<uint32_t>> _array_vertices;
+	// index buffers into _arrays, so they are thrown away whenever those are rebuilt
+	Vector<Dictionary> _lods;
+	// position-only copies of _arrays, welded across property seams, and the shadow vertex each
+	// _arrays vertex became (to carry the LOD index buffers over)
+	Vector<Array> _shadow_arrays;
+	Vector<PackedInt32Array> _shadow_remap;
 	RID _rid;
+	RID _shadow_rid;
+	uint64_t _rid_bytes = 0;
+
+	ManifoldCacheKey _content_hash;
+	bool _has_content_hash = false;
+	// a cache miss that goes into the cache once its MeshGL is built; see _cached_result
+	bool _pending_store = false;
+
+	// post-transform cache misses of the emitted index buffers, before and after they were reordered
+	struct VertexCacheStatistics {
+		uint64_t triangles = 0;
+		uint64_t vertices = 0;
+		uint64_t misses_before = 0;
+		uint64_t misses_after = 0;
+
+		Dictionary to_dictionary() const {
+			Dictionary statistics;
+			statistics["triangles"] = triangles;
+			statistics["vertices"] = vertices;
+			statistics["acmr_before"] = triangles ? double(misses_before) / triangles : 0.0;
+			statistics["acmr_after"] = triangles ? double(misses_after) / triangles : 0.0;
+			statistics["atvr_before"] = vertices ? double(misses_before) / vertices : 0.0;
+			statistics["atvr_after"] = vertices ? double(misses_after) / vertices : 0.0;
+			return statistics;
+		}
+	};
+	VertexCacheStatistics _vertex_cache_statistics;
+
+	struct MemoryUsage {
+		uint64_t manifold = 0;
+		uint64_t meshgl = 0;
+		uint64_t arrays = 0;
+		uint64_t rendering_server = 0;
+
+		void add(const MemoryUsage &p_other) {
+			manifold += p_other.manifold;
+			meshgl += p_other.meshgl;
+			arrays += p_other.arrays;
+			rendering_server += p_other.rendering_server;
+		}
+
+		Dictionary to_dictionary() const {
+			Dictionary usage;
+			usage["manifold"] = manifold;
+			usage["meshgl"] = meshgl;
+			usage["arrays"] = arrays;
+			usage["rendering_server"] = rendering_server;
+			usage["total"] = manifold + meshgl + arrays + rendering_server;
+			return usage;
+		}
+	};
+
+	MemoryUsage get_memory_usage() const {
+		MemoryUsage usage;
+
+		// don't force a lazy boolean just to measure it: until a meshgl has been generated from the
+		// manifold (even one that was dropped since), it may still be an unevaluated CSG tree
+		if (!_manifold_dirty && (!_meshgl_dirty || _meshgl_dropped)) {
+			usage.manifold = memory_of_manifold(_manifold);
+		}
+		usage.meshgl = memory_of_meshgl(*_meshgl);
+		for (const Array &arrays : _arrays) {
+			usage.arrays += memory_of_arrays(arrays);
+		}
+		for (const LocalVector<uint32_t> &vertices : _array_vertices) {
+			usage.arrays += vertices.size() * sizeof(uint32_t);
+		}
+		for (const Dictionary &lods : _lods) {
+			usage.arrays += memory_of_arrays(lods.values());
+		}
+		for (const Array &arrays : _shadow_arrays) {
+			usage.arrays += memory_of_arrays(arrays);
+		}
+		for (const PackedInt32Array &remap : _shadow_remap) {
+			usage.arrays += remap.size() * sizeof(int32_t);
+		}
+		if (_rid.is_valid()) {
+			usage.rendering_server = _rid_bytes;
+		}
+
+		return usage;
+	}
 };
 
 ManifoldMesh::ManifoldMesh() {
 	_inner = memnew(Inner);
+
+	std::lock_guard<std::mutex> lock(live_meshes_mutex);
+	live_meshes.insert(this);
 }
 
 ManifoldMesh::~ManifoldMesh() {
+	{
+		std::lock_guard<std::mutex> lock(live_meshes_mutex);
+		live_meshes.erase(this);
+	}
+
 	if (unlikely(_inner->_rid.is_valid())) {
 		RenderingServer *rs = RenderingServer::get_singleton();
 		if (likely(rs)) {
 			rs->free_rid(_inner->_rid);
+			if (_inner->_shadow_rid.is_valid()) {
+				rs->free_rid(_inner->_shadow_rid);
+			}
 		}
 	}
 
@@ -179,6 +381,7 @@ ManifoldMesh::~ManifoldMesh() {
 void ManifoldMesh::set_surface_formats(const PackedInt32Array &p_surface_formats) {
 	if (_surface_formats != p_surface_formats) {
 		_surface_formats = p_surface_formats;
+		_inner->_has_content_hash = false;
 		emit_changed();
 	}
 }
@@ -188,6 +391,7 @@ PackedInt32Array ManifoldMesh::get_surface_formats() const {
 void ManifoldMesh::set_surface_original_ids(const PackedInt32Array &p_surface_original_ids) {
 	if (_surface_original_ids != p_surface_original_ids) {
 		_surface_original_ids = p_surface_original_ids;
+		_inner->_has_content_hash = false;
 		emit_changed();
 	}
 }
@@ -197,6 +401,7 @@ PackedInt32Array ManifoldMesh::get_surface_original_ids() const {
 void ManifoldMesh::set_surface_materials(const TypedArray<Material> &p_surface_materials) {
 	if (_surface_materials != p_surface_materials) {
 		_surface_materials = p_surface_materials;
+		_inner->_has_content_hash = false;
 		emit_changed();
 	}
 }
@@ -206,12 +411,73 @@ TypedArray<Material> ManifoldMesh::get_surface_materials() const {
 void ManifoldMesh::set_surface_names(const PackedStringArray &p_surface_names) {
 	if (_surface_names != p_surface_names) {
 		_surface_names = p_surface_names;
+		_inner->_has_content_hash = false;
 		emit_changed();
 	}
 }
 PackedStringArray ManifoldMesh::get_surface_names() const {
 	return _surface_names;
 }
+void ManifoldMesh::set_retention_policy(RetentionPolicy p_retention_policy) {
+	ERR_FAIL_INDEX(p_retention_policy, RETAIN_RENDER_ONLY + 1);
+	_retention_policy = p_retention_policy;
+	if (_inner->_rid.is_valid() && !_inner->_rid_dirty) {
+		_apply_retention_policy();
+	}
+}
+ManifoldMesh::RetentionPolicy ManifoldMesh::get_retention_policy() const {
+	return _retention_policy;
+}
+void ManifoldMesh::set_generate_lods(bool p_generate_lods) {
+	if (_generate_lods != p_generate_lods) {
+		_generate_lods = p_generate_lods;
+		_inner->_rid_dirty = true;
+		emit_changed();
+	}
+}
+bool ManifoldMesh::get_generate_lods() const {
+	return _generate_lods;
+}
+void ManifoldMesh::set_create_shadow_mesh(bool p_create_shadow_mesh) {
+	if (_create_shadow_mesh != p_create_shadow_mesh) {
+		_create_shadow_mesh = p_create_shadow_mesh;
+		_inner->_rid_dirty = true;
+		emit_changed();
+	}
+}
+bool ManifoldMesh::get_create_shadow_mesh() const {
+	return _create_shadow_mesh;
+}
+void ManifoldMesh::set_optimize_vertex_cache(bool p_optimize_vertex_cache) {
+	if (_optimize_vertex_cache != p_optimize_vertex_cache) {
+		_optimize_vertex_cache = p_optimize_vertex_cache;
+		_inner->_arrays.clear();
+		_inner->_rid_dirty = true;
+		emit_changed();
+	}
+}
+bool ManifoldMesh::get_optimize_vertex_cache() const {
+	return _optimize_vertex_cache;
+}
+Dictionary ManifoldMesh::get_vertex_cache_statistics() const {
+	_commit_to_arrays();
+	return _inner->_vertex_cache_statistics.to_dictionary();
+}
+
+Dictionary ManifoldMesh::get_memory_usage() const {
+	return _inner->get_memory_usage().to_dictionary();
+}
+
+Dictionary ManifoldMesh::get_total_memory_usage() {
+	Inner::MemoryUsage total;
+
+	std::lock_guard<std::mutex> lock(live_meshes_mutex);
+	for (const ManifoldMesh *mesh : live_meshes) {
+		total.add(mesh->_inner->get_memory_usage());
+	}
+
+	return total.to_dictionary();
+}
 
 bool ManifoldMesh::is_valid() const {
 	_ensure_manifold();
@@ -238,32 +504,47 @@ void ManifoldMesh::remove_unused_materials() {
 		_surface_names.resize(_surface_original_ids.size());
 	}
 
-	bool any_removed = false;
+	HashSet<uint32_t> used_original_ids;
+	for (const uint32_t original_id : _inner->_meshgl->runOriginalID) {
+		used_original_ids.insert(original_id);
+	}
+
+	// compact the surviving surfaces in place rather than shifting the arrays once per removal
+	int32_t kept = 0;
 	for (int32_t i = 0; i < _surface_original_ids.size(); i++) {
-		const uint32_t original_id = _surface_original_ids[i];
-		if (std::find(_inner->_meshgl.runOriginalID.begin(), _inner->_meshgl.runOriginalID.end(), original_id) != _inner->_meshgl.runOriginalID.end()) {
+		if (!used_original_ids.has(_surface_original_ids[i])) {
 			continue;
 		}
 
-		_surface_formats.remove_at(i);
-		_surface_original_ids.remove_at(i);
-		_surface_materials.remove_at(i);
-		_surface_names.remove_at(i);
-		i--;
-		any_removed = true;
+		if (kept != i) {
+			_surface_formats.set(kept, _surface_formats[i]);
+			_surface_original_ids.set(kept, _surface_original_ids[i]);
+			_surface_materials[kept] = _surface_materials[i];
+			_surface_names.set(kept, _surface_names[i]);
+		}
+		kept++;
 	}
 
-	if (any_removed) {
+	if (kept != _surface_original_ids.size()) {
+		_surface_formats.resize(kept);
+		_surface_original_ids.resize(kept);
+		_surface_materials.resize(kept);
+		_surface_names.resize(kept);
+
 		_inner->_arrays.clear();
+		_inner->_rid_dirty = true;
+		_inner->_has_content_hash = false;
 		emit_changed();
 	}
 }
 
-#define SET_VALUE(m_prop, m_param)  \
-	_ensure_meshgl();               \
-	m_prop = m_param;               \
-	_inner->_manifold_dirty = true; \
-	_inner->_arrays.clear();        \
+#define SET_VALUE(m_prop, m_param)     \
+	_ensure_meshgl();                  \
+	m_prop = m_param;                  \
+	_inner->_manifold_dirty = true;    \
+	_inner->_arrays.clear();           \
+	_inner->_rid_dirty = true;         \
+	_inner->_has_content_hash = false; \
 	emit_changed()
 #define SET_ARRAY(m_prop, m_param)                                            \
 	_ensure_meshgl();                                                         \
@@ -272,6 +553,8 @@ void ManifoldMesh::remove_unused_materials() {
 	std::copy(m_param.ptr(), m_param.ptr() + m_param.size(), m_prop.begin()); \
 	_inner->_manifold_dirty = true;                                           \
 	_inner->_arrays.clear();                                                  \
+	_inner->_rid_dirty = true;                                                \
+	_inner->_has_content_hash = false;                                        \
 	emit_changed()
 
 #define GET_VALUE(m_prop) \
@@ -286,80 +569,80 @@ void ManifoldMesh::remove_unused_materials() {
 	return array
 
 void ManifoldMesh::set_num_prop(I p_num_prop) {
-	SET_VALUE(_inner->_meshgl.numProp, p_num_prop);
+	SET_VALUE(_inner->_meshgl.write().numProp, p_num_prop);
 }
 ManifoldMesh::I ManifoldMesh::get_num_prop() const {
-	GET_VALUE(_inner->_meshgl.numProp);
+	GET_VALUE(_inner->_meshgl->numProp);
 }
 
 void ManifoldMesh::set_vert_properties(const PackedRealArray &p_vert_properties) {
-	SET_ARRAY(_inner->_meshgl.vertProperties, p_vert_properties);
+	SET_ARRAY(_inner->_meshgl.write().vertProperties, p_vert_properties);
 }
 PackedRealArray ManifoldMesh::get_vert_properties() const {
-	GET_ARRAY(PackedRealArray, _inner->_meshgl.vertProperties);
+	GET_ARRAY(PackedRealArray, _inner->_meshgl->vertProperties);
 }
 
 void ManifoldMesh::set_tri_verts(const PackedIArray &p_tri_verts) {
-	SET_ARRAY(_inner->_meshgl.triVerts, p_tri_verts);
+	SET_ARRAY(_inner->_meshgl.write().triVerts, p_tri_verts);
 }
 ManifoldMesh::PackedIArray ManifoldMesh::get_tri_verts() const {
-	GET_ARRAY(PackedIArray, _inner->_meshgl.triVerts);
+	GET_ARRAY(PackedIArray, _inner->_meshgl->triVerts);
 }
 
 void ManifoldMesh::set_merge_from_vert(const PackedIArray &p_merge_from_vert) {
-	SET_ARRAY(_inner->_meshgl.mergeFromVert, p_merge_from_vert);
+	SET_ARRAY(_inner->_meshgl.write().mergeFromVert, p_merge_from_vert);
 }
 ManifoldMesh::PackedIArray ManifoldMesh::get_merge_from_vert() const {
-	GET_ARRAY(PackedIArray, _inner->_meshgl.mergeFromVert);
+	GET_ARRAY(PackedIArray, _inner->_meshgl->mergeFromVert);
 }
 
 void ManifoldMesh::set_merge_to_vert(const PackedIArray &p_merge_to_vert) {
-	SET_ARRAY(_inner->_meshgl.mergeToVert, p_merge_to_vert);
+	SET_ARRAY(_inner->_meshgl.write().mergeToVert, p_merge_to_vert);
 }
 ManifoldMesh::PackedIArray ManifoldMesh::get_merge_to_vert() const {
-	GET_ARRAY(PackedIArray, _inner->_meshgl.mergeToVert);
+	GET_ARRAY(PackedIArray, _inner->_meshgl->mergeToVert);
 }
 
 void ManifoldMesh::set_run_index(const PackedIArray &p_run_index) {
-	SET_ARRAY(_inner->_meshgl.runIndex, p_run_index);
+	SET_ARRAY(_inner->_meshgl.write().runIndex, p_run_index);
 }
 ManifoldMesh::PackedIArray ManifoldMesh::get_run_index() const {
-	GET_ARRAY(PackedIArray, _inner->_meshgl.runIndex);
+	GET_ARRAY(PackedIArray, _inner->_meshgl->runIndex);
 }
 
 void ManifoldMesh::set_run_original_id(const PackedInt32Array &p_run_original_id) {
-	SET_ARRAY(_inner->_meshgl.runOriginalID, p_run_original_id);
+	SET_ARRAY(_inner->_meshgl.write().runOriginalID, p_run_original_id);
 }
 PackedInt32Array ManifoldMesh::get_run_original_id() const {
-	GET_ARRAY(PackedInt32Array, _inner->_meshgl.runOriginalID);
+	GET_ARRAY(PackedInt32Array, _inner->_meshgl->runOriginalID);
 }
 
 void ManifoldMesh::set_run_transform(const PackedRealArray &p_run_transform) {
-	SET_ARRAY(_inner->_meshgl.runTransform, p_run_transform);
+	SET_ARRAY(_inner->_meshgl.write().runTransform, p_run_transform);
 }
 PackedRealArray ManifoldMesh::get_run_transform() const {
-	GET_ARRAY(PackedRealArray, _inner->_meshgl.runTransform);
+	GET_ARRAY(PackedRealArray, _inner->_meshgl->runTransform);
 }
 
 void ManifoldMesh::set_face_id(const PackedIArray &p_face_id) {
-	SET_ARRAY(_inner->_meshgl.faceID, p_face_id);
+	SET_ARRAY(_inner->_meshgl.write().faceID, p_face_id);
 }
 ManifoldMesh::PackedIArray ManifoldMesh::get_face_id() const {
-	GET_ARRAY(PackedIArray, _inner->_meshgl.faceID);
+	GET_ARRAY(PackedIArray, _inner->_meshgl->faceID);
 }
 
 void ManifoldMesh::set_halfedge_tangent(const PackedRealArray &p_halfedge_tangent) {
-	SET_ARRAY(_inner->_meshgl.halfedgeTangent, p_halfedge_tangent);
+	SET_ARRAY(_inner->_meshgl.write().halfedgeTangent, p_halfedge_tangent);
 }
 PackedRealArray ManifoldMesh::get_halfedge_tangent() const {
-	GET_ARRAY(PackedRealArray, _inner->_meshgl.halfedgeTangent);
+	GET_ARRAY(PackedRealArray, _inner->_meshgl->halfedgeTangent);
 }
 
 void ManifoldMesh::set_tolerance(Precision p_tolerance) {
-	SET_VALUE(_inner->_meshgl.tolerance, p_tolerance);
+	SET_VALUE(_inner->_meshgl.write().tolerance, p_tolerance);
 }
 ManifoldMesh::Precision ManifoldMesh::get_tolerance() const {
-	GET_VALUE(_inner->_meshgl.tolerance);
+	GET_VALUE(_inner->_meshgl->tolerance);
 }
 
 #undef SET_VALUE
@@ -397,12 +680,21 @@ TypedArray<Array> ManifoldMesh::_surface_get_blend_shape_arrays(int32_t p_index)
 	return TypedArray<Array>();
 }
 Dictionary ManifoldMesh::_surface_get_lods(int32_t p_index) const {
-	return Dictionary();
+	ERR_FAIL_INDEX_V(p_index, _surface_materials.size(), Dictionary());
+
+	if (!_generate_lods) {
+		return Dictionary();
+	}
+
+	_ensure_lods();
+
+	return _inner->_lods[p_index];
 }
 uint32_t ManifoldMesh::_surface_get_format(int32_t p_index) const {
 	ERR_FAIL_INDEX_V(p_index, _surface_formats.size(), 0);
 
-	return _surface_formats[p_index] & ~ARRAY_FORMAT_INDEX;
+	// surfaces are always emitted indexed, whatever the source mesh was
+	return _surface_formats[p_index] | ARRAY_FORMAT_INDEX;
 }
 uint32_t ManifoldMesh::_surface_get_primitive_type(int32_t p_index) const {
 	return PRIMITIVE_TRIANGLES;
@@ -411,6 +703,7 @@ void ManifoldMesh::_surface_set_material(int32_t p_index, const Ref<Material> &p
 	ERR_FAIL_INDEX(p_index, _surface_materials.size());
 	if (_surface_materials[p_index] != p_material) {
 		_surface_materials[p_index] = p_material;
+		_inner->_has_content_hash = false;
 		emit_changed();
 	}
 }
@@ -431,10 +724,30 @@ AABB ManifoldMesh::_get_aabb() const {
 	_ensure_manifold();
 	return from_box(_inner->_manifold.BoundingBox());
 }
+static Dictionary remap_lods(const Dictionary &p_lods, const PackedInt32Array &p_remap) {
+	Dictionary remapped;
+	const Array distances = p_lods.keys();
+	for (int64_t i = 0; i < distances.size(); i++) {
+		PackedInt32Array indices = p_lods[distances[i]];
+		int32_t *ptrw = indices.ptrw();
+		for (int64_t j = 0; j < indices.size(); j++) {
+			ptrw[j] = p_remap[ptrw[j]];
+		}
+		remapped[distances[i]] = indices;
+	}
+	return remapped;
+}
+
 RID ManifoldMesh::_get_rid() const {
-	_commit_to_arrays();
+	if (likely(!_inner->_meshgl_dropped)) {
+		// a dropped meshgl is still exactly what the RID holds, so there is nothing to regenerate
+		_ensure_meshgl();
+	}
 
 	if (unlikely(_inner->_rid_dirty)) {
+		_commit_to_arrays();
+
+		MANIFOLD_PROFILE_ZONE(ZONE_RID_UPLOAD);
 		RenderingServer *rs = RenderingServer::get_singleton();
 		ERR_FAIL_NULL_V(rs, RID());
 
@@ -446,15 +759,41 @@ RID ManifoldMesh::_get_rid() const {
 		}
 
 		rs->mesh_clear(_inner->_rid);
+		_inner->_rid_bytes = 0;
 		for (int32_t i = 0; i < _get_surface_count(); i++) {
-			rs->mesh_add_surface_from_arrays(_inner->_rid, RenderingServer::PRIMITIVE_TRIANGLES, _surface_get_arrays(i), {}, {}, _surface_get_format(i));
+			const Array arrays = _surface_get_arrays(i);
+			const Dictionary lods = _surface_get_lods(i);
+			rs->mesh_add_surface_from_arrays(_inner->_rid, RenderingServer::PRIMITIVE_TRIANGLES, arrays, {}, lods, _surface_get_format(i));
+			_inner->_rid_bytes += memory_of_arrays(arrays) + memory_of_arrays(lods.values());
+			MANIFOLD_PROFILE_UPLOAD(arrays);
 			const Ref<Material> surface_material = _surface_get_material(i);
 			if (surface_material.is_valid()) {
 				rs->mesh_surface_set_material(_inner->_rid, i, surface_material->get_rid());
 			}
 		}
 
+		if (_create_shadow_mesh) {
+			_ensure_shadow();
+			if (unlikely(!_inner->_shadow_rid.is_valid())) {
+				_inner->_shadow_rid = rs->mesh_create();
+			}
+
+			// the renderer pairs shadow surfaces with mesh surfaces by index
+			rs->mesh_clear(_inner->_shadow_rid);
+			for (int32_t i = 0; i < _get_surface_count(); i++) {
+				const Dictionary lods = remap_lods(_surface_get_lods(i), _inner->_shadow_remap[i]);
+				rs->mesh_add_surface_from_arrays(_inner->_shadow_rid, RenderingServer::PRIMITIVE_TRIANGLES, _inner->_shadow_arrays[i], {}, lods, ARRAY_FORMAT_VERTEX | ARRAY_FORMAT_INDEX);
+				_inner->_rid_bytes += memory_of_arrays(_inner->_shadow_arrays[i]) + memory_of_arrays(lods.values());
+			}
+			rs->mesh_set_shadow_mesh(_inner->_rid, _inner->_shadow_rid);
+		} else if (_inner->_shadow_rid.is_valid()) {
+			rs->mesh_set_shadow_mesh(_inner->_rid, RID());
+			rs->free_rid(_inner->_shadow_rid);
+			_inner->_shadow_rid = RID();
+		}
+
 		_inner->_rid_dirty = false;
+		_apply_retention_policy();
 	}
 
 	return _inner->_rid;
@@ -515,41 +854,43 @@ Ref<ManifoldMesh> ManifoldMesh::from_mesh(const Ref<Mesh> &p_mesh) {
 		return mesh;
 	}
 
+	manifold::MeshGLP<Precision, I> &meshgl = mesh->_inner->_meshgl.write();
 	// always include normals in what we give to manifold
 	// never include tangents - they are computed when we turn back into a mesh
-	mesh->_inner->_meshgl.numProp = 6;
+	meshgl.numProp = 6;
 
 	if (format_union & ARRAY_FORMAT_TEX_UV) {
-		mesh->_inner->_meshgl.numProp = 8;
+		meshgl.numProp = 8;
 	}
 	if (format_union & ARRAY_FORMAT_TEX_UV2) {
-		mesh->_inner->_meshgl.numProp = 10;
+		meshgl.numProp = 10;
 	}
 	if (format_union & ARRAY_FORMAT_COLOR) {
-		mesh->_inner->_meshgl.numProp = 14;
+		meshgl.numProp = 14;
 	}
 	if (format_union & ARRAY_FORMAT_CUSTOM0) {
-		mesh->_inner->_meshgl.numProp = 18;
+		meshgl.numProp = 18;
 	}
 	if (format_union & ARRAY_FORMAT_CUSTOM1) {
-		mesh->_inner->_meshgl.numProp = 22;
+		meshgl.numProp = 22;
 	}
 	if (format_union & ARRAY_FORMAT_CUSTOM2) {
-		mesh->_inner->_meshgl.numProp = 26;
+		meshgl.numProp = 26;
 	}
 	if (format_union & ARRAY_FORMAT_CUSTOM3) {
-		mesh->_inner->_meshgl.numProp = 30;
+		meshgl.numProp = 30;
 	}
 
-	const I stride = mesh->_inner->_meshgl.numProp;
+	const I stride = meshgl.numProp;
 
-	mesh->_inner->_meshgl.vertProperties.resize(total_vertices * stride);
-	mesh->_inner->_meshgl.triVerts.resize(total_indices);
-	mesh->_inner->_meshgl.runIndex.resize(num_surfaces + 1);
-	mesh->_inner->_meshgl.runOriginalID.resize(num_surfaces);
+	meshgl.vertProperties.resize(total_vertices * stride);
+	meshgl.triVerts.resize(total_indices);
+	meshgl.runIndex.resize(num_surfaces + 1);
+	meshgl.runOriginalID.resize(num_surfaces);
 
-	mesh->_inner->_meshgl.runIndex[0] = 0;
+	meshgl.runIndex[0] = 0;
 
+	HashMap<uint32_t, int64_t> surface_by_original_id;
 	I base_vertex = 0, base_index = 0;
 	for (int32_t surface = 0; surface < num_surfaces; surface++) {
 		ERR_FAIL_COND_V(array_mesh.is_valid() && array_mesh->surface_get_primitive_type(surface) != PRIMITIVE_TRIANGLES, Ref<ManifoldMesh>());
@@ -558,14 +899,15 @@ Ref<ManifoldMesh> ManifoldMesh::from_mesh(const Ref<Mesh> &p_mesh) {
 		const uint32_t original_id = get_material_original_id(material);
 		const uint32_t format = array_mesh.is_valid() ? array_mesh->surface_get_format(surface) : get_surface_format_hack(p_mesh->surface_get_arrays(surface));
 
-		int64_t existing_surface = mesh->_surface_original_ids.find(original_id);
-		if (likely(existing_surface == -1)) {
+		const int64_t *existing_surface = surface_by_original_id.getptr(original_id);
+		if (likely(!existing_surface)) {
+			surface_by_original_id.insert(original_id, mesh->_surface_original_ids.size());
 			mesh->_surface_formats.append(format);
 			mesh->_surface_original_ids.append(original_id);
 			mesh->_surface_materials.append(material);
 			mesh->_surface_names.append(array_mesh.is_valid() ? array_mesh->surface_get_name(surface) : String());
 		} else {
-			mesh->_surface_formats[existing_surface] |= format;
+			mesh->_surface_formats[*existing_surface] |= format;
 		}
 
 		I vertex = base_vertex, index = base_index;
@@ -574,9 +916,9 @@ Ref<ManifoldMesh> ManifoldMesh::from_mesh(const Ref<Mesh> &p_mesh) {
 
 		const PackedVector3Array positions = arrays[ARRAY_VERTEX];
 		for (int32_t i = 0; i < positions.size(); i++) {
-			mesh->_inner->_meshgl.vertProperties[vertex * stride + 0] = positions[i].x;
-			mesh->_inner->_meshgl.vertProperties[vertex * stride + 1] = positions[i].y;
-			mesh->_inner->_meshgl.vertProperties[vertex * stride + 2] = positions[i].z;
+			meshgl.vertProperties[vertex * stride + 0] = positions[i].x;
+			meshgl.vertProperties[vertex * stride + 1] = positions[i].y;
+			meshgl.vertProperties[vertex * stride + 2] = positions[i].z;
 			vertex++;
 		}
 
@@ -610,20 +952,20 @@ Ref<ManifoldMesh> ManifoldMesh::from_mesh(const Ref<Mesh> &p_mesh) {
 		if (format & ARRAY_FORMAT_INDEX) {
 			const PackedInt32Array indices = arrays[ARRAY_INDEX];
 			for (int32_t i = 0; i < indices.size(); i += 3) {
-				mesh->_inner->_meshgl.triVerts[index++] = base_vertex + indices[i + 0];
-				mesh->_inner->_meshgl.triVerts[index++] = base_vertex + indices[i + 2];
-				mesh->_inner->_meshgl.triVerts[index++] = base_vertex + indices[i + 1];
+				meshgl.triVerts[index++] = base_vertex + indices[i + 0];
+				meshgl.triVerts[index++] = base_vertex + indices[i + 2];
+				meshgl.triVerts[index++] = base_vertex + indices[i + 1];
 			}
 		} else {
 			for (int32_t i = 0; i < positions.size(); i += 3) {
-				mesh->_inner->_meshgl.triVerts[index++] = base_vertex + i + 0;
-				mesh->_inner->_meshgl.triVerts[index++] = base_vertex + i + 2;
-				mesh->_inner->_meshgl.triVerts[index++] = base_vertex + i + 1;
+				meshgl.triVerts[index++] = base_vertex + i + 0;
+				meshgl.triVerts[index++] = base_vertex + i + 2;
+				meshgl.triVerts[index++] = base_vertex + i + 1;
 			}
 		}
 
-		mesh->_inner->_meshgl.runIndex[surface + 1] = index;
-		mesh->_inner->_meshgl.runOriginalID[surface] = original_id;
+		meshgl.runIndex[surface + 1] = index;
+		meshgl.runOriginalID[surface] = original_id;
 
 		base_vertex = vertex;
 		base_index = index;
@@ -632,10 +974,10 @@ Ref<ManifoldMesh> ManifoldMesh::from_mesh(const Ref<Mesh> &p_mesh) {
 	DEV_ASSERT(base_vertex == total_vertices);
 	DEV_ASSERT(base_index == total_indices);
 
-	mesh->_inner->_meshgl.tolerance = UNIT_EPSILON;
+	meshgl.tolerance = UNIT_EPSILON;
 
-	mesh->_inner->_meshgl.Merge();
-	mesh->_inner->_manifold = manifold::Manifold(mesh->_inner->_meshgl);
+	meshgl.Merge();
+	mesh->_inner->_manifold = manifold::Manifold(meshgl);
 	mesh->_inner->_has_bad_original_ids = false;
 
 	if (unlikely(mesh->_inner->_manifold.Status() != manifold::Manifold::Error::NoError)) {
@@ -644,6 +986,50 @@ Ref<ManifoldMesh> ManifoldMesh::from_mesh(const Ref<Mesh> &p_mesh) {
 
 	return mesh;
 }
+Ref<ManifoldMesh> ManifoldMesh::import_from_file(const String &p_path, double p_weld_tolerance) {
+	std::vector<String> group_names;
+	Ref<ManifoldMesh> mesh;
+	{
+		// positions are welded while parsing, so this goes straight to manifold without a Merge pass
+		manifold::MeshGLP<Precision, I> meshgl;
+		const godot::Error err = import_mesh(p_path, p_weld_tolerance, meshgl, group_names);
+		ERR_FAIL_COND_V(err != OK, Ref<ManifoldMesh>());
+
+		mesh.instantiate();
+		for (size_t i = 0; i < group_names.size(); i++) {
+			// named groups get a placeholder material so they keep their own surface
+			Ref<Material> material;
+			if (group_names.size() > 1 || !group_names[i].is_empty()) {
+				Ref<StandardMaterial3D> placeholder;
+				placeholder.instantiate();
+				placeholder->set_name(group_names[i]);
+				material = placeholder;
+			}
+
+			const uint32_t original_id = get_material_original_id(material);
+			meshgl.runOriginalID[i] = original_id;
+
+			mesh->_surface_formats.append(ARRAY_FORMAT_VERTEX | ARRAY_FORMAT_NORMAL);
+			mesh->_surface_original_ids.append(original_id);
+			mesh->_surface_materials.append(material);
+			mesh->_surface_names.append(group_names[i].is_empty() ? p_path.get_file().get_basename() : group_names[i]);
+		}
+
+		mesh->_inner->_manifold = manifold::Manifold(meshgl);
+	}
+
+	ERR_FAIL_COND_V_MSG(mesh->_inner->_manifold.Status() != manifold::Manifold::Error::NoError, Ref<ManifoldMesh>(), vformat("%s: mesh is non-manifold", p_path));
+
+	mesh->_inner->_manifold = mesh->_inner->_manifold.CalculateNormals(0).SmoothByNormals(0);
+#ifdef REAL_T_IS_DOUBLE
+	mesh->_inner->_meshgl = mesh->_inner->_manifold.GetMeshGL64(0);
+#else
+	mesh->_inner->_meshgl = mesh->_inner->_manifold.GetMeshGL(0);
+#endif
+	mesh->_inner->_has_bad_original_ids = false;
+
+	return mesh;
+}
 
 Ref<ArrayMesh> ManifoldMesh::to_mesh(bool p_generate_lods, bool p_create_shadow_mesh, const TypedArray<Material> &p_skip_material) const {
 	if (unlikely(is_empty())) {
@@ -651,9 +1037,19 @@ Ref<ArrayMesh> ManifoldMesh::to_mesh(bool p_generate_lods, bool p_create_shadow_
 	}
 
 	_commit_to_arrays();
+	if (p_generate_lods) {
+		_ensure_lods();
+	}
+	if (p_create_shadow_mesh) {
+		_ensure_shadow();
+	}
 
 	Ref<ImporterMesh> mesh;
 	mesh.instantiate();
+	Ref<ArrayMesh> shadow_mesh;
+	if (p_create_shadow_mesh) {
+		shadow_mesh.instantiate();
+	}
 
 	for (int32_t i = 0; i < _inner->_arrays.size(); i++) {
 		const Ref<Material> material = likely(i < _surface_materials.size()) ? _surface_materials[i] : Variant();
@@ -668,20 +1064,18 @@ Ref<ArrayMesh> ManifoldMesh::to_mesh(bool p_generate_lods, bool p_create_shadow_
 
 		const String name = likely(i < _surface_names.size()) ? _surface_names[i] : String();
 
-		mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, _inner->_arrays[i], TypedArray<Array>(), Dictionary(), material, name, _surface_get_format(i));
+		const Dictionary lods = p_generate_lods ? _inner->_lods[i] : Dictionary();
+		mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, _inner->_arrays[i], TypedArray<Array>(), lods, material, name, _surface_get_format(i));
+		if (shadow_mesh.is_valid()) {
+			shadow_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, _inner->_shadow_arrays[i], TypedArray<Array>(), remap_lods(lods, _inner->_shadow_remap[i]));
+		}
 	}
 
-	if (p_generate_lods) {
-		mesh->generate_lods(60.0f, 0.0f, Array());
-	}
-#if 0
-	// TODO: https://github.com/godotengine/godot/pull/103948
-	if (p_create_shadow_mesh) {
-		mesh->create_shadow_mesh();
+	const Ref<ArrayMesh> array_mesh = mesh->get_mesh();
+	if (shadow_mesh.is_valid() && shadow_mesh->get_surface_count() > 0) {
+		array_mesh->set_shadow_mesh(shadow_mesh);
 	}
-#endif
-
-	return mesh->get_mesh();
+	return array_mesh;
 }
 
 TypedArray<ManifoldMesh> ManifoldMesh::decompose() const {
@@ -722,6 +1116,22 @@ TypedArray<PackedVector2Array> ManifoldMesh::slice(double p_height) const {
 	_ensure_manifold();
 	return from_polygons(_inner->_manifold.Slice(p_height));
 }
+TypedArray<CrossSection> ManifoldMesh::slice_many(const PackedFloat64Array &p_heights) const {
+	const std::vector<double> heights(p_heights.ptr(), p_heights.ptr() + p_heights.size());
+	for (const double height : heights) {
+		ERR_FAIL_COND_V(!Math::is_finite(height), TypedArray<CrossSection>());
+	}
+
+	// the cached MeshGL already has everything the sweep needs, so there's no need to go through the manifold
+	_ensure_meshgl();
+	const std::vector<manifold::CrossSection> layers = slice_mesh(*_inner->_meshgl, heights);
+	TypedArray<CrossSection> wrapped_layers;
+	wrapped_layers.resize(layers.size());
+	for (size_t i = 0; i < layers.size(); i++) {
+		wrapped_layers[i] = Ref<CrossSection>(memnew(CrossSection(layers[i])));
+	}
+	return wrapped_layers;
+}
 TypedArray<PackedVector2Array> ManifoldMesh::project() const {
 	_ensure_manifold();
 	return from_polygons(_inner->_manifold.Project());
@@ -733,6 +1143,116 @@ Ref<ManifoldMesh> ManifoldMesh::revolve(const TypedArray<PackedVector2Array> &p_
 	return _primitive(manifold::Manifold::Revolve(to_polygons(p_cross_section), p_circular_segments, p_revolve_degrees), p_material, "revolve");
 }
 
+Ref<CrossSection> ManifoldMesh::slice_cross_section(double p_height) const {
+	_ensure_manifold();
+	return memnew(CrossSection(manifold::CrossSection(_inner->_manifold.Slice(p_height), manifold::CrossSection::FillRule::Positive)));
+}
+Ref<CrossSection> ManifoldMesh::project_cross_section() const {
+	_ensure_manifold();
+	return memnew(CrossSection(manifold::CrossSection(_inner->_manifold.Project(), manifold::CrossSection::FillRule::Positive)));
+}
+Ref<ManifoldMesh> ManifoldMesh::extrude_cross_section(const Ref<CrossSection> &p_cross_section, double p_height, int32_t p_divisions, double p_twist_degrees, const Vector2 &p_scale_top, const Ref<Material> &p_material) {
+	ERR_FAIL_COND_V(p_cross_section.is_null(), Ref<ManifoldMesh>());
+	return _primitive(manifold::Manifold::Extrude(p_cross_section->_get_cross_section().ToPolygons(), p_height, p_divisions, p_twist_degrees, to_vec2(p_scale_top)), p_material, "extrude");
+}
+Ref<ManifoldMesh> ManifoldMesh::revolve_cross_section(const Ref<CrossSection> &p_cross_section, int32_t p_circular_segments, double p_revolve_degrees, const Ref<Material> &p_material) {
+	ERR_FAIL_COND_V(p_cross_section.is_null(), Ref<ManifoldMesh>());
+	return _primitive(manifold::Manifold::Revolve(p_cross_section->_get_cross_section().ToPolygons(), p_circular_segments, p_revolve_degrees), p_material, "revolve");
+}
+
+// Bakes the triangles an agent can walk on straight from the mesh: triangles facing up within
+// p_max_slope degrees are grouped into patches, each patch loses whatever has something solid less
+// than p_agent_height above it and is shrunk by p_agent_radius, and what is left becomes convex
+// polygons lying on the surface. Patches are baked in parallel. With a region, only that box is
+// baked, looking at no more than twice the radius around it, so a large level can be rebaked one
+// region at a time and the regions still meet edge to edge.
+Ref<NavigationMesh> ManifoldMesh::to_navigation_mesh(double p_agent_height, double p_agent_radius, double p_max_slope, const AABB &p_region) const {
+	ERR_FAIL_COND_V(p_agent_height <= 0.0, Ref<NavigationMesh>());
+	ERR_FAIL_COND_V(p_agent_radius < 0.0, Ref<NavigationMesh>());
+	ERR_FAIL_COND_V(p_max_slope < 0.0 || p_max_slope >= 90.0, Ref<NavigationMesh>());
+
+	_ensure_meshgl();
+	_ensure_manifold();
+	const std::vector<WalkablePatch> patches = walkable_patches(*_inner->_meshgl, Math::deg_to_rad(p_max_slope));
+	// split into its connected parts once here, so every patch only intersects the parts near it
+	// rather than running a boolean against the whole mesh
+	NavigationSolid solid;
+	solid.build(_inner->_manifold.Transform(navigation_z_up()));
+	const manifold::Box region = to_box(p_region);
+
+	struct Baked {
+		std::vector<manifold::vec3> vertices;
+		std::vector<std::vector<int32_t>> polygons;
+	};
+	std::vector<Baked> baked(patches.size());
+	parallel_for(uint32_t(patches.size()), [&](uint32_t p_patch) {
+		const WalkablePatch &patch = patches[p_patch];
+		const manifold::CrossSection walkable = navigation_walkable_area(patch, solid, p_agent_height, p_agent_radius, p_region.has_volume() ? &region : nullptr);
+		std::vector<manifold::vec2> vertices;
+		convex_partition_shared(walkable, vertices, baked[p_patch].polygons);
+
+		NavigationHeights heights;
+		heights.build(patch);
+		baked[p_patch].vertices.reserve(vertices.size());
+		for (const manifold::vec2 &vertex : vertices) {
+			baked[p_patch].vertices.push_back({ vertex.x, heights.height(vertex), -vertex.y });
+		}
+	});
+
+	Ref<NavigationMesh> navigation_mesh;
+	navigation_mesh.instantiate();
+	navigation_mesh->set_agent_height(p_agent_height);
+	navigation_mesh->set_agent_radius(p_agent_radius);
+	navigation_mesh->set_agent_max_slope(p_max_slope);
+	PackedVector3Array vertices;
+	for (const Baked &patch : baked) {
+		const int32_t first_vertex = int32_t(vertices.size());
+		for (const manifold::vec3 &vertex : patch.vertices) {
+			vertices.push_back(from_vec3(vertex));
+		}
+		// clockwise seen from above, the way Godot winds the faces it builds navigation meshes from
+		for (const std::vector<int32_t> &polygon : patch.polygons) {
+			PackedInt32Array indices;
+			indices.resize(polygon.size());
+			std::transform(polygon.rbegin(), polygon.rend(), indices.ptrw(), [first_vertex](int32_t p_vertex) {
+				return first_vertex + p_vertex;
+			});
+			navigation_mesh->add_polygon(indices);
+		}
+	}
+	navigation_mesh->set_vertices(vertices);
+	return navigation_mesh;
+}
+
+godot::Error ManifoldMesh::export_to_file(const String &p_path) const {
+	_ensure_meshgl();
+	return export_mesh(p_path, *_inner->_meshgl, _get_export_surfaces(), true);
+}
+int64_t ManifoldMesh::export_to_file_async(const String &p_path) const {
+	// the task shares the MeshGL rather than copying it: edits and the retention policy replace ours
+	// instead of changing it while the task reads it. Everything that touches resources happens
+	// here on the calling thread.
+	_ensure_meshgl();
+	return export_mesh_async(p_path, _inner->_meshgl.share(), _get_export_surfaces(), true, const_cast<ManifoldMesh *>(this));
+}
+std::vector<ExportSurface> ManifoldMesh::_get_export_surfaces() const {
+	std::vector<ExportSurface> surfaces;
+	surfaces.reserve(_surface_original_ids.size());
+	for (int64_t i = 0; i < _surface_original_ids.size(); i++) {
+		const Ref<Material> material = i < _surface_materials.size() ? Ref<Material>(_surface_materials[i]) : Ref<Material>();
+		String name;
+		if (i < _surface_names.size() && !_surface_names[i].is_empty()) {
+			name = _surface_names[i];
+		} else if (material.is_valid() && !material->get_name().is_empty()) {
+			name = material->get_name();
+		} else {
+			name = vformat("surface_%d", i);
+		}
+		surfaces.push_back({ uint32_t(_surface_original_ids[i]), name });
+	}
+	return surfaces;
+}
+
 uint64_t ManifoldMesh::get_vertex_count() const {
 	_ensure_manifold();
 	return _inner->_manifold.NumVert();
@@ -773,25 +1293,50 @@ double ManifoldMesh::get_min_gap(const Ref<ManifoldMesh> &p_other, double p_sear
 }
 
 Ref<ManifoldMesh> ManifoldMesh::translate(const Vector3 &p_offset) const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.Translate(to_vec3(p_offset)));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.translate", _get_content_hash(), p_offset);
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.Translate(to_vec3(p_offset)));
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::scale(const Vector3 &p_scale) const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.Scale(to_vec3(p_scale)));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.scale", _get_content_hash(), p_scale);
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.Scale(to_vec3(p_scale)));
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::rotate(const Vector3 &p_rotation_degrees) const {
-	_ensure_manifold();
-	// TODO: make sure these rotations match what Godot does
-	return _new_manifold(_inner->_manifold.Rotate(p_rotation_degrees.x, p_rotation_degrees.y, p_rotation_degrees.z));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.rotate", _get_content_hash(), p_rotation_degrees);
+	},
+			[&]() {
+				_ensure_manifold();
+				// TODO: make sure these rotations match what Godot does
+				return _new_manifold(_inner->_manifold.Rotate(p_rotation_degrees.x, p_rotation_degrees.y, p_rotation_degrees.z));
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::mirror(const Vector3 &p_normal) const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.Mirror(to_vec3(p_normal)));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.mirror", _get_content_hash(), p_normal);
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.Mirror(to_vec3(p_normal)));
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::transform(const Transform3D &p_transform) const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.Transform(to_mat3x4(p_transform)));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.transform", _get_content_hash(), p_transform);
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.Transform(to_mat3x4(p_transform)));
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::warp(const Callable &p_warp_vertex) const {
 	_ensure_manifold();
@@ -813,98 +1358,175 @@ Ref<ManifoldMesh> ManifoldMesh::warp_batch(const Callable &p_warp_vertices) cons
 	}));
 }
 Ref<ManifoldMesh> ManifoldMesh::simplify(double p_tolerance) const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.Simplify(p_tolerance));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.simplify", _get_content_hash(), p_tolerance);
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.Simplify(p_tolerance));
+			});
 }
 
 Ref<ManifoldMesh> ManifoldMesh::hull() const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.Hull());
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.hull", _get_content_hash());
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.Hull());
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::refine(int32_t p_subdivisions) const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.Refine(p_subdivisions));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.refine", _get_content_hash(), uint64_t(p_subdivisions));
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.Refine(p_subdivisions));
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::refine_to_length(double p_length) const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.RefineToLength(p_length));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.refine_to_length", _get_content_hash(), p_length);
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.RefineToLength(p_length));
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::refine_to_tolerance(double p_tolerance) const {
-	_ensure_manifold();
-	return _new_manifold(_inner->_manifold.RefineToTolerance(p_tolerance));
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.refine_to_tolerance", _get_content_hash(), p_tolerance);
+	},
+			[&]() {
+				_ensure_manifold();
+				return _new_manifold(_inner->_manifold.RefineToTolerance(p_tolerance));
+			});
 }
 
 Ref<ManifoldMesh> ManifoldMesh::union_with(const Ref<ManifoldMesh> &p_with) const {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	ERR_FAIL_COND_V(p_with.is_null(), Ref<ManifoldMesh>());
-	p_with->_ensure_manifold();
-	_ensure_manifold();
-	return _new_merged_manifold(_inner->_manifold + p_with->_inner->_manifold, { { { this }, p_with } });
+	return _cached_result(nullptr, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.union_with", _get_content_hash(), p_with->_get_content_hash());
+	},
+			[&]() {
+				p_with->_ensure_manifold();
+				_ensure_manifold();
+				return _new_merged_manifold(_inner->_manifold + p_with->_inner->_manifold, { { { this }, p_with } });
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::intersection_with(const Ref<ManifoldMesh> &p_with) const {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	ERR_FAIL_COND_V(p_with.is_null(), Ref<ManifoldMesh>());
-	p_with->_ensure_manifold();
-	_ensure_manifold();
-	return _new_merged_manifold(_inner->_manifold ^ p_with->_inner->_manifold, { { { this }, p_with } });
+	return _cached_result(nullptr, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.intersection_with", _get_content_hash(), p_with->_get_content_hash());
+	},
+			[&]() {
+				p_with->_ensure_manifold();
+				_ensure_manifold();
+				return _new_merged_manifold(_inner->_manifold ^ p_with->_inner->_manifold, { { { this }, p_with } });
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::difference_with(const Ref<ManifoldMesh> &p_with) const {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	ERR_FAIL_COND_V(p_with.is_null(), Ref<ManifoldMesh>());
-	p_with->_ensure_manifold();
-	_ensure_manifold();
-	return _new_merged_manifold(_inner->_manifold - p_with->_inner->_manifold, { { { this }, p_with } });
+	return _cached_result(nullptr, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.difference_with", _get_content_hash(), p_with->_get_content_hash());
+	},
+			[&]() {
+				p_with->_ensure_manifold();
+				_ensure_manifold();
+				return _new_merged_manifold(_inner->_manifold - p_with->_inner->_manifold, { { { this }, p_with } });
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::batch_union(const TypedArray<ManifoldMesh> &p_manifolds) {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	Vector<Ref<ManifoldMesh>> wrapped_manifolds;
 	wrapped_manifolds.resize(p_manifolds.size());
 
-	std::vector<manifold::Manifold> manifolds;
-	manifolds.resize(p_manifolds.size());
-
 	for (int64_t i = 0; i < p_manifolds.size(); i++) {
 		const Ref<ManifoldMesh> manifold = p_manifolds[i];
 		ERR_FAIL_COND_V(manifold.is_null(), Ref<ManifoldMesh>());
 		wrapped_manifolds.write[i] = manifold;
-		manifold->_ensure_manifold();
-		manifolds[i] = manifold->_inner->_manifold;
 	}
 
-	return _new_merged_manifold(manifold::Manifold::BatchBoolean(manifolds, manifold::OpType::Add), wrapped_manifolds);
+	return _cached_result(nullptr, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.batch_union", uint64_t(wrapped_manifolds.size()));
+		for (const Ref<ManifoldMesh> &manifold : wrapped_manifolds) {
+			r_key.add(manifold->_get_content_hash());
+		}
+	},
+			[&]() {
+				std::vector<manifold::Manifold> manifolds;
+				manifolds.resize(wrapped_manifolds.size());
+				for (int64_t i = 0; i < wrapped_manifolds.size(); i++) {
+					wrapped_manifolds[i]->_ensure_manifold();
+					manifolds[i] = wrapped_manifolds[i]->_inner->_manifold;
+				}
+
+				return _new_merged_manifold(manifold::Manifold::BatchBoolean(manifolds, manifold::OpType::Add), wrapped_manifolds);
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::batch_intersection(const TypedArray<ManifoldMesh> &p_manifolds) {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	Vector<Ref<ManifoldMesh>> wrapped_manifolds;
 	wrapped_manifolds.resize(p_manifolds.size());
 
-	std::vector<manifold::Manifold> manifolds;
-	manifolds.resize(p_manifolds.size());
-
 	for (int64_t i = 0; i < p_manifolds.size(); i++) {
 		const Ref<ManifoldMesh> manifold = p_manifolds[i];
 		ERR_FAIL_COND_V(manifold.is_null(), Ref<ManifoldMesh>());
 		wrapped_manifolds.write[i] = manifold;
-		manifold->_ensure_manifold();
-		manifolds[i] = manifold->_inner->_manifold;
 	}
 
-	return _new_merged_manifold(manifold::Manifold::BatchBoolean(manifolds, manifold::OpType::Intersect), wrapped_manifolds);
+	return _cached_result(nullptr, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.batch_intersection", uint64_t(wrapped_manifolds.size()));
+		for (const Ref<ManifoldMesh> &manifold : wrapped_manifolds) {
+			r_key.add(manifold->_get_content_hash());
+		}
+	},
+			[&]() {
+				std::vector<manifold::Manifold> manifolds;
+				manifolds.resize(wrapped_manifolds.size());
+				for (int64_t i = 0; i < wrapped_manifolds.size(); i++) {
+					wrapped_manifolds[i]->_ensure_manifold();
+					manifolds[i] = wrapped_manifolds[i]->_inner->_manifold;
+				}
+
+				return _new_merged_manifold(manifold::Manifold::BatchBoolean(manifolds, manifold::OpType::Intersect), wrapped_manifolds);
+			});
 }
 Ref<ManifoldMesh> ManifoldMesh::batch_difference(const TypedArray<ManifoldMesh> &p_manifolds) {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	Vector<Ref<ManifoldMesh>> wrapped_manifolds;
 	wrapped_manifolds.resize(p_manifolds.size());
 
-	std::vector<manifold::Manifold> manifolds;
-	manifolds.resize(p_manifolds.size());
-
 	for (int64_t i = 0; i < p_manifolds.size(); i++) {
 		const Ref<ManifoldMesh> manifold = p_manifolds[i];
 		ERR_FAIL_COND_V(manifold.is_null(), Ref<ManifoldMesh>());
 		wrapped_manifolds.write[i] = manifold;
-		manifold->_ensure_manifold();
-		manifolds[i] = manifold->_inner->_manifold;
 	}
 
-	return _new_merged_manifold(manifold::Manifold::BatchBoolean(manifolds, manifold::OpType::Subtract), wrapped_manifolds);
+	return _cached_result(nullptr, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.batch_difference", uint64_t(wrapped_manifolds.size()));
+		for (const Ref<ManifoldMesh> &manifold : wrapped_manifolds) {
+			r_key.add(manifold->_get_content_hash());
+		}
+	},
+			[&]() {
+				std::vector<manifold::Manifold> manifolds;
+				manifolds.resize(wrapped_manifolds.size());
+				for (int64_t i = 0; i < wrapped_manifolds.size(); i++) {
+					wrapped_manifolds[i]->_ensure_manifold();
+					manifolds[i] = wrapped_manifolds[i]->_inner->_manifold;
+				}
+
+				return _new_merged_manifold(manifold::Manifold::BatchBoolean(manifolds, manifold::OpType::Subtract), wrapped_manifolds);
+			});
 }
 
 Pair<Ref<ManifoldMesh>, Ref<ManifoldMesh>> ManifoldMesh::split(const Ref<ManifoldMesh> &p_manifold) const {
+	MANIFOLD_PROFILE_ZONE(ZONE_BOOLEAN);
 	ERR_FAIL_COND_V(p_manifold.is_null(), {});
 	p_manifold->_ensure_manifold();
 	_ensure_manifold();
@@ -915,15 +1537,78 @@ TypedArray<ManifoldMesh> ManifoldMesh::split_bind(const Ref<ManifoldMesh> &p_man
 	const Pair<Ref<ManifoldMesh>, Ref<ManifoldMesh>> pair = split(p_manifold);
 	return Array::make(pair.first, pair.second);
 }
+static int _plane_side(const manifold::Box &p_bounds, const Plane &p_plane) {
+	const manifold::vec3 normal = to_vec3(p_plane.normal);
+	const double distance = manifold::la::dot(normal, p_bounds.Center()) - p_plane.d;
+	const double radius = manifold::la::dot(manifold::la::abs(normal), 0.5 * p_bounds.Size());
+	if (distance - radius >= 0.0) {
+		return 1;
+	}
+	if (distance + radius <= 0.0) {
+		return -1;
+	}
+	return 0;
+}
 Pair<Ref<ManifoldMesh>, Ref<ManifoldMesh>> ManifoldMesh::split_by_plane(const Plane &p_plane, const godot::Ref<godot::Material> &p_material) const {
-	return split(_halfspace(p_plane, p_material));
+	ERR_FAIL_COND_V(p_plane.normal.is_zero_approx(), {});
+	_ensure_manifold();
+
+	const Plane plane = p_plane.normalized();
+	switch (_plane_side(_inner->_manifold.BoundingBox(), plane)) {
+		case 1:
+			return { _new_manifold(_inner->_manifold), _new_manifold(manifold::Manifold()) };
+		case -1:
+			return { _new_manifold(manifold::Manifold()), _new_manifold(_inner->_manifold) };
+	}
+
+	const std::pair<manifold::Manifold, manifold::Manifold> pair = _inner->_manifold.Split(_halfspace(plane, get_material_original_id(p_material)));
+
+	// the cutter's cap normals face away from the positive side, so flip them on the negative side;
+	// this is a pass over every vertex of the negative half, not just its cap, since SetProperties
+	// can't be limited to some faces
+	const manifold::vec3 normal = to_vec3(plane.normal);
+	const double d = plane.d;
+	const double tolerance = Math::max(pair.second.GetTolerance(), double(CMP_EPSILON));
+	const int32_t num_prop = pair.second.NumProp();
+	const manifold::Manifold negative = pair.second.SetProperties(num_prop, [normal, d, tolerance, num_prop](double *p_new_prop, manifold::vec3 p_position, const double *p_old_prop) -> void {
+		std::copy(p_old_prop, p_old_prop + num_prop, p_new_prop);
+		if (std::abs(manifold::la::dot(p_position, normal) - d) > tolerance) {
+			return;
+		}
+		const manifold::vec3 old_normal(p_old_prop[0], p_old_prop[1], p_old_prop[2]);
+		if (manifold::la::dot(old_normal, normal) < -1.0 + tolerance) {
+			p_new_prop[0] = normal.x;
+			p_new_prop[1] = normal.y;
+			p_new_prop[2] = normal.z;
+		}
+	});
+
+	return { _new_cut_manifold(pair.first, p_material), _new_cut_manifold(negative, p_material) };
 }
 TypedArray<ManifoldMesh> ManifoldMesh::split_by_plane_bind(const Plane &p_plane, const godot::Ref<godot::Material> &p_material) const {
 	const Pair<Ref<ManifoldMesh>, Ref<ManifoldMesh>> pair = split_by_plane(p_plane, p_material);
 	return Array::make(pair.first, pair.second);
 }
 Ref<ManifoldMesh> ManifoldMesh::trim_by_plane(const Plane &p_plane, const godot::Ref<godot::Material> &p_material) const {
-	return intersection_with(_halfspace(p_plane, p_material));
+	ERR_FAIL_COND_V(p_plane.normal.is_zero_approx(), Ref<ManifoldMesh>());
+	const Plane plane = p_plane.normalized();
+	const uint32_t original_id = get_material_original_id(p_material);
+
+	return _cached_result(this, [&](ManifoldHasher &r_key) {
+		r_key.add_all("ManifoldMesh.trim_by_plane", _get_content_hash(), plane);
+		add_material_key(r_key, p_material);
+	},
+			[&]() {
+				_ensure_manifold();
+				switch (_plane_side(_inner->_manifold.BoundingBox(), plane)) {
+					case 1:
+						return _new_manifold(_inner->_manifold);
+					case -1:
+						return _new_manifold(manifold::Manifold());
+				}
+
+				return _new_cut_manifold(_inner->_manifold ^ _halfspace(plane, original_id), p_material);
+			});
 }
 
 #define WARN_IF_UNUSED_FORMAT(m_format)                                                                                                                        \
@@ -1014,22 +1699,274 @@ Ref<ManifoldMesh> ManifoldMesh::modify_custom3(const Callable &p_modify) const {
 	return _modify_color(23, p_modify);
 }
 
+// the surface each run belongs to, or -1; one pass over the surfaces rather than a search per run
+template <typename Mesh>
+static std::vector<int32_t> run_surfaces(const Mesh &p_mesh, const PackedInt32Array &p_surface_original_ids) {
+	HashMap<uint32_t, int32_t> surface_by_original_id;
+	for (int32_t i = 0; i < p_surface_original_ids.size(); i++) {
+		const uint32_t original_id = p_surface_original_ids[i];
+		if (!surface_by_original_id.has(original_id)) {
+			surface_by_original_id.insert(original_id, i);
+		}
+	}
+
+	std::vector<int32_t> surfaces;
+	surfaces.reserve(p_mesh.runOriginalID.size());
+	for (const uint32_t original_id : p_mesh.runOriginalID) {
+		const int32_t *surface = surface_by_original_id.getptr(original_id);
+		surfaces.push_back(surface ? *surface : -1);
+	}
+	return surfaces;
+}
+
+ManifoldCacheKey ManifoldMesh::_get_content_hash() const {
+	if (unlikely(!_inner->_has_content_hash)) {
+		_ensure_manifold();
+		_ensure_meshgl();
+
+		// original IDs are handed out per run, so runs are hashed by the surface they belong to and
+		// surfaces by their material, which keeps the key the same from one run to the next
+		ManifoldHasher hasher;
+		hasher.add_mesh(*_inner->_meshgl);
+		for (const int32_t surface : run_surfaces(*_inner->_meshgl, _surface_original_ids)) {
+			hasher.add(uint64_t(surface));
+		}
+		hasher.add_bytes(_surface_formats.ptr(), _surface_formats.size() * sizeof(int32_t));
+		for (int64_t i = 0; i < _surface_materials.size(); i++) {
+			add_material_key(hasher, _surface_materials[i]);
+		}
+		for (const String &name : _surface_names) {
+			const CharString utf8 = name.utf8();
+			hasher.add_bytes(utf8.get_data(), utf8.length());
+		}
+
+		_inner->_content_hash = hasher.finish();
+		_inner->_has_content_hash = true;
+	}
+	return _inner->_content_hash;
+}
+
+template <typename T>
+static void store_cache_vector(const Ref<FileAccess> &p_file, const std::vector<T> &p_vector) {
+	PackedByteArray bytes;
+	bytes.resize(p_vector.size() * sizeof(T));
+	if (!p_vector.empty()) {
+		memcpy(bytes.ptrw(), p_vector.data(), bytes.size());
+	}
+
+	p_file->store_64(p_vector.size());
+	p_file->store_buffer(bytes);
+}
+
+template <typename T>
+static bool load_cache_vector(const Ref<FileAccess> &p_file, std::vector<T> &r_vector) {
+	const uint64_t count = p_file->get_64();
+	// a truncated or corrupted entry must not turn into a huge allocation
+	if (unlikely(count > (p_file->get_length() - p_file->get_position()) / sizeof(T))) {
+		return false;
+	}
+
+	const PackedByteArray bytes = p_file->get_buffer(count * sizeof(T));
+	if (unlikely(uint64_t(bytes.size()) != count * sizeof(T))) {
+		return false;
+	}
+
+	r_vector.resize(count);
+	if (count) {
+		memcpy(r_vector.data(), bytes.ptr(), bytes.size());
+	}
+	return true;
+}
+
+void ManifoldMesh::_save_cache_entry(const Ref<FileAccess> &p_file) const {
+	_ensure_manifold();
+	_ensure_meshgl();
+	const manifold::MeshGLP<Precision, I> &mesh = *_inner->_meshgl;
+
+	// a persistent key means every material came from a resource file, so the path is enough
+	p_file->store_32(_surface_original_ids.size());
+	for (int32_t i = 0; i < _surface_original_ids.size(); i++) {
+		const Ref<Material> material = _surface_get_material(i);
+		p_file->store_32(_surface_get_format(i));
+		p_file->store_pascal_string(material.is_valid() ? material->get_path() : String());
+		p_file->store_pascal_string(likely(i < _surface_names.size()) ? _surface_names[i] : String());
+	}
+
+	p_file->store_32(mesh.numProp);
+	p_file->store_double(mesh.tolerance);
+	store_cache_vector(p_file, mesh.vertProperties);
+	store_cache_vector(p_file, mesh.triVerts);
+	store_cache_vector(p_file, mesh.mergeFromVert);
+	store_cache_vector(p_file, mesh.mergeToVert);
+	store_cache_vector(p_file, mesh.runIndex);
+	store_cache_vector(p_file, run_surfaces(mesh, _surface_original_ids));
+	store_cache_vector(p_file, mesh.runTransform);
+	store_cache_vector(p_file, mesh.faceID);
+	store_cache_vector(p_file, mesh.halfedgeTangent);
+}
+
+Ref<ManifoldMesh> ManifoldMesh::_load_cache_entry(const Ref<FileAccess> &p_file) {
+	Ref<ManifoldMesh> m;
+	m.instantiate();
+
+	const uint32_t surface_count = p_file->get_32();
+	for (uint32_t i = 0; i < surface_count; i++) {
+		const uint32_t format = p_file->get_32();
+		const String material_path = p_file->get_pascal_string();
+		const String name = p_file->get_pascal_string();
+		if (unlikely(p_file->eof_reached())) {
+			return Ref<ManifoldMesh>();
+		}
+
+		Ref<Material> material;
+		if (!material_path.is_empty()) {
+			// the material was moved or deleted since the entry was written
+			material = ResourceLoader::get_singleton()->load(material_path);
+			if (unlikely(material.is_null())) {
+				return Ref<ManifoldMesh>();
+			}
+		}
+
+		// surface indices stand in for original IDs until _reallocate_original_ids below
+		m->_surface_formats.append(format);
+		m->_surface_original_ids.append(i);
+		m->_surface_materials.append(material);
+		m->_surface_names.append(name);
+	}
+
+	manifold::MeshGLP<Precision, I> &mesh = m->_inner->_meshgl.write();
+	std::vector<int32_t> run_surfaces;
+	mesh.numProp = p_file->get_32();
+	mesh.tolerance = p_file->get_double();
+	if (unlikely(!load_cache_vector(p_file, mesh.vertProperties) ||
+				!load_cache_vector(p_file, mesh.triVerts) ||
+				!load_cache_vector(p_file, mesh.mergeFromVert) ||
+				!load_cache_vector(p_file, mesh.mergeToVert) ||
+				!load_cache_vector(p_file, mesh.runIndex) ||
+				!load_cache_vector(p_file, run_surfaces) ||
+				!load_cache_vector(p_file, mesh.runTransform) ||
+				!load_cache_vector(p_file, mesh.faceID) ||
+				!load_cache_vector(p_file, mesh.halfedgeTangent))) {
+		return Ref<ManifoldMesh>();
+	}
+
+	mesh.runOriginalID.resize(run_surfaces.size());
+	for (size_t i = 0; i < run_surfaces.size(); i++) {
+		if (unlikely(run_surfaces[i] < 0 || uint32_t(run_surfaces[i]) >= surface_count)) {
+			return Ref<ManifoldMesh>();
+		}
+		mesh.runOriginalID[i] = run_surfaces[i];
+	}
+
+	m->_inner->_manifold_dirty = true;
+	m->_reallocate_original_ids();
+	return m;
+}
+
+Ref<ManifoldMesh> ManifoldMesh::_duplicate_result(const ManifoldCacheKey &p_key) const {
+	Ref<ManifoldMesh> m;
+	if (_inner->_manifold_dirty) {
+		// loaded from disk and not needed as a manifold yet; sharing the MeshGL keeps it that way
+		m = _new_manifold(manifold::Manifold());
+		m->_inner->_meshgl = _inner->_meshgl;
+		m->_inner->_manifold_dirty = true;
+		m->_inner->_meshgl_dirty = false;
+	} else {
+		m = _new_manifold(_inner->_manifold);
+	}
+	m->_inner->_content_hash = p_key;
+	m->_inner->_has_content_hash = true;
+	return m;
+}
+
+void ManifoldMesh::_copy_settings(const ManifoldMesh *p_source) {
+	_retention_policy = p_source ? p_source->_retention_policy : RETAIN_ALL;
+	_generate_lods = p_source ? p_source->_generate_lods : true;
+	_create_shadow_mesh = p_source ? p_source->_create_shadow_mesh : true;
+	_optimize_vertex_cache = p_source ? p_source->_optimize_vertex_cache : true;
+}
+
+Ref<ManifoldMesh> ManifoldMesh::_cached_result(const ManifoldMesh *p_source, const std::function<void(ManifoldHasher &)> &p_key, const std::function<Ref<ManifoldMesh>()> &p_compute) {
+	if (likely(!ManifoldCache::is_enabled())) {
+		return p_compute();
+	}
+
+	ManifoldHasher hasher;
+	p_key(hasher);
+	const ManifoldCacheKey key = hasher.finish();
+
+	// the cache keeps its own copy, so editing a returned mesh in place can't change later hits
+	const Ref<ManifoldMesh> cached = ManifoldCache::lookup_mesh(key);
+	// the render settings aren't part of the key, so a hit takes them from p_source the same way
+	// p_compute would have (null meaning a fresh mesh's defaults)
+	if (cached.is_valid()) {
+		const Ref<ManifoldMesh> m = cached->_duplicate_result(key);
+		m->_copy_settings(p_source);
+		return m;
+	}
+
+	const Ref<FileAccess> entry = ManifoldCache::open_disk_entry(key);
+	if (entry.is_valid()) {
+		// only the MeshGL is read back; the manifold is rebuilt the first time an operation needs it,
+		// which a result that is only rendered never does
+		const Ref<ManifoldMesh> loaded = _load_cache_entry(entry);
+		if (likely(loaded.is_valid())) {
+			loaded->_inner->_content_hash = key;
+			loaded->_inner->_has_content_hash = true;
+			ManifoldCache::store_mesh(key, loaded->_duplicate_result(key), memory_of_meshgl(*loaded->_inner->_meshgl));
+			loaded->_copy_settings(p_source);
+			return loaded;
+		}
+	}
+
+	// sizing or saving the result would evaluate it, and an intermediate in a chain of booleans may
+	// never need that; so it is stored once _ensure_meshgl builds its MeshGL anyway
+	const Ref<ManifoldMesh> result = p_compute();
+	ERR_FAIL_COND_V(result.is_null(), result);
+	result->_inner->_content_hash = key;
+	result->_inner->_has_content_hash = true;
+	result->_inner->_pending_store = true;
+	if (!result->_inner->_meshgl_dirty) {
+		result->_store_pending_result();
+	}
+	return result;
+}
+
+void ManifoldMesh::_store_pending_result() const {
+	_inner->_pending_store = false;
+	// edited in place since it was computed, so it no longer matches its key
+	if (unlikely(!_inner->_has_content_hash)) {
+		return;
+	}
+
+	const ManifoldCacheKey key = _inner->_content_hash;
+	const uint64_t bytes = _inner->_manifold_dirty ? memory_of_meshgl(*_inner->_meshgl) : memory_of_manifold(_inner->_manifold);
+	ManifoldCache::store_mesh(key, _duplicate_result(key), bytes);
+
+	const Ref<FileAccess> new_entry = ManifoldCache::create_disk_entry(key);
+	if (new_entry.is_valid()) {
+		_save_cache_entry(new_entry);
+		ManifoldCache::commit_disk_entry(key, new_entry);
+	}
+}
+
 void ManifoldMesh::_ensure_manifold() const {
 	if (unlikely(_inner->_has_bad_original_ids)) {
 		const_cast<ManifoldMesh *>(this)->_reallocate_original_ids();
 	}
 
 	if (unlikely(_inner->_manifold_dirty)) {
+		MANIFOLD_PROFILE_ZONE(ZONE_ENSURE_MANIFOLD);
 		DEV_ASSERT(!_inner->_meshgl_dirty);
 
-		_inner->_manifold = manifold::Manifold(_inner->_meshgl);
+		_inner->_manifold = manifold::Manifold(*_inner->_meshgl);
 		_inner->_manifold_dirty = false;
 
 		if (unlikely(_inner->_manifold.Status() != manifold::Manifold::Error::NoError)) {
 			ERR_PRINT(vformat("%s: mesh is non-manifold", this));
 		}
 
-		if (_inner->_meshgl.halfedgeTangent.empty() && likely(is_valid())) {
+		if (_inner->_meshgl->halfedgeTangent.empty() && likely(is_valid())) {
 			_inner->_manifold = _inner->_manifold.SmoothByNormals(0);
 			_inner->_meshgl_dirty = true;
 		}
@@ -1038,6 +1975,8 @@ void ManifoldMesh::_ensure_manifold() const {
 
 void ManifoldMesh::_ensure_meshgl() const {
 	if (unlikely(_inner->_meshgl_dirty)) {
+		// booleans are evaluated lazily, so this is usually where their real cost shows up
+		MANIFOLD_PROFILE_ZONE(ZONE_ENSURE_MESHGL);
 		DEV_ASSERT(!_inner->_manifold_dirty);
 		ERR_FAIL_COND(!is_valid());
 #ifdef REAL_T_IS_DOUBLE
@@ -1045,9 +1984,40 @@ void ManifoldMesh::_ensure_meshgl() const {
 #else
 		_inner->_meshgl = _inner->_manifold.GetMeshGL(0);
 #endif
+		MANIFOLD_PROFILE_TRIANGLES(_inner->_meshgl->NumTri());
 		_inner->_arrays.clear();
-		_inner->_rid_dirty = true;
+		if (likely(!_inner->_meshgl_dropped)) {
+			_inner->_rid_dirty = true;
+		}
+		_inner->_meshgl_dropped = false;
 		_inner->_meshgl_dirty = false;
+
+		if (unlikely(_inner->_pending_store)) {
+			_store_pending_result();
+		}
+	}
+}
+
+void ManifoldMesh::_apply_retention_policy() const {
+	if (likely(_retention_policy == RETAIN_ALL)) {
+		return;
+	}
+
+	// nothing reads these off the main thread (async exports hold their own reference to the
+	// MeshGL, and the cache copies synchronously), so they can go right away
+	_inner->_arrays = Vector<Array>();
+	_inner->_array_vertices.reset();
+	_inner->_lods = Vector<Dictionary>();
+	_inner->_shadow_arrays = Vector<Array>();
+	_inner->_shadow_remap = Vector<PackedInt32Array>();
+
+	// the MeshGL can only be rebuilt from a valid manifold, and only one that is already built is
+	// looked at: is_valid() would build it from the MeshGL here, on the render path
+	const bool has_manifold = !_inner->_manifold_dirty && _inner->_manifold.Status() == manifold::Manifold::Error::NoError;
+	if (_retention_policy == RETAIN_RENDER_ONLY && has_manifold && !_inner->_meshgl_dirty) {
+		_inner->_meshgl = manifold::MeshGLP<Precision, I>();
+		_inner->_meshgl_dirty = true;
+		_inner->_meshgl_dropped = true;
 	}
 }
 
@@ -1068,13 +2038,14 @@ void ManifoldMesh::_reallocate_original_ids() {
 		_surface_original_ids[i] = new_original_id;
 	}
 
-	for (uint32_t &original_id : _inner->_meshgl.runOriginalID) {
+	for (uint32_t &original_id : _inner->_meshgl.write().runOriginalID) {
 		ERR_CONTINUE(!replace.has(original_id));
 		original_id = replace.get(original_id);
 	}
 
 	_inner->_has_bad_original_ids = false;
 	_inner->_manifold_dirty = true;
+	_inner->_has_content_hash = false;
 	emit_changed();
 }
 
@@ -1154,6 +2125,44 @@ static Variant _encode_custom_array(Mesh::ArrayCustomFormat format, const Packed
 	ERR_FAIL_V(Variant());
 }
 
+// bucket the runs once so each surface only visits its own runs
+template <typename Mesh>
+static HashMap<uint32_t, LocalVector<uint32_t>> bucket_runs(const Mesh &p_mesh) {
+	HashMap<uint32_t, LocalVector<uint32_t>> runs_by_original_id;
+	for (size_t run = 0; run + 1 < p_mesh.runIndex.size(); run++) {
+		runs_by_original_id[p_mesh.runOriginalID[run]].push_back(run);
+	}
+	return runs_by_original_id;
+}
+
+// Each property vertex a surface uses becomes one of its vertices, numbered in the order the
+// triangles first reach it; manifold already split property vertices along every seam. Returns the
+// property vertex behind each surface vertex, and appends the surface's indices if asked.
+// local_index must be all -1, and is left that way.
+template <typename Mesh>
+static LocalVector<uint32_t> number_surface_vertices(const Mesh &p_mesh, const LocalVector<uint32_t> &p_runs, LocalVector<int32_t> &r_local_index, PackedInt32Array *r_indices) {
+	LocalVector<uint32_t> vertices;
+	for (const uint32_t run : p_runs) {
+		for (size_t j0 = p_mesh.runIndex[run]; j0 < p_mesh.runIndex[run + 1]; j0 += 3) {
+			for (size_t j : { j0 + 0, j0 + 2, j0 + 1 }) {
+				const uint32_t vertex = p_mesh.triVerts[j];
+				if (r_local_index[vertex] < 0) {
+					r_local_index[vertex] = vertices.size();
+					vertices.push_back(vertex);
+				}
+				if (r_indices) {
+					r_indices->append(r_local_index[vertex]);
+				}
+			}
+		}
+	}
+
+	for (const uint32_t vertex : vertices) {
+		r_local_index[vertex] = -1;
+	}
+	return vertices;
+}
+
 void ManifoldMesh::_commit_to_arrays() const {
 	_ensure_meshgl();
 
@@ -1161,20 +2170,36 @@ void ManifoldMesh::_commit_to_arrays() const {
 		return;
 	}
 
+	MANIFOLD_PROFILE_ZONE(ZONE_COMMIT_TO_ARRAYS);
 	_inner->_arrays.resize(_surface_materials.size());
+	_inner->_array_vertices.reset();
+	_inner->_array_vertices.resize(_surface_materials.size());
+	_inner->_vertex_cache_statistics = Inner::VertexCacheStatistics();
+	_inner->_lods.clear();
+	_inner->_shadow_arrays.clear();
+	_inner->_shadow_remap.clear();
+
+	const HashMap<uint32_t, LocalVector<uint32_t>> runs_by_original_id = bucket_runs(*_inner->_meshgl);
+	const LocalVector<uint32_t> no_runs;
+	LocalVector<int32_t> local_index;
+	local_index.resize(_inner->_meshgl->NumVert());
+	std::fill(local_index.ptr(), local_index.ptr() + local_index.size(), -1);
 
 	for (int32_t i = 0; i < _surface_materials.size(); i++) {
 		Array array;
 		array.resize(Mesh::ARRAY_MAX);
 
 		if (likely(i < _surface_original_ids.size())) {
+			PackedInt32Array indices;
 			PackedVector3Array positions, normals;
 			PackedVector2Array tex_uv, tex_uv2;
 			PackedColorArray colors, custom0, custom1, custom2, custom3;
 
-			_unpack_to_arrays(_surface_original_ids[i], positions, normals, tex_uv, tex_uv2, colors, custom0, custom1, custom2, custom3);
+			const LocalVector<uint32_t> *runs = runs_by_original_id.getptr(_surface_original_ids[i]);
+			_unpack_to_arrays(runs ? *runs : no_runs, local_index, _inner->_array_vertices[i], indices, positions, normals, tex_uv, tex_uv2, colors, custom0, custom1, custom2, custom3);
 
 			const BitField<ArrayFormat> format = _surface_get_format(i);
+			array[ARRAY_INDEX] = indices;
 			if (format.has_flag(ARRAY_FORMAT_VERTEX)) {
 				array[ARRAY_VERTEX] = positions;
 			}
@@ -1219,71 +2244,255 @@ void ManifoldMesh::_commit_to_arrays() const {
 	}
 }
 
-void ManifoldMesh::_unpack_to_arrays(uint32_t original_id, PackedVector3Array &positions, PackedVector3Array &normals, PackedVector2Array &tex_uv, PackedVector2Array &tex_uv2, PackedColorArray &colors, PackedColorArray &custom0, PackedColorArray &custom1, PackedColorArray &custom2, PackedColorArray &custom3) const {
-	DEV_ASSERT(!_inner->_meshgl_dirty);
+// the level of detail chain stops once a level would be fewer triangles than this, or once it has
+// this many levels; a level is only kept when it is noticeably smaller than the one before it
+constexpr size_t LOD_MIN_TRIANGLES = 32;
+constexpr int32_t LOD_MAX_LEVELS = 8;
+constexpr double LOD_MIN_REDUCTION = 0.8;
+// the first level's tolerance, relative to the longest side of the bounding box
+constexpr double LOD_FIRST_TOLERANCE = 0.002;
 
-	size_t num_runs = _inner->_meshgl.runIndex.size() - 1;
-	for (size_t i = 0; i < num_runs; i++) {
-		if (_inner->_meshgl.runOriginalID[i] != original_id) {
-			continue;
+template <typename Mesh>
+static uint64_t hash_property_vertex(const Mesh &p_mesh, uint32_t p_vertex) {
+	ManifoldHasher hasher;
+	hasher.add_bytes(&p_mesh.vertProperties[p_vertex * p_mesh.numProp], p_mesh.numProp * sizeof(p_mesh.vertProperties[0]));
+	return hasher.finish().a;
+}
+
+void ManifoldMesh::_ensure_lods() const {
+	_commit_to_arrays();
+
+	if (likely(_inner->_lods.size() == _surface_materials.size())) {
+		return;
+	}
+
+	_inner->_lods.resize(_surface_materials.size());
+	if (unlikely(!is_valid()) || _inner->_meshgl->NumTri() < 2 * LOD_MIN_TRIANGLES) {
+		return;
+	}
+
+	MANIFOLD_PROFILE_ZONE(ZONE_GENERATE_LODS);
+	const manifold::MeshGLP<Precision, I> &mesh = *_inner->_meshgl;
+	const HashMap<uint32_t, LocalVector<uint32_t>> runs_by_original_id = bucket_runs(mesh);
+	const int32_t surface_count = MIN(_surface_materials.size(), _surface_original_ids.size());
+
+	// Simplify only collapses edges onto vertices that are already there and keeps their properties,
+	// so every vertex of a level can be found in the surface's own vertex array by its properties.
+	LocalVector<HashMap<uint64_t, int32_t>> surface_vertices;
+	LocalVector<int64_t> previous_index_count;
+	surface_vertices.resize(surface_count);
+	previous_index_count.resize(surface_count);
+	for (int32_t i = 0; i < surface_count; i++) {
+		const LocalVector<uint32_t> &vertices = _inner->_array_vertices[i];
+		for (uint32_t vertex = 0; vertex < vertices.size(); vertex++) {
+			// identical vertices render identically, so the first one will do
+			const uint64_t key = hash_property_vertex(mesh, vertices[vertex]);
+			if (!surface_vertices[i].has(key)) {
+				surface_vertices[i].insert(key, vertex);
+			}
 		}
+		previous_index_count[i] = _inner->_arrays[i][ARRAY_INDEX].operator PackedInt32Array().size();
+	}
 
-		const size_t first_index = _inner->_meshgl.runIndex[i];
-		const size_t last_index = _inner->_meshgl.runIndex[i + 1];
-		for (size_t j0 = first_index; j0 < last_index; j0 += 3) {
-			for (size_t j : { j0 + 0, j0 + 2, j0 + 1 }) {
-				const uint32_t vertex = _inner->_meshgl.triVerts[j] * _inner->_meshgl.numProp;
+	double tolerance = MAX(manifold::la::maxelem(_inner->_manifold.BoundingBox().Size()) * LOD_FIRST_TOLERANCE, _inner->_manifold.GetTolerance());
+	double error = 0.0;
 
-				DEV_ASSERT(_inner->_meshgl.numProp >= 3);
-				if (_inner->_meshgl.numProp >= 3) {
-					positions.append(Vector3(_inner->_meshgl.vertProperties[vertex], _inner->_meshgl.vertProperties[vertex + 1], _inner->_meshgl.vertProperties[vertex + 2]));
-				}
+	// each level simplifies the one before, so its error is at most the sum of the tolerances so far
+	manifold::Manifold level = _inner->_manifold;
+	for (int32_t level_index = 0; level_index < LOD_MAX_LEVELS; level_index++, tolerance *= 2.0) {
+		level = level.Simplify(tolerance);
+		error += tolerance;
+		if (level.NumTri() < LOD_MIN_TRIANGLES) {
+			break;
+		}
 
-				DEV_ASSERT(_inner->_meshgl.numProp <= 3 || _inner->_meshgl.numProp >= 6);
-				if (_inner->_meshgl.numProp >= 6) {
-					normals.append(Vector3(_inner->_meshgl.vertProperties[vertex + 3], _inner->_meshgl.vertProperties[vertex + 4], _inner->_meshgl.vertProperties[vertex + 5]));
-				}
+#ifdef REAL_T_IS_DOUBLE
+		const manifold::MeshGLP<Precision, I> level_mesh = level.GetMeshGL64(0);
+#else
+		const manifold::MeshGLP<Precision, I> level_mesh = level.GetMeshGL(0);
+#endif
+		const HashMap<uint32_t, LocalVector<uint32_t>> level_runs_by_original_id = bucket_runs(level_mesh);
 
-				DEV_ASSERT(_inner->_meshgl.numProp <= 6 || _inner->_meshgl.numProp >= 8);
-				if (_inner->_meshgl.numProp >= 8) {
-					tex_uv.append(Vector2(_inner->_meshgl.vertProperties[vertex + 6], _inner->_meshgl.vertProperties[vertex + 7]));
-				}
+		for (int32_t i = 0; i < surface_count; i++) {
+			const LocalVector<uint32_t> *runs = level_runs_by_original_id.getptr(_surface_original_ids[i]);
+			if (!runs || surface_vertices[i].is_empty()) {
+				continue;
+			}
 
-				DEV_ASSERT(_inner->_meshgl.numProp <= 8 || _inner->_meshgl.numProp >= 10);
-				if (_inner->_meshgl.numProp >= 10) {
-					tex_uv2.append(Vector2(_inner->_meshgl.vertProperties[vertex + 8], _inner->_meshgl.vertProperties[vertex + 9]));
+			PackedInt32Array indices;
+			bool complete = true;
+			for (const uint32_t run : *runs) {
+				for (size_t j0 = level_mesh.runIndex[run]; complete && j0 < level_mesh.runIndex[run + 1]; j0 += 3) {
+					int32_t triangle[3];
+					int32_t k = 0;
+					for (size_t j : { j0 + 0, j0 + 2, j0 + 1 }) {
+						const int32_t *index = surface_vertices[i].getptr(hash_property_vertex(level_mesh, level_mesh.triVerts[j]));
+						if (unlikely(!index)) {
+							complete = false;
+							break;
+						}
+						triangle[k++] = *index;
+					}
+					if (complete && triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[2] != triangle[0]) {
+						indices.append(triangle[0]);
+						indices.append(triangle[1]);
+						indices.append(triangle[2]);
+					}
 				}
+			}
 
-				DEV_ASSERT(_inner->_meshgl.numProp <= 10 || _inner->_meshgl.numProp >= 14);
-				if (_inner->_meshgl.numProp >= 14) {
-					colors.append(Color(_inner->_meshgl.vertProperties[vertex + 10], _inner->_meshgl.vertProperties[vertex + 11], _inner->_meshgl.vertProperties[vertex + 12], _inner->_meshgl.vertProperties[vertex + 13]));
+			// a level that moved a vertex can't share the surface's vertex array, so that surface
+			// just skips the level
+			if (complete && !indices.is_empty() && indices.size() < previous_index_count[i] * LOD_MIN_REDUCTION) {
+				if (_optimize_vertex_cache) {
+					// the vertices are shared with the full detail surface, so only the triangle order can change
+					optimize_vertex_cache(indices.ptrw(), indices.size(), _inner->_array_vertices[i].size());
 				}
+				_inner->_lods.write[i][error] = indices;
+				previous_index_count[i] = indices.size();
+			}
+		}
+	}
+}
 
-				DEV_ASSERT(_inner->_meshgl.numProp <= 14 || _inner->_meshgl.numProp >= 18);
-				if (_inner->_meshgl.numProp >= 18) {
-					custom0.append(Color(_inner->_meshgl.vertProperties[vertex + 14], _inner->_meshgl.vertProperties[vertex + 15], _inner->_meshgl.vertProperties[vertex + 16], _inner->_meshgl.vertProperties[vertex + 17]));
-				}
+void ManifoldMesh::_ensure_shadow() const {
+	_commit_to_arrays();
 
-				DEV_ASSERT(_inner->_meshgl.numProp <= 18 || _inner->_meshgl.numProp >= 22);
-				if (_inner->_meshgl.numProp >= 22) {
-					custom1.append(Color(_inner->_meshgl.vertProperties[vertex + 18], _inner->_meshgl.vertProperties[vertex + 19], _inner->_meshgl.vertProperties[vertex + 20], _inner->_meshgl.vertProperties[vertex + 21]));
-				}
+	if (likely(_inner->_shadow_arrays.size() == _surface_materials.size())) {
+		return;
+	}
 
-				DEV_ASSERT(_inner->_meshgl.numProp <= 22 || _inner->_meshgl.numProp >= 26);
-				if (_inner->_meshgl.numProp >= 26) {
-					custom2.append(Color(_inner->_meshgl.vertProperties[vertex + 22], _inner->_meshgl.vertProperties[vertex + 23], _inner->_meshgl.vertProperties[vertex + 24], _inner->_meshgl.vertProperties[vertex + 25]));
-				}
+	const manifold::MeshGLP<Precision, I> &mesh = *_inner->_meshgl;
+	_inner->_shadow_arrays.resize(_surface_materials.size());
+	_inner->_shadow_remap.resize(_surface_materials.size());
+
+	// shadows only need positions, so the property vertices manifold split along seams are welded
+	// back into the vertex they came from. Each shadow surface still gets its own vertex numbering
+	// (shadow_index is reset after every surface), since the renderer pairs shadow surfaces with mesh
+	// surfaces by index and a surface can't index into another one's vertex buffer
+	LocalVector<uint32_t> welded;
+	welded.resize(mesh.NumVert());
+	for (uint32_t vertex = 0; vertex < welded.size(); vertex++) {
+		welded[vertex] = vertex;
+	}
+	for (size_t i = 0; i < mesh.mergeFromVert.size(); i++) {
+		welded[mesh.mergeFromVert[i]] = mesh.mergeToVert[i];
+	}
 
-				DEV_ASSERT(_inner->_meshgl.numProp <= 26 || _inner->_meshgl.numProp >= 30);
-				if (_inner->_meshgl.numProp >= 30) {
-					custom3.append(Color(_inner->_meshgl.vertProperties[vertex + 26], _inner->_meshgl.vertProperties[vertex + 27], _inner->_meshgl.vertProperties[vertex + 28], _inner->_meshgl.vertProperties[vertex + 29]));
-				}
+	LocalVector<int32_t> shadow_index;
+	shadow_index.resize(mesh.NumVert());
+	std::fill(shadow_index.ptr(), shadow_index.ptr() + shadow_index.size(), -1);
+
+	for (int32_t i = 0; i < _surface_materials.size(); i++) {
+		const LocalVector<uint32_t> &vertices = _inner->_array_vertices[i];
+
+		PackedVector3Array positions;
+		PackedInt32Array remap;
+		remap.resize(vertices.size());
+		LocalVector<uint32_t> used;
+		for (uint32_t vertex = 0; vertex < vertices.size(); vertex++) {
+			const uint32_t target = welded[vertices[vertex]];
+			if (shadow_index[target] < 0) {
+				shadow_index[target] = positions.size();
+				used.push_back(target);
+				const uint32_t offset = target * mesh.numProp;
+				positions.append(Vector3(mesh.vertProperties[offset], mesh.vertProperties[offset + 1], mesh.vertProperties[offset + 2]));
 			}
+			remap.set(vertex, shadow_index[target]);
+		}
+		for (const uint32_t target : used) {
+			shadow_index[target] = -1;
+		}
+
+		PackedInt32Array indices = _inner->_arrays[i][ARRAY_INDEX];
+		int32_t *ptrw = indices.ptrw();
+		for (int64_t j = 0; j < indices.size(); j++) {
+			ptrw[j] = remap[ptrw[j]];
+		}
+
+		Array array;
+		array.resize(Mesh::ARRAY_MAX);
+		array[ARRAY_VERTEX] = positions;
+		array[ARRAY_INDEX] = indices;
+		_inner->_shadow_arrays.write[i] = array;
+		_inner->_shadow_remap.write[i] = remap;
+	}
+}
+
+void ManifoldMesh::_unpack_to_arrays(const LocalVector<uint32_t> &runs, LocalVector<int32_t> &local_index, LocalVector<uint32_t> &vertices, PackedInt32Array &indices, PackedVector3Array &positions, PackedVector3Array &normals, PackedVector2Array &tex_uv, PackedVector2Array &tex_uv2, PackedColorArray &colors, PackedColorArray &custom0, PackedColorArray &custom1, PackedColorArray &custom2, PackedColorArray &custom3) const {
+	DEV_ASSERT(!_inner->_meshgl_dirty);
+
+	vertices = number_surface_vertices(*_inner->_meshgl, runs, local_index, &indices);
+
+	Inner::VertexCacheStatistics &statistics = _inner->_vertex_cache_statistics;
+	statistics.triangles += indices.size() / 3;
+	statistics.vertices += vertices.size();
+	statistics.misses_before += vertex_cache_misses(indices.ptr(), indices.size(), vertices.size());
+	if (_optimize_vertex_cache) {
+		const manifold::MeshGLP<Precision, I> &mesh = *_inner->_meshgl;
+		const auto position = [&mesh, &vertices](int32_t p_vertex) -> manifold::vec3 {
+			const Precision *vert = &mesh.vertProperties[vertices[p_vertex] * mesh.numProp];
+			return { double(vert[0]), double(vert[1]), double(vert[2]) };
+		};
+
+		int32_t *ptrw = indices.ptrw();
+		optimize_vertex_cache(ptrw, indices.size(), vertices.size());
+		optimize_overdraw(ptrw, indices.size(), vertices.size(), position);
+		optimize_vertex_fetch(ptrw, indices.size(), vertices);
+	}
+	statistics.misses_after += vertex_cache_misses(indices.ptr(), indices.size(), vertices.size());
+	for (const uint32_t i : vertices) {
+		const uint32_t vertex = i * _inner->_meshgl->numProp;
+
+		DEV_ASSERT(_inner->_meshgl->numProp >= 3);
+		if (_inner->_meshgl->numProp >= 3) {
+			positions.append(Vector3(_inner->_meshgl->vertProperties[vertex], _inner->_meshgl->vertProperties[vertex + 1], _inner->_meshgl->vertProperties[vertex + 2]));
+		}
+
+		DEV_ASSERT(_inner->_meshgl->numProp <= 3 || _inner->_meshgl->numProp >= 6);
+		if (_inner->_meshgl->numProp >= 6) {
+			normals.append(Vector3(_inner->_meshgl->vertProperties[vertex + 3], _inner->_meshgl->vertProperties[vertex + 4], _inner->_meshgl->vertProperties[vertex + 5]));
+		}
+
+		DEV_ASSERT(_inner->_meshgl->numProp <= 6 || _inner->_meshgl->numProp >= 8);
+		if (_inner->_meshgl->numProp >= 8) {
+			tex_uv.append(Vector2(_inner->_meshgl->vertProperties[vertex + 6], _inner->_meshgl->vertProperties[vertex + 7]));
+		}
+
+		DEV_ASSERT(_inner->_meshgl->numProp <= 8 || _inner->_meshgl->numProp >= 10);
+		if (_inner->_meshgl->numProp >= 10) {
+			tex_uv2.append(Vector2(_inner->_meshgl->vertProperties[vertex + 8], _inner->_meshgl->vertProperties[vertex + 9]));
+		}
+
+		DEV_ASSERT(_inner->_meshgl->numProp <= 10 || _inner->_meshgl->numProp >= 14);
+		if (_inner->_meshgl->numProp >= 14) {
+			colors.append(Color(_inner->_meshgl->vertProperties[vertex + 10], _inner->_meshgl->vertProperties[vertex + 11], _inner->_meshgl->vertProperties[vertex + 12], _inner->_meshgl->vertProperties[vertex + 13]));
+		}
+
+		DEV_ASSERT(_inner->_meshgl->numProp <= 14 || _inner->_meshgl->numProp >= 18);
+		if (_inner->_meshgl->numProp >= 18) {
+			custom0.append(Color(_inner->_meshgl->vertProperties[vertex + 14], _inner->_meshgl->vertProperties[vertex + 15], _inner->_meshgl->vertProperties[vertex + 16], _inner->_meshgl->vertProperties[vertex + 17]));
+		}
+
+		DEV_ASSERT(_inner->_meshgl->numProp <= 18 || _inner->_meshgl->numProp >= 22);
+		if (_inner->_meshgl->numProp >= 22) {
+			custom1.append(Color(_inner->_meshgl->vertProperties[vertex + 18], _inner->_meshgl->vertProperties[vertex + 19], _inner->_meshgl->vertProperties[vertex + 20], _inner->_meshgl->vertProperties[vertex + 21]));
+		}
+
+		DEV_ASSERT(_inner->_meshgl->numProp <= 22 || _inner->_meshgl->numProp >= 26);
+		if (_inner->_meshgl->numProp >= 26) {
+			custom2.append(Color(_inner->_meshgl->vertProperties[vertex + 22], _inner->_meshgl->vertProperties[vertex + 23], _inner->_meshgl->vertProperties[vertex + 24], _inner->_meshgl->vertProperties[vertex + 25]));
+		}
+
+		DEV_ASSERT(_inner->_meshgl->numProp <= 26 || _inner->_meshgl->numProp >= 30);
+		if (_inner->_meshgl->numProp >= 30) {
+			custom3.append(Color(_inner->_meshgl->vertProperties[vertex + 26], _inner->_meshgl->vertProperties[vertex + 27], _inner->_meshgl->vertProperties[vertex + 28], _inner->_meshgl->vertProperties[vertex + 29]));
 		}
 	}
 }
 
 void ManifoldMesh::_init_normals(const Array &arrays, I vertex, I stride) {
+	manifold::MeshGLP<Precision, I> &meshgl = _inner->_meshgl.write();
 	PackedVector3Array normals;
 	if (likely(arrays[ARRAY_NORMAL] != Variant())) {
 		normals = arrays[ARRAY_NORMAL];
@@ -1300,13 +2509,14 @@ void ManifoldMesh::_init_normals(const Array &arrays, I vertex, I stride) {
 	}
 
 	for (I i = 0; i < normals.size(); i++) {
-		_inner->_meshgl.vertProperties[vertex * stride + 3] = normals[i].x;
-		_inner->_meshgl.vertProperties[vertex * stride + 4] = normals[i].y;
-		_inner->_meshgl.vertProperties[vertex * stride + 5] = normals[i].z;
+		meshgl.vertProperties[vertex * stride + 3] = normals[i].x;
+		meshgl.vertProperties[vertex * stride + 4] = normals[i].y;
+		meshgl.vertProperties[vertex * stride + 5] = normals[i].z;
 		vertex++;
 	}
 }
 void ManifoldMesh::_init_tex_uv(const Array &arrays, I vertex, I stride) {
+	manifold::MeshGLP<Precision, I> &meshgl = _inner->_meshgl.write();
 	PackedVector2Array uv;
 	if (likely(arrays[ARRAY_TEX_UV] != Variant())) {
 		uv = arrays[ARRAY_TEX_UV];
@@ -1315,12 +2525,13 @@ void ManifoldMesh::_init_tex_uv(const Array &arrays, I vertex, I stride) {
 	}
 
 	for (I i = 0; i < uv.size(); i++) {
-		_inner->_meshgl.vertProperties[vertex * stride + 6] = uv[i].x;
-		_inner->_meshgl.vertProperties[vertex * stride + 7] = uv[i].y;
+		meshgl.vertProperties[vertex * stride + 6] = uv[i].x;
+		meshgl.vertProperties[vertex * stride + 7] = uv[i].y;
 		vertex++;
 	}
 }
 void ManifoldMesh::_init_tex_uv2(const Array &arrays, I vertex, I stride) {
+	manifold::MeshGLP<Precision, I> &meshgl = _inner->_meshgl.write();
 	PackedVector2Array uv;
 	if (likely(arrays[ARRAY_TEX_UV2] != Variant())) {
 		uv = arrays[ARRAY_TEX_UV2];
@@ -1329,12 +2540,13 @@ void ManifoldMesh::_init_tex_uv2(const Array &arrays, I vertex, I stride) {
 	}
 
 	for (I i = 0; i < uv.size(); i++) {
-		_inner->_meshgl.vertProperties[vertex * stride + 8] = uv[i].x;
-		_inner->_meshgl.vertProperties[vertex * stride + 9] = uv[i].y;
+		meshgl.vertProperties[vertex * stride + 8] = uv[i].x;
+		meshgl.vertProperties[vertex * stride + 9] = uv[i].y;
 		vertex++;
 	}
 }
 void ManifoldMesh::_init_color(const Array &arrays, I vertex, I stride) {
+	manifold::MeshGLP<Precision, I> &meshgl = _inner->_meshgl.write();
 	PackedColorArray color;
 	if (likely(arrays[ARRAY_COLOR] != Variant())) {
 		color = arrays[ARRAY_COLOR];
@@ -1345,20 +2557,21 @@ void ManifoldMesh::_init_color(const Array &arrays, I vertex, I stride) {
 	}
 
 	for (I i = 0; i < color.size(); i++) {
-		_inner->_meshgl.vertProperties[vertex * stride + 10] = color[i].r;
-		_inner->_meshgl.vertProperties[vertex * stride + 11] = color[i].g;
-		_inner->_meshgl.vertProperties[vertex * stride + 12] = color[i].b;
-		_inner->_meshgl.vertProperties[vertex * stride + 13] = color[i].a;
+		meshgl.vertProperties[vertex * stride + 10] = color[i].r;
+		meshgl.vertProperties[vertex * stride + 11] = color[i].g;
+		meshgl.vertProperties[vertex * stride + 12] = color[i].b;
+		meshgl.vertProperties[vertex * stride + 13] = color[i].a;
 		vertex++;
 	}
 }
 void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offset, ArrayType type, ArrayCustomFormat custom_format) {
+	manifold::MeshGLP<Precision, I> &meshgl = _inner->_meshgl.write();
 	if (unlikely(arrays[type] == Variant())) {
 		for (I i = 0; i < arrays[ARRAY_VERTEX].operator PackedVector3Array().size(); i++) {
-			_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = 0;
-			_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = 0;
-			_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = 0;
-			_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = 0;
+			meshgl.vertProperties[vertex * stride + offset + 0] = 0;
+			meshgl.vertProperties[vertex * stride + offset + 1] = 0;
+			meshgl.vertProperties[vertex * stride + offset + 2] = 0;
+			meshgl.vertProperties[vertex * stride + offset + 3] = 0;
 			vertex++;
 		}
 
@@ -1374,10 +2587,10 @@ void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offse
 			DEV_ASSERT(bytes.size() % 4 == 0);
 
 			for (I i = 0; i < bytes.size(); i += 4) {
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = bytes[i + 0] / 255.0f;
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = bytes[i + 1] / 255.0f;
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = bytes[i + 2] / 255.0f;
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = bytes[i + 3] / 255.0f;
+				meshgl.vertProperties[vertex * stride + offset + 0] = bytes[i + 0] / 255.0f;
+				meshgl.vertProperties[vertex * stride + offset + 1] = bytes[i + 1] / 255.0f;
+				meshgl.vertProperties[vertex * stride + offset + 2] = bytes[i + 2] / 255.0f;
+				meshgl.vertProperties[vertex * stride + offset + 3] = bytes[i + 3] / 255.0f;
 				vertex++;
 			}
 
@@ -1387,10 +2600,10 @@ void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offse
 			DEV_ASSERT(bytes.size() % 4 == 0);
 
 			for (I i = 0; i < bytes.size(); i += 4) {
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = Math::max(int8_t(bytes[i + 0]) / 127.0f, -1.0f);
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = Math::max(int8_t(bytes[i + 1]) / 127.0f, -1.0f);
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = Math::max(int8_t(bytes[i + 2]) / 127.0f, -1.0f);
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = Math::max(int8_t(bytes[i + 3]) / 127.0f, -1.0f);
+				meshgl.vertProperties[vertex * stride + offset + 0] = Math::max(int8_t(bytes[i + 0]) / 127.0f, -1.0f);
+				meshgl.vertProperties[vertex * stride + offset + 1] = Math::max(int8_t(bytes[i + 1]) / 127.0f, -1.0f);
+				meshgl.vertProperties[vertex * stride + offset + 2] = Math::max(int8_t(bytes[i + 2]) / 127.0f, -1.0f);
+				meshgl.vertProperties[vertex * stride + offset + 3] = Math::max(int8_t(bytes[i + 3]) / 127.0f, -1.0f);
 				vertex++;
 			}
 
@@ -1400,10 +2613,10 @@ void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offse
 			DEV_ASSERT(bytes.size() % 4 == 0);
 
 			for (I i = 0; i < bytes.size(); i += 4) {
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = bytes.decode_half(i + 0);
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = bytes.decode_half(i + 2);
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = 0;
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = 0;
+				meshgl.vertProperties[vertex * stride + offset + 0] = bytes.decode_half(i + 0);
+				meshgl.vertProperties[vertex * stride + offset + 1] = bytes.decode_half(i + 2);
+				meshgl.vertProperties[vertex * stride + offset + 2] = 0;
+				meshgl.vertProperties[vertex * stride + offset + 3] = 0;
 				vertex++;
 			}
 
@@ -1413,10 +2626,10 @@ void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offse
 			DEV_ASSERT(bytes.size() % 8 == 0);
 
 			for (I i = 0; i < bytes.size(); i += 4) {
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = bytes.decode_half(i + 0);
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = bytes.decode_half(i + 2);
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = bytes.decode_half(i + 4);
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = bytes.decode_half(i + 6);
+				meshgl.vertProperties[vertex * stride + offset + 0] = bytes.decode_half(i + 0);
+				meshgl.vertProperties[vertex * stride + offset + 1] = bytes.decode_half(i + 2);
+				meshgl.vertProperties[vertex * stride + offset + 2] = bytes.decode_half(i + 4);
+				meshgl.vertProperties[vertex * stride + offset + 3] = bytes.decode_half(i + 6);
 				vertex++;
 			}
 
@@ -1426,10 +2639,10 @@ void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offse
 			DEV_ASSERT(floats.size() % 1 == 0);
 
 			for (I i = 0; i < floats.size(); i++) {
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = floats[i + 0];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = 0;
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = 0;
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = 0;
+				meshgl.vertProperties[vertex * stride + offset + 0] = floats[i + 0];
+				meshgl.vertProperties[vertex * stride + offset + 1] = 0;
+				meshgl.vertProperties[vertex * stride + offset + 2] = 0;
+				meshgl.vertProperties[vertex * stride + offset + 3] = 0;
 				vertex++;
 			}
 
@@ -1439,10 +2652,10 @@ void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offse
 			DEV_ASSERT(floats.size() % 2 == 0);
 
 			for (I i = 0; i < floats.size(); i += 2) {
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = floats[i + 0];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = floats[i + 1];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = 0;
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = 0;
+				meshgl.vertProperties[vertex * stride + offset + 0] = floats[i + 0];
+				meshgl.vertProperties[vertex * stride + offset + 1] = floats[i + 1];
+				meshgl.vertProperties[vertex * stride + offset + 2] = 0;
+				meshgl.vertProperties[vertex * stride + offset + 3] = 0;
 				vertex++;
 			}
 
@@ -1452,10 +2665,10 @@ void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offse
 			DEV_ASSERT(floats.size() % 3 == 0);
 
 			for (I i = 0; i < floats.size(); i += 3) {
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = floats[i + 0];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = floats[i + 1];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = floats[i + 2];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = 0;
+				meshgl.vertProperties[vertex * stride + offset + 0] = floats[i + 0];
+				meshgl.vertProperties[vertex * stride + offset + 1] = floats[i + 1];
+				meshgl.vertProperties[vertex * stride + offset + 2] = floats[i + 2];
+				meshgl.vertProperties[vertex * stride + offset + 3] = 0;
 				vertex++;
 			}
 
@@ -1465,10 +2678,10 @@ void ManifoldMesh::_init_custom(const Array &arrays, I vertex, I stride, I offse
 			DEV_ASSERT(floats.size() % 4 == 0);
 
 			for (I i = 0; i < floats.size(); i += 4) {
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 0] = floats[i + 0];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 1] = floats[i + 1];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 2] = floats[i + 2];
-				_inner->_meshgl.vertProperties[vertex * stride + offset + 3] = floats[i + 3];
+				meshgl.vertProperties[vertex * stride + offset + 0] = floats[i + 0];
+				meshgl.vertProperties[vertex * stride + offset + 1] = floats[i + 1];
+				meshgl.vertProperties[vertex * stride + offset + 2] = floats[i + 2];
+				meshgl.vertProperties[vertex * stride + offset + 3] = floats[i + 3];
 				vertex++;
 			}
 
@@ -1506,15 +2719,17 @@ Ref<ManifoldMesh> ManifoldMesh::_new_merged_manifold(const manifold::Manifold &n
 	m->_inner->_meshgl_dirty = true;
 	m->_inner->_has_bad_original_ids = false;
 
+	HashMap<uint32_t, int64_t> surface_by_original_id;
 	for (const Ref<ManifoldMesh> &original : originals) {
 		for (int32_t i = 0; i < original->_surface_original_ids.size(); i++) {
 			const uint32_t original_id = original->_surface_original_ids[i];
-			const int64_t index = m->_surface_original_ids.find(original_id);
-			if (index != -1) {
-				m->_surface_formats[index] |= original->_surface_get_format(i);
+			const int64_t *index = surface_by_original_id.getptr(original_id);
+			if (index) {
+				m->_surface_formats[*index] |= original->_surface_get_format(i);
 				continue;
 			}
 
+			surface_by_original_id.insert(original_id, m->_surface_original_ids.size());
 			m->_surface_formats.append(original->_surface_get_format(i));
 			m->_surface_original_ids.append(original_id);
 			m->_surface_materials.append(original->_surface_get_material(i));
@@ -1533,6 +2748,7 @@ Ref<ManifoldMesh> ManifoldMesh::_new_manifold(const manifold::Manifold &new_mani
 	m->_surface_original_ids = const_cast<PackedInt32Array *>(&_surface_original_ids)->duplicate();
 	m->_surface_materials = _surface_materials.duplicate();
 	m->_surface_names = const_cast<PackedStringArray *>(&_surface_names)->duplicate();
+	m->_copy_settings(this);
 
 	m->_inner->_manifold = new_manifold;
 	m->_inner->_meshgl_dirty = true;
@@ -1562,18 +2778,62 @@ Ref<ManifoldMesh> ManifoldMesh::_modify_color(const int32_t min_prop, const Call
 		p_new_prop[min_prop + 3] = color.a;
 	}));
 }
-Ref<ManifoldMesh> ManifoldMesh::_halfspace(const Plane &p_plane, const Ref<Material> &p_material) const {
-	_ensure_manifold();
+manifold::Manifold ManifoldMesh::_halfspace(const Plane &p_plane, uint32_t p_original_id) const {
+	DEV_ASSERT(p_plane.normal.is_normalized());
+	DEV_ASSERT(!_inner->_manifold_dirty);
+
+	// same extents as the halfspace in manifold.cpp, but built directly as a MeshGL so that the cap faces
+	// come out of the boolean with the material's original ID, an outward normal, and planar UVs.
+	const manifold::Box bounds = _inner->_manifold.BoundingBox();
+	const manifold::vec3 normal = to_vec3(p_plane.normal);
+	const manifold::vec3 tangent = manifold::la::normalize(std::abs(normal.x) > std::abs(normal.z) ? manifold::vec3(-normal.y, normal.x, 0.0) : manifold::vec3(0.0, -normal.z, normal.y));
+	const manifold::vec3 bitangent = manifold::la::cross(normal, tangent);
+	const double size = manifold::la::length(bounds.Center() - normal * double(p_plane.d)) + 0.5 * manifold::la::length(bounds.Size());
+
+	manifold::MeshGL64 cutter;
+	cutter.numProp = 8;
+	cutter.vertProperties.resize(8 * cutter.numProp);
+	for (int i = 0; i < 8; i++) {
+		const manifold::vec3 position = normal * (double(p_plane.d) + ((i & 1) ? 2.0 * size : 0.0)) + tangent * ((i & 2) ? size : -size) + bitangent * ((i & 4) ? size : -size);
+		double *vert = &cutter.vertProperties[i * cutter.numProp];
+		vert[0] = position.x;
+		vert[1] = position.y;
+		vert[2] = position.z;
+		// only the face lying on the plane can end up in a result, so every vertex gets its attributes
+		vert[3] = -normal.x;
+		vert[4] = -normal.y;
+		vert[5] = -normal.z;
+		vert[6] = manifold::la::dot(position, tangent);
+		vert[7] = manifold::la::dot(position, bitangent);
+	}
+	cutter.triVerts = {
+		0, 4, 6, 0, 6, 2, // plane
+		1, 3, 7, 1, 7, 5,
+		0, 1, 5, 0, 5, 4,
+		2, 6, 7, 2, 7, 3,
+		0, 2, 3, 0, 3, 1,
+		4, 5, 7, 4, 7, 6
+	};
+	cutter.runIndex = { 0, 36 };
+	cutter.runOriginalID = { p_original_id };
+
+	return manifold::Manifold(cutter);
+}
+
+Ref<ManifoldMesh> ManifoldMesh::_new_cut_manifold(const manifold::Manifold &new_manifold, const Ref<Material> &p_material) const {
+	Ref<ManifoldMesh> m = _new_manifold(new_manifold);
+
+	const uint32_t original_id = get_material_original_id(p_material);
+	const int64_t index = m->_surface_original_ids.find(original_id);
+	if (index != -1) {
+		m->_surface_formats[index] |= ARRAY_FORMAT_VERTEX | ARRAY_FORMAT_NORMAL | ARRAY_FORMAT_TEX_UV;
+		return m;
+	}
 
-	// copied from manifold.cpp
-	manifold::Box bBox = _inner->_manifold.BoundingBox();
-	manifold::vec3 normal = manifold::la::normalize(to_vec3(p_plane.normal));
-	manifold::Manifold cutter = manifold::Manifold::Cube(manifold::vec3(2.0), true).Translate({ 1.0, 0.0, 0.0 });
-	double size = manifold::la::length(bBox.Center() - normal * double(p_plane.d)) + 0.5 * manifold::la::length(bBox.Size());
-	cutter = cutter.Scale(manifold::vec3(size)).Translate({ p_plane.d, 0.0, 0.0 });
-	double yDeg = manifold::degrees(-std::asin(normal.z));
-	double zDeg = manifold::degrees(std::atan2(normal.y, normal.x));
-	cutter = cutter.Rotate(0.0, yDeg, zDeg);
-
-	return _primitive(cutter, p_material, "halfspace");
+	m->_surface_formats.append(ARRAY_FORMAT_VERTEX | ARRAY_FORMAT_NORMAL | ARRAY_FORMAT_TEX_UV);
+	m->_surface_original_ids.append(original_id);
+	m->_surface_materials.append(p_material);
+	m->_surface_names.append("cap");
+
+	return m;
 }
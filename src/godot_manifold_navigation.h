@@ -0,0 +1,507 @@
+#pragma once
+
+#include "godot_manifold_parallel.h"
+
+#include <godot_cpp/templates/hash_map.hpp>
+
+#include <manifold/cross_section.h>
+#include <manifold/manifold.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+// A walkable part of a mesh's surface with a single height over every point of its footprint.
+// Positions are Y-up as in Godot. Footprints are in (x, -z), the surface seen from above, which
+// keeps upward-facing triangles counter-clockwise.
+//
+// A patch split out of a larger connected surface shares that surface's boundary edges (pairs of
+// positions): only those are edges an agent can walk off, not the seams between the patches.
+struct WalkablePatch {
+	std::vector<manifold::vec3> positions;
+	std::vector<manifold::ivec3> triangles;
+	manifold::CrossSection footprint;
+	std::shared_ptr<const std::vector<manifold::vec3>> component_boundary;
+};
+
+static _FORCE_INLINE_ manifold::vec2 navigation_footprint(const manifold::vec3 &p_position) {
+	return manifold::vec2(p_position.x, -p_position.z);
+}
+
+// Turns Y-up into Z-up, so manifold's Project() gives footprint coordinates.
+static _FORCE_INLINE_ manifold::mat3x4 navigation_z_up() {
+	return manifold::mat3x4(manifold::vec3(1.0, 0.0, 0.0), manifold::vec3(0.0, 0.0, 1.0), manifold::vec3(0.0, -1.0, 0.0), manifold::vec3(0.0));
+}
+
+static inline uint32_t navigation_find(std::vector<uint32_t> &r_parents, uint32_t p_item) {
+	while (r_parents[p_item] != p_item) {
+		r_parents[p_item] = r_parents[r_parents[p_item]];
+		p_item = r_parents[p_item];
+	}
+	return p_item;
+}
+
+static inline manifold::CrossSection navigation_patch_footprint(const WalkablePatch &p_patch) {
+	manifold::Polygons triangles;
+	triangles.reserve(p_patch.triangles.size());
+	for (const manifold::ivec3 &triangle : p_patch.triangles) {
+		triangles.push_back({ navigation_footprint(p_patch.positions[triangle.x]), navigation_footprint(p_patch.positions[triangle.y]), navigation_footprint(p_patch.positions[triangle.z]) });
+	}
+	return manifold::CrossSection(triangles, manifold::CrossSection::FillRule::Positive);
+}
+
+// Splits the triangles of a mesh that face up, tilted by no more than p_max_slope radians, into
+// walkable patches: the sets of them joined across edges, except that a set passing over itself (a
+// spiral ramp, say) is split again into its flat pieces, which never do. Those pieces keep the
+// boundary of the whole set, so the agent radius isn't taken off along the seams between them.
+template <typename Precision, typename I>
+std::vector<WalkablePatch> walkable_patches(const manifold::MeshGLP<Precision, I> &p_mesh, double p_max_slope) {
+	const size_t num_vert = p_mesh.NumVert();
+	const size_t num_tri = p_mesh.NumTri();
+	const size_t num_prop = p_mesh.numProp;
+	if (unlikely(num_tri == 0 || num_prop < 3)) {
+		return {};
+	}
+
+	// property vertices that share a position need to share an ID for the triangles to join up
+	std::vector<uint32_t> canonical(num_vert);
+	std::iota(canonical.begin(), canonical.end(), 0);
+	for (size_t i = 0; i < p_mesh.mergeFromVert.size(); i++) {
+		canonical[p_mesh.mergeFromVert[i]] = p_mesh.mergeToVert[i];
+	}
+	const auto vert = [&](size_t p_tri, int32_t p_corner) -> uint32_t {
+		return canonical[p_mesh.triVerts[p_tri * 3 + p_corner]];
+	};
+	const auto position = [&](uint32_t p_vert) -> manifold::vec3 {
+		const Precision *properties = &p_mesh.vertProperties[size_t(p_vert) * num_prop];
+		return { double(properties[0]), double(properties[1]), double(properties[2]) };
+	};
+
+	const double min_up = std::cos(p_max_slope);
+	std::vector<uint32_t> walkable;
+	std::vector<manifold::vec3> normals;
+	for (size_t tri = 0; tri < num_tri; tri++) {
+		const manifold::vec3 a = position(vert(tri, 0));
+		const manifold::vec3 normal = manifold::la::cross(position(vert(tri, 1)) - a, position(vert(tri, 2)) - a);
+		const double length = manifold::la::length(normal);
+		if (length > 0.0 && normal.y > 0.0 && normal.y >= length * min_up) {
+			walkable.push_back(uint32_t(tri));
+			normals.push_back(normal / length);
+		}
+	}
+
+	// join walkable triangles across their edges, and separately only where they lie in one plane
+	godot::HashMap<uint64_t, uint32_t> edge_triangle;
+	edge_triangle.reserve(walkable.size() * 3);
+	for (uint32_t i = 0; i < walkable.size(); i++) {
+		for (int32_t corner = 0; corner < 3; corner++) {
+			edge_triangle.insert(uint64_t(vert(walkable[i], corner)) << 32 | vert(walkable[i], (corner + 1) % 3), i);
+		}
+	}
+	std::vector<uint32_t> joined(walkable.size());
+	std::vector<uint32_t> flat(walkable.size());
+	std::iota(joined.begin(), joined.end(), 0);
+	std::iota(flat.begin(), flat.end(), 0);
+	for (uint32_t i = 0; i < walkable.size(); i++) {
+		for (int32_t corner = 0; corner < 3; corner++) {
+			const uint32_t *twin = edge_triangle.getptr(uint64_t(vert(walkable[i], (corner + 1) % 3)) << 32 | vert(walkable[i], corner));
+			if (!twin) {
+				continue;
+			}
+			joined[navigation_find(joined, i)] = navigation_find(joined, *twin);
+			if (manifold::la::dot(normals[i], normals[*twin]) >= 1.0 - 1e-9) {
+				flat[navigation_find(flat, i)] = navigation_find(flat, *twin);
+			}
+		}
+	}
+
+	// groups p_triangles (indices into walkable) by their root in p_parents, appending to r_patches
+	// and recording the patch of each triangle in patch_of
+	std::vector<uint32_t> patch_of(walkable.size());
+	const auto make_patches = [&](const std::vector<uint32_t> &p_triangles, std::vector<uint32_t> &p_parents, std::vector<WalkablePatch> &r_patches) {
+		const size_t first_patch = r_patches.size();
+		godot::HashMap<uint32_t, uint32_t> root_patch;
+		std::vector<godot::HashMap<uint32_t, int32_t>> local_vertex;
+		for (const uint32_t i : p_triangles) {
+			const uint32_t root = navigation_find(p_parents, i);
+			const uint32_t *existing = root_patch.getptr(root);
+			if (!existing) {
+				existing = &root_patch.insert(root, uint32_t(r_patches.size()))->value;
+				r_patches.emplace_back();
+				local_vertex.emplace_back();
+			}
+			patch_of[i] = *existing;
+			WalkablePatch &patch = r_patches[*existing];
+			godot::HashMap<uint32_t, int32_t> &local = local_vertex[*existing - first_patch];
+			manifold::ivec3 triangle;
+			for (int32_t corner = 0; corner < 3; corner++) {
+				const uint32_t v = vert(walkable[i], corner);
+				const int32_t *index = local.getptr(v);
+				if (index) {
+					triangle[corner] = *index;
+				} else {
+					triangle[corner] = int32_t(patch.positions.size());
+					local.insert(v, triangle[corner]);
+					patch.positions.push_back(position(v));
+				}
+			}
+			patch.triangles.push_back(triangle);
+		}
+	};
+
+	std::vector<uint32_t> all(walkable.size());
+	std::iota(all.begin(), all.end(), 0);
+	std::vector<WalkablePatch> components;
+	make_patches(all, joined, components);
+
+	// a footprint smaller than its triangles means some of them are over others
+	std::vector<uint8_t> overlapping(components.size(), 0);
+	parallel_for(uint32_t(components.size()), [&](uint32_t p_component) {
+		WalkablePatch &component = components[p_component];
+		component.footprint = navigation_patch_footprint(component);
+		double triangle_area = 0.0;
+		for (const manifold::ivec3 &triangle : component.triangles) {
+			const manifold::vec2 a = navigation_footprint(component.positions[triangle.x]);
+			const manifold::vec2 b = navigation_footprint(component.positions[triangle.y]);
+			const manifold::vec2 c = navigation_footprint(component.positions[triangle.z]);
+			triangle_area += 0.5 * ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x));
+		}
+		overlapping[p_component] = triangle_area > component.footprint.Area() * (1.0 + 1e-6) + 1e-9;
+	});
+
+	std::vector<WalkablePatch> patches;
+	std::vector<uint32_t> split;
+	std::vector<std::vector<manifold::vec3>> boundaries(components.size());
+	for (uint32_t i = 0; i < walkable.size(); i++) {
+		if (!overlapping[patch_of[i]]) {
+			continue;
+		}
+		split.push_back(i);
+		for (int32_t corner = 0; corner < 3; corner++) {
+			const uint32_t from = vert(walkable[i], corner);
+			const uint32_t to = vert(walkable[i], (corner + 1) % 3);
+			if (!edge_triangle.has(uint64_t(to) << 32 | from)) {
+				boundaries[patch_of[i]].push_back(position(from));
+				boundaries[patch_of[i]].push_back(position(to));
+			}
+		}
+	}
+	for (size_t i = 0; i < components.size(); i++) {
+		if (!overlapping[i]) {
+			patches.push_back(std::move(components[i]));
+		}
+	}
+	std::vector<std::shared_ptr<const std::vector<manifold::vec3>>> shared_boundaries(components.size());
+	for (size_t i = 0; i < components.size(); i++) {
+		if (overlapping[i]) {
+			shared_boundaries[i] = std::make_shared<const std::vector<manifold::vec3>>(std::move(boundaries[i]));
+		}
+	}
+	const std::vector<uint32_t> component_of = patch_of;
+	const size_t first_flat = patches.size();
+	make_patches(split, flat, patches);
+	for (const uint32_t i : split) {
+		patches[patch_of[i]].component_boundary = shared_boundaries[component_of[i]];
+	}
+	parallel_for(uint32_t(patches.size() - first_flat), [&](uint32_t p_patch) {
+		patches[first_flat + p_patch].footprint = navigation_patch_footprint(patches[first_flat + p_patch]);
+	});
+	return patches;
+}
+
+// The space from p_bottom to p_top above a patch, as a closed mesh: the raised surface twice, the
+// lower copy turned over, and a vertical wall along every boundary edge. Corners only share a vertex
+// where their triangles are joined across an edge at it, so a patch touching itself at a vertex
+// still gives a manifold.
+static inline manifold::Manifold navigation_clearance(const WalkablePatch &p_patch, double p_bottom, double p_top) {
+	const size_t corner_count = p_patch.triangles.size() * 3;
+	const auto corner_vertex = [&](size_t p_corner) -> int32_t {
+		return p_patch.triangles[p_corner / 3][p_corner % 3];
+	};
+	const auto next_corner = [](size_t p_corner) -> size_t {
+		return p_corner - p_corner % 3 + (p_corner + 1) % 3;
+	};
+
+	godot::HashMap<uint64_t, uint32_t> edge_corner;
+	edge_corner.reserve(corner_count);
+	for (size_t corner = 0; corner < corner_count; corner++) {
+		edge_corner.insert(uint64_t(uint32_t(corner_vertex(corner))) << 32 | uint32_t(corner_vertex(next_corner(corner))), uint32_t(corner));
+	}
+	std::vector<uint32_t> parents(corner_count);
+	std::iota(parents.begin(), parents.end(), 0);
+	std::vector<uint8_t> boundary(corner_count, 0);
+	for (size_t corner = 0; corner < corner_count; corner++) {
+		const size_t next = next_corner(corner);
+		const uint32_t *twin = edge_corner.getptr(uint64_t(uint32_t(corner_vertex(next))) << 32 | uint32_t(corner_vertex(corner)));
+		if (!twin) {
+			boundary[corner] = 1;
+			continue;
+		}
+		// the twin runs the other way, so its start is this edge's end and its end this edge's start
+		parents[navigation_find(parents, uint32_t(corner))] = navigation_find(parents, uint32_t(next_corner(*twin)));
+		parents[navigation_find(parents, uint32_t(next))] = navigation_find(parents, *twin);
+	}
+
+	// every group of corners gets a bottom vertex and a top one after it
+	std::vector<uint32_t> slab_vertex(corner_count, UINT32_MAX);
+	manifold::MeshGL64 mesh;
+	mesh.numProp = 3;
+	for (size_t corner = 0; corner < corner_count; corner++) {
+		const uint32_t root = navigation_find(parents, uint32_t(corner));
+		if (slab_vertex[root] == UINT32_MAX) {
+			slab_vertex[root] = uint32_t(mesh.vertProperties.size() / 6);
+			const manifold::vec3 &position = p_patch.positions[corner_vertex(corner)];
+			mesh.vertProperties.insert(mesh.vertProperties.end(), { position.x, position.y + p_bottom, position.z, position.x, position.y + p_top, position.z });
+		}
+		slab_vertex[corner] = slab_vertex[root];
+	}
+	const auto bottom = [&](size_t p_corner) -> uint64_t {
+		return uint64_t(slab_vertex[p_corner]) * 2;
+	};
+	const auto top = [&](size_t p_corner) -> uint64_t {
+		return uint64_t(slab_vertex[p_corner]) * 2 + 1;
+	};
+
+	for (size_t corner = 0; corner < corner_count; corner += 3) {
+		mesh.triVerts.insert(mesh.triVerts.end(), { top(corner), top(corner + 1), top(corner + 2) });
+		mesh.triVerts.insert(mesh.triVerts.end(), { bottom(corner), bottom(corner + 2), bottom(corner + 1) });
+	}
+	for (size_t corner = 0; corner < corner_count; corner++) {
+		if (boundary[corner]) {
+			const size_t next = next_corner(corner);
+			mesh.triVerts.insert(mesh.triVerts.end(), { top(next), top(corner), bottom(corner) });
+			mesh.triVerts.insert(mesh.triVerts.end(), { top(next), bottom(corner), bottom(next) });
+		}
+	}
+	return manifold::Manifold(mesh);
+}
+
+// The height of a patch's surface over footprint points, from the triangle each point is in (or
+// misses by the least, for points a rounding error outside), found through a grid over the
+// triangles.
+class NavigationHeights {
+	const WalkablePatch *_patch = nullptr;
+	manifold::vec2 _origin = manifold::vec2(0.0);
+	manifold::vec2 _cell_size = manifold::vec2(1.0);
+	int32_t _width = 0;
+	int32_t _height = 0;
+	std::vector<uint32_t> _cell_first;
+	std::vector<uint32_t> _cell_triangles;
+
+	int32_t _column(double p_x) const {
+		return std::clamp(int32_t(std::floor((p_x - _origin.x) / _cell_size.x)), 0, _width - 1);
+	}
+	int32_t _row(double p_y) const {
+		return std::clamp(int32_t(std::floor((p_y - _origin.y) / _cell_size.y)), 0, _height - 1);
+	}
+
+	// the smallest barycentric coordinate of the point in the triangle, negative outside it
+	double _inside(uint32_t p_triangle, const manifold::vec2 &p_point, manifold::vec3 &r_weights) const {
+		const manifold::ivec3 &triangle = _patch->triangles[p_triangle];
+		const manifold::vec2 a = navigation_footprint(_patch->positions[triangle.x]);
+		const manifold::vec2 b = navigation_footprint(_patch->positions[triangle.y]);
+		const manifold::vec2 c = navigation_footprint(_patch->positions[triangle.z]);
+		const auto cross = [](const manifold::vec2 &p_u, const manifold::vec2 &p_v) {
+			return p_u.x * p_v.y - p_u.y * p_v.x;
+		};
+		const double area = cross(b - a, c - a);
+		if (area <= 0.0) {
+			return -std::numeric_limits<double>::infinity();
+		}
+		r_weights = manifold::vec3(cross(b - p_point, c - p_point), cross(c - p_point, a - p_point), cross(a - p_point, b - p_point)) / area;
+		return std::min({ r_weights.x, r_weights.y, r_weights.z });
+	}
+
+public:
+	void build(const WalkablePatch &p_patch) {
+		_patch = &p_patch;
+		manifold::vec2 min(std::numeric_limits<double>::infinity());
+		manifold::vec2 max(-std::numeric_limits<double>::infinity());
+		for (const manifold::vec3 &position : p_patch.positions) {
+			min = manifold::la::min(min, navigation_footprint(position));
+			max = manifold::la::max(max, navigation_footprint(position));
+		}
+		if (p_patch.triangles.empty()) {
+			_width = 0;
+			_height = 0;
+			return;
+		}
+
+		// about one triangle per cell
+		const manifold::vec2 size = manifold::la::max(max - min, manifold::vec2(1e-9));
+		const double cells = double(p_patch.triangles.size());
+		_width = std::clamp(int32_t(std::ceil(std::sqrt(cells * size.x / size.y))), 1, 1024);
+		_height = std::clamp(int32_t(std::ceil(cells / _width)), 1, 1024);
+		_origin = min;
+		_cell_size = size / manifold::vec2(_width, _height);
+
+		const size_t cell_count = size_t(_width) * _height;
+		_cell_first.assign(cell_count + 1, 0);
+		const auto for_each_cell = [&](const manifold::ivec3 &p_triangle, auto p_function) {
+			manifold::vec2 triangle_min(std::numeric_limits<double>::infinity());
+			manifold::vec2 triangle_max(-std::numeric_limits<double>::infinity());
+			for (int32_t corner = 0; corner < 3; corner++) {
+				triangle_min = manifold::la::min(triangle_min, navigation_footprint(p_patch.positions[p_triangle[corner]]));
+				triangle_max = manifold::la::max(triangle_max, navigation_footprint(p_patch.positions[p_triangle[corner]]));
+			}
+			for (int32_t row = _row(triangle_min.y); row <= _row(triangle_max.y); row++) {
+				for (int32_t column = _column(triangle_min.x); column <= _column(triangle_max.x); column++) {
+					p_function(size_t(row) * _width + column);
+				}
+			}
+		};
+		for (const manifold::ivec3 &triangle : p_patch.triangles) {
+			for_each_cell(triangle, [&](size_t p_cell) { _cell_first[p_cell + 1]++; });
+		}
+		for (size_t cell = 0; cell < cell_count; cell++) {
+			_cell_first[cell + 1] += _cell_first[cell];
+		}
+		_cell_triangles.resize(_cell_first[cell_count]);
+		std::vector<uint32_t> filled(_cell_first.begin(), _cell_first.end() - 1);
+		for (size_t i = 0; i < p_patch.triangles.size(); i++) {
+			for_each_cell(p_patch.triangles[i], [&](size_t p_cell) { _cell_triangles[filled[p_cell]++] = uint32_t(i); });
+		}
+	}
+
+	double height(const manifold::vec2 &p_point) const {
+		if (_width == 0) {
+			return 0.0;
+		}
+		const size_t cell = size_t(_row(p_point.y)) * _width + _column(p_point.x);
+		double best = -std::numeric_limits<double>::infinity();
+		manifold::vec3 best_weights(1.0 / 3.0);
+		uint32_t best_triangle = 0;
+		const auto consider = [&](uint32_t p_triangle) {
+			manifold::vec3 weights;
+			const double inside = _inside(p_triangle, p_point, weights);
+			if (inside > best) {
+				best = inside;
+				best_weights = weights;
+				best_triangle = p_triangle;
+			}
+		};
+		for (uint32_t i = _cell_first[cell]; i < _cell_first[cell + 1]; i++) {
+			consider(_cell_triangles[i]);
+		}
+		if (best < -1e-6) {
+			// nothing close in the cell
+			for (uint32_t triangle = 0; triangle < _patch->triangles.size(); triangle++) {
+				consider(triangle);
+			}
+		}
+
+		// a point outside every triangle gets the height of the nearest one's plane, clamped to it
+		const manifold::ivec3 &triangle = _patch->triangles[best_triangle];
+		best_weights = manifold::la::max(best_weights, manifold::vec3(0.0));
+		best_weights /= std::max(best_weights.x + best_weights.y + best_weights.z, 1e-300);
+		return _patch->positions[triangle.x].y * best_weights.x + _patch->positions[triangle.y].y * best_weights.y + _patch->positions[triangle.z].y * best_weights.z;
+	}
+};
+
+// Rectangles reaching p_radius to either side of, and past both ends of, each edge in p_edges
+// (pairs of positions) that lies between p_bottom and p_top in height and near p_near.
+static inline manifold::CrossSection navigation_edge_band(const std::vector<manifold::vec3> &p_edges, double p_bottom, double p_top, const manifold::Rect &p_near, double p_radius) {
+	manifold::Polygons rectangles;
+	for (size_t i = 0; i + 1 < p_edges.size(); i += 2) {
+		if (std::max(p_edges[i].y, p_edges[i + 1].y) < p_bottom || std::min(p_edges[i].y, p_edges[i + 1].y) > p_top) {
+			continue;
+		}
+		const manifold::vec2 a = navigation_footprint(p_edges[i]);
+		const manifold::vec2 b = navigation_footprint(p_edges[i + 1]);
+		const double length = manifold::la::length(b - a);
+		if (length <= 0.0 || !p_near.DoesOverlap(manifold::Rect(a, b))) {
+			continue;
+		}
+		const manifold::vec2 along = (b - a) * (p_radius / length);
+		const manifold::vec2 across(-along.y, along.x);
+		rectangles.push_back({ a - along - across, b + along - across, b + along + across, a - along + across });
+	}
+	return manifold::CrossSection(rectangles, manifold::CrossSection::FillRule::Positive);
+}
+
+// The connected parts of the whole mesh (turned by navigation_z_up()) and their bounds, so each
+// patch only intersects its clearance with the parts that can reach it.
+class NavigationSolid {
+	std::vector<manifold::Manifold> _parts;
+	std::vector<manifold::Box> _bounds;
+
+public:
+	void build(const manifold::Manifold &p_solid) {
+		_parts = p_solid.Decompose();
+		_bounds.resize(_parts.size());
+		for (size_t i = 0; i < _parts.size(); i++) {
+			_bounds[i] = _parts[i].BoundingBox();
+		}
+	}
+
+	manifold::Manifold near(const manifold::Box &p_bounds) const {
+		std::vector<manifold::Manifold> parts;
+		for (size_t i = 0; i < _parts.size(); i++) {
+			if (_bounds[i].DoesOverlap(p_bounds)) {
+				parts.push_back(_parts[i]);
+			}
+		}
+		return parts.size() == 1 ? parts[0] : manifold::Manifold::Compose(parts);
+	}
+};
+
+// The part of a patch an agent can stand on, in footprint coordinates: its footprint, less wherever
+// something in p_solid comes within p_agent_height above the surface, shrunk by p_agent_radius.
+// A patch with a component_boundary is only shrunk away from that boundary and from what is
+// blocked, not along the seams with the rest of its component. With p_region, only the part in
+// that box is kept, and only what is within twice the radius of it is looked at, so regions baked
+// separately meet edge to edge.
+static inline manifold::CrossSection navigation_walkable_area(const WalkablePatch &p_patch, const NavigationSolid &p_solid, double p_agent_height, double p_agent_radius, const manifold::Box *p_region) {
+	manifold::CrossSection walkable = p_patch.footprint;
+	double bottom = std::numeric_limits<double>::infinity();
+	double top = -std::numeric_limits<double>::infinity();
+	for (const manifold::vec3 &position : p_patch.positions) {
+		bottom = std::min(bottom, position.y);
+		top = std::max(top, position.y);
+	}
+	manifold::Rect region;
+	if (p_region) {
+		if (top < p_region->min.y || bottom > p_region->max.y) {
+			return manifold::CrossSection();
+		}
+		region = manifold::Rect(manifold::vec2(p_region->min.x, -p_region->max.z), manifold::vec2(p_region->max.x, -p_region->min.z));
+		const manifold::vec2 margin(p_agent_radius * 2.0);
+		walkable = walkable.RectClip(manifold::Rect(region.min - margin, region.max + margin));
+		if (walkable.IsEmpty()) {
+			return walkable;
+		}
+	}
+
+	// raised a little, so the solid the surface belongs to isn't counted
+	const double lift = p_agent_height * 1e-3;
+	const manifold::Manifold clearance = navigation_clearance(p_patch, lift, p_agent_height).Transform(navigation_z_up());
+	manifold::CrossSection blocked_area;
+	if (clearance.Status() == manifold::Manifold::Error::NoError) {
+		const manifold::Manifold blocked = p_solid.near(clearance.BoundingBox()).Boolean(clearance, manifold::OpType::Intersect);
+		if (!blocked.IsEmpty()) {
+			blocked_area = manifold::CrossSection(blocked.Project(), manifold::CrossSection::FillRule::Positive);
+			walkable = walkable - blocked_area;
+		}
+	}
+
+	if (p_agent_radius > 0.0 && !p_patch.component_boundary) {
+		walkable = walkable.Offset(-p_agent_radius, manifold::CrossSection::JoinType::Miter);
+	} else if (p_agent_radius > 0.0) {
+		// shrinking the difference above is the same as taking away the blocked area grown by the
+		// radius; the boundary of the rest of the component is only near enough to count within an
+		// agent's height, since any other level of it is either that far away or blocks this one
+		const manifold::Rect bounds = walkable.Bounds();
+		const manifold::vec2 margin(p_agent_radius);
+		walkable = walkable - navigation_edge_band(*p_patch.component_boundary, bottom - p_agent_height, top + p_agent_height, manifold::Rect(bounds.min - margin, bounds.max + margin), p_agent_radius);
+		if (!blocked_area.IsEmpty()) {
+			walkable = walkable - blocked_area.Offset(p_agent_radius, manifold::CrossSection::JoinType::Miter);
+		}
+	}
+	if (p_region) {
+		walkable = walkable.RectClip(region);
+	}
+	return walkable;
+}
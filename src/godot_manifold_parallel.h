@@ -0,0 +1,71 @@
+#pragma once
+
+#include <gdextension_interface.h>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/defs.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/callable_custom.hpp>
+
+#include <functional>
+
+// set while a thread runs a parallel_for task, so nested loops run in series instead of waiting on
+// the pool from inside it
+inline thread_local bool parallel_for_task_running = false;
+
+// manifold itself is built to run in series (see SCsub), so work that splits into independent pieces
+// is spread over Godot's WorkerThreadPool instead.
+class ParallelForCallable : public godot::CallableCustom {
+	const std::function<void(uint32_t)> *_func;
+
+	static bool _compare_equal(const godot::CallableCustom *p_a, const godot::CallableCustom *p_b) {
+		return p_a == p_b;
+	}
+	static bool _compare_less(const godot::CallableCustom *p_a, const godot::CallableCustom *p_b) {
+		return p_a < p_b;
+	}
+
+public:
+	ParallelForCallable(const std::function<void(uint32_t)> *p_func) :
+			_func(p_func) {}
+
+	uint32_t hash() const override {
+		return uint32_t(uintptr_t(_func));
+	}
+	godot::String get_as_text() const override {
+		return "ParallelForCallable";
+	}
+	CompareEqualFunc get_compare_equal_func() const override {
+		return &_compare_equal;
+	}
+	CompareLessFunc get_compare_less_func() const override {
+		return &_compare_less;
+	}
+	bool is_valid() const override {
+		return true;
+	}
+	godot::ObjectID get_object() const override {
+		return godot::ObjectID();
+	}
+	void call(const godot::Variant **p_arguments, int p_argcount, godot::Variant &r_return_value, GDExtensionCallError &r_call_error) const override {
+		r_call_error.error = GDEXTENSION_CALL_OK;
+		const bool was_running = parallel_for_task_running;
+		parallel_for_task_running = true;
+		(*_func)(uint32_t(*p_arguments[0]));
+		parallel_for_task_running = was_running;
+	}
+};
+
+// Calls p_func(i) for every i in [0, p_count) and returns once all of them have finished.
+static inline void parallel_for(uint32_t p_count, const std::function<void(uint32_t)> &p_func) {
+	godot::WorkerThreadPool *pool = godot::WorkerThreadPool::get_singleton();
+	if (p_count <= 1 || parallel_for_task_running || unlikely(!pool)) {
+		for (uint32_t i = 0; i < p_count; i++) {
+			p_func(i);
+		}
+		return;
+	}
+
+	const int64_t group_id = pool->add_group_task(godot::Callable(memnew(ParallelForCallable(&p_func))), p_count, -1, true, "manifold");
+	pool->wait_for_group_task_completion(group_id);
+}
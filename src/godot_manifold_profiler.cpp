@@ -0,0 +1,195 @@
+#include "godot_manifold_memory.h"
+#include "godot_manifold_profiler.h"
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+#ifdef DEBUG_ENABLED
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+using namespace godot;
+
+void ManifoldProfiler::_bind_methods() {
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("start_trace"), &ManifoldProfiler::start_trace);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("stop_trace", "path"), &ManifoldProfiler::stop_trace);
+	ClassDB::bind_static_method(get_class_static(), D_METHOD("is_tracing"), &ManifoldProfiler::is_tracing);
+}
+
+#ifdef DEBUG_ENABLED
+
+namespace {
+
+struct ZoneCounters {
+	std::atomic<uint64_t> calls{ 0 };
+	std::atomic<uint64_t> usec{ 0 };
+};
+
+struct TraceEvent {
+	const char *name;
+	ManifoldProfiler::Zone zone;
+	uint64_t start;
+	uint64_t duration;
+	uint64_t thread;
+};
+
+const char *const ZONE_NAMES[ManifoldProfiler::ZONE_MAX] = {
+	"boolean",
+	"ensure_manifold",
+	"ensure_meshgl",
+	"commit_to_arrays",
+	"rid_upload",
+	"generate_lods",
+};
+
+// a trace that is left running stops growing instead of eating all memory
+constexpr size_t MAX_TRACE_EVENTS = 1 << 20;
+
+ZoneCounters zone_counters[ManifoldProfiler::ZONE_MAX];
+std::atomic<uint64_t> triangles{ 0 };
+std::atomic<uint64_t> bytes_uploaded{ 0 };
+
+std::atomic<bool> tracing{ false };
+std::mutex trace_mutex;
+std::vector<TraceEvent> trace_events;
+uint64_t trace_start = 0;
+
+uint64_t last_rate_triangles = 0;
+uint64_t last_rate_time = 0;
+
+uint64_t now_usec() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t monitor_calls(int32_t p_zone) {
+	return zone_counters[p_zone].calls.load(std::memory_order_relaxed);
+}
+double monitor_time_msec(int32_t p_zone) {
+	return zone_counters[p_zone].usec.load(std::memory_order_relaxed) / 1000.0;
+}
+double monitor_triangles_per_second() {
+	const uint64_t count = triangles.load(std::memory_order_relaxed);
+	const uint64_t time = now_usec();
+	const double rate = last_rate_time != 0 && time > last_rate_time ? (count - last_rate_triangles) * 1e6 / (time - last_rate_time) : 0.0;
+	last_rate_triangles = count;
+	last_rate_time = time;
+	return rate;
+}
+int64_t monitor_bytes_uploaded() {
+	return bytes_uploaded.load(std::memory_order_relaxed);
+}
+
+} //namespace
+
+ManifoldProfiler::Scope::Scope(Zone p_zone, const char *p_name) :
+		_zone(p_zone), _name(p_name), _start(now_usec()) {}
+
+ManifoldProfiler::Scope::~Scope() {
+	const uint64_t duration = now_usec() - _start;
+	zone_counters[_zone].calls.fetch_add(1, std::memory_order_relaxed);
+	zone_counters[_zone].usec.fetch_add(duration, std::memory_order_relaxed);
+
+	if (unlikely(tracing.load(std::memory_order_relaxed))) {
+		const uint64_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		if (trace_events.size() < MAX_TRACE_EVENTS) {
+			trace_events.push_back({ _name, _zone, _start, duration, thread });
+		}
+	}
+}
+
+void ManifoldProfiler::add_triangles(uint64_t p_count) {
+	triangles.fetch_add(p_count, std::memory_order_relaxed);
+}
+
+void ManifoldProfiler::add_uploaded_arrays(const Array &p_arrays) {
+	const uint64_t bytes = memory_of_arrays(p_arrays);
+	bytes_uploaded.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+Error ManifoldProfiler::start_trace() {
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	ERR_FAIL_COND_V_MSG(tracing.load(), ERR_ALREADY_IN_USE, "A Manifold trace is already running");
+	trace_events.clear();
+	trace_start = now_usec();
+	tracing.store(true);
+	return OK;
+}
+
+Error ManifoldProfiler::stop_trace(const String &p_path) {
+	std::vector<TraceEvent> events;
+	{
+		std::lock_guard<std::mutex> lock(trace_mutex);
+		ERR_FAIL_COND_V_MSG(!tracing.load(), ERR_DOES_NOT_EXIST, "No Manifold trace is running");
+		tracing.store(false);
+		events.swap(trace_events);
+	}
+
+	const Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), FileAccess::get_open_error(), vformat("Cannot open %s for writing", p_path));
+
+	// Chrome trace event format; nesting is reconstructed from the timestamps of complete ("X") events
+	file->store_string("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for (size_t i = 0; i < events.size(); i++) {
+		const TraceEvent &event = events[i];
+		file->store_string(vformat("%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%d,\"dur\":%d,\"pid\":1,\"tid\":%d}\n", i == 0 ? "" : ",", event.name, ZONE_NAMES[event.zone], int64_t(event.start - trace_start), int64_t(event.duration), int64_t(event.thread & 0x7fffffff)));
+	}
+	file->store_string("]}\n");
+	return file->get_error();
+}
+
+bool ManifoldProfiler::is_tracing() {
+	return tracing.load();
+}
+
+void ManifoldProfiler::register_monitors() {
+	Performance *performance = Performance::get_singleton();
+	ERR_FAIL_NULL(performance);
+
+	for (int32_t zone = 0; zone < ZONE_MAX; zone++) {
+		performance->add_custom_monitor(vformat("Manifold/%s calls", ZONE_NAMES[zone]), callable_mp_static(&monitor_calls).bind(zone));
+		performance->add_custom_monitor(vformat("Manifold/%s time (ms)", ZONE_NAMES[zone]), callable_mp_static(&monitor_time_msec).bind(zone));
+	}
+	performance->add_custom_monitor("Manifold/triangles per second", callable_mp_static(&monitor_triangles_per_second));
+	performance->add_custom_monitor("Manifold/bytes uploaded", callable_mp_static(&monitor_bytes_uploaded));
+}
+
+void ManifoldProfiler::unregister_monitors() {
+	Performance *performance = Performance::get_singleton();
+	if (!performance) {
+		return;
+	}
+
+	for (int32_t zone = 0; zone < ZONE_MAX; zone++) {
+		performance->remove_custom_monitor(vformat("Manifold/%s calls", ZONE_NAMES[zone]));
+		performance->remove_custom_monitor(vformat("Manifold/%s time (ms)", ZONE_NAMES[zone]));
+	}
+	performance->remove_custom_monitor("Manifold/triangles per second");
+	performance->remove_custom_monitor("Manifold/bytes uploaded");
+}
+
+#else
+
+Error ManifoldProfiler::start_trace() {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Manifold profiling is compiled out of release builds");
+}
+
+Error ManifoldProfiler::stop_trace(const String &p_path) {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Manifold profiling is compiled out of release builds");
+}
+
+bool ManifoldProfiler::is_tracing() {
+	return false;
+}
+
+void ManifoldProfiler::register_monitors() {}
+
+void ManifoldProfiler::unregister_monitors() {}
+
+#endif // DEBUG_ENABLED
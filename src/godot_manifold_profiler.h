@@ -0,0 +1,57 @@
+#pragma once
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+// Counters and trace zones for the expensive parts of the wrappers. Everything except the
+// ManifoldProfiler class itself is compiled out unless DEBUG_ENABLED is defined (editor and debug
+// template builds), so release templates pay nothing for it.
+class ManifoldProfiler : public godot::Object {
+	GDCLASS(ManifoldProfiler, godot::Object);
+
+protected:
+	static void _bind_methods();
+
+public:
+	enum Zone {
+		ZONE_BOOLEAN,
+		ZONE_ENSURE_MANIFOLD,
+		ZONE_ENSURE_MESHGL,
+		ZONE_COMMIT_TO_ARRAYS,
+		ZONE_RID_UPLOAD,
+		ZONE_GENERATE_LODS,
+		ZONE_MAX,
+	};
+
+	static godot::Error start_trace();
+	static godot::Error stop_trace(const godot::String &p_path);
+	static bool is_tracing();
+
+	static void register_monitors();
+	static void unregister_monitors();
+
+#ifdef DEBUG_ENABLED
+	static void add_triangles(uint64_t p_count);
+	static void add_uploaded_arrays(const godot::Array &p_arrays);
+
+	class Scope {
+		const Zone _zone;
+		const char *const _name;
+		const uint64_t _start;
+
+	public:
+		Scope(Zone p_zone, const char *p_name);
+		~Scope();
+	};
+#endif
+};
+
+#ifdef DEBUG_ENABLED
+#define MANIFOLD_PROFILE_ZONE(m_zone) const ManifoldProfiler::Scope _profile_scope(ManifoldProfiler::m_zone, __func__)
+#define MANIFOLD_PROFILE_TRIANGLES(m_count) ManifoldProfiler::add_triangles(m_count)
+#define MANIFOLD_PROFILE_UPLOAD(m_arrays) ManifoldProfiler::add_uploaded_arrays(m_arrays)
+#else
+#define MANIFOLD_PROFILE_ZONE(m_zone)
+#define MANIFOLD_PROFILE_TRIANGLES(m_count) ((void)0)
+#define MANIFOLD_PROFILE_UPLOAD(m_arrays) ((void)0)
+#endif
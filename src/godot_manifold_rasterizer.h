@@ -0,0 +1,221 @@
+#pragma once
+
+#include <manifold/common.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Scanline rasterization of contours already in pixel space, pixel (x, y) covering [x, x + 1) by
+// [y, y + 1). The rows are split into bands so each band can be filled on its own thread; build()
+// buckets the edges by the bands they overlap, so a band never looks at the edges of another one.
+//
+// The contours of a cross section never overlap, so the winding number is only ever 0 or +-1, and
+// anything non-zero counts as covered whichever way the contours are wound.
+class ScanlineRasterizer {
+	struct Edge {
+		manifold::vec2 a;
+		manifold::vec2 b;
+	};
+
+	std::vector<Edge> _edges;
+	int32_t _width = 0;
+	int32_t _height = 0;
+	int32_t _band_rows = 1;
+	std::vector<uint32_t> _band_first;
+	std::vector<uint32_t> _band_edges;
+
+	// Adds the coverage of a line with p_from.x and p_to.x in [0, width] to the rows of the band,
+	// as signed area deposited in the pixel it enters; summing a row from the left then gives each
+	// pixel's winding-weighted coverage. The row stride leaves room for deposits at x = width.
+	void _accumulate(manifold::vec2 p_from, manifold::vec2 p_to, int32_t p_first_row, int32_t p_end_row, float *r_rows, size_t p_stride) const {
+		if (p_from.y == p_to.y) {
+			return;
+		}
+		float direction = 1.0f;
+		if (p_from.y > p_to.y) {
+			std::swap(p_from, p_to);
+			direction = -1.0f;
+		}
+		const double dxdy = (p_to.x - p_from.x) / (p_to.y - p_from.y);
+		const int32_t first_row = std::max(p_first_row, int32_t(std::floor(p_from.y)));
+		const int32_t end_row = std::min(p_end_row, int32_t(std::ceil(p_to.y)));
+		for (int32_t y = first_row; y < end_row; y++) {
+			const double top = std::max(double(y), p_from.y);
+			const double bottom = std::min(double(y + 1), p_to.y);
+			if (bottom <= top) {
+				continue;
+			}
+			const double x_top = p_from.x + (top - p_from.y) * dxdy;
+			const double x_bottom = p_from.x + (bottom - p_from.y) * dxdy;
+			const float d = float(bottom - top) * direction;
+			float *row = r_rows + size_t(y - p_first_row) * p_stride;
+
+			const double x0 = std::min(x_top, x_bottom);
+			const double x1 = std::max(x_top, x_bottom);
+			const double x0_floor = std::floor(x0);
+			const double x1_ceil = std::ceil(x1);
+			const int32_t x0i = int32_t(x0_floor);
+			const int32_t x1i = int32_t(x1_ceil);
+			if (x1i <= x0i + 1) {
+				// within one pixel: split by where the line passes through it on average
+				const float middle = float(0.5 * (x_top + x_bottom) - x0_floor);
+				row[x0i] += d - d * middle;
+				row[x0i + 1] += d * middle;
+				continue;
+			}
+
+			// across several pixels: a triangle in the first and last, trapezoids in between
+			const float s = float(1.0 / (x1 - x0));
+			const float x0f = float(x0 - x0_floor);
+			const float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+			const float x1f = float(x1 - x1_ceil + 1.0);
+			const float am = 0.5f * s * x1f * x1f;
+			row[x0i] += d * a0;
+			if (x1i == x0i + 2) {
+				row[x0i + 1] += d * (1.0f - a0 - am);
+			} else {
+				const float a1 = s * (1.5f - x0f);
+				row[x0i + 1] += d * (a1 - a0);
+				for (int32_t x = x0i + 2; x < x1i - 1; x++) {
+					row[x] += d * s;
+				}
+				const float a2 = a1 + float(x1i - x0i - 3) * s;
+				row[x1i - 1] += d * (1.0f - a2 - am);
+			}
+			row[x1i] += d * am;
+		}
+	}
+
+public:
+	void build(const manifold::Polygons &p_polygons, int32_t p_width, int32_t p_height, int32_t p_band_rows) {
+		_width = p_width;
+		_height = p_height;
+		_band_rows = std::max(p_band_rows, 1);
+		_edges.clear();
+		for (const manifold::SimplePolygon &polygon : p_polygons) {
+			for (size_t i = 0; i < polygon.size(); i++) {
+				const Edge edge = { polygon[i], polygon[(i + 1) % polygon.size()] };
+				// horizontal edges cross no row, and edges wholly above or below the image don't matter
+				if (edge.a.y != edge.b.y && std::max(edge.a.y, edge.b.y) > 0.0 && std::min(edge.a.y, edge.b.y) < double(_height)) {
+					_edges.push_back(edge);
+				}
+			}
+		}
+
+		const int32_t band_count = get_band_count();
+		const auto for_each_band = [&](const Edge &p_edge, auto p_function) {
+			const int32_t first_band = std::clamp(int32_t(std::floor(std::min(p_edge.a.y, p_edge.b.y))) / _band_rows, 0, band_count - 1);
+			const int32_t last_band = std::clamp(int32_t(std::ceil(std::max(p_edge.a.y, p_edge.b.y))) / _band_rows, 0, band_count - 1);
+			for (int32_t band = first_band; band <= last_band; band++) {
+				p_function(band);
+			}
+		};
+		_band_first.assign(band_count + 1, 0);
+		for (const Edge &edge : _edges) {
+			for_each_band(edge, [&](int32_t p_band) { _band_first[p_band + 1]++; });
+		}
+		for (int32_t band = 0; band < band_count; band++) {
+			_band_first[band + 1] += _band_first[band];
+		}
+		_band_edges.resize(_band_first[band_count]);
+		std::vector<uint32_t> filled(_band_first.begin(), _band_first.end() - 1);
+		for (size_t i = 0; i < _edges.size(); i++) {
+			for_each_band(_edges[i], [&](int32_t p_band) { _band_edges[filled[p_band]++] = uint32_t(i); });
+		}
+	}
+
+	int32_t get_band_count() const {
+		return (_height + _band_rows - 1) / _band_rows;
+	}
+
+	// Writes 255 for every pixel of the band whose centre is covered and 0 for the rest, one byte per
+	// pixel with rows p_width bytes apart, starting at the band's first row.
+	void fill_mask(int32_t p_band, uint8_t *r_pixels) const {
+		struct Crossing {
+			double x;
+			int32_t direction;
+			bool operator<(const Crossing &p_other) const {
+				return x < p_other.x;
+			}
+		};
+		std::vector<Crossing> crossings;
+		const int32_t first_row = p_band * _band_rows;
+		const int32_t end_row = std::min(first_row + _band_rows, _height);
+		for (int32_t y = first_row; y < end_row; y++) {
+			uint8_t *row = r_pixels + size_t(y - first_row) * _width;
+			std::fill(row, row + _width, uint8_t(0));
+
+			// the top end of an edge is on its row and the bottom end isn't, so a vertex is only crossed once
+			const double centre = y + 0.5;
+			crossings.clear();
+			for (uint32_t i = _band_first[p_band]; i < _band_first[p_band + 1]; i++) {
+				const Edge &edge = _edges[_band_edges[i]];
+				const bool down = edge.a.y < edge.b.y;
+				const manifold::vec2 &top = down ? edge.a : edge.b;
+				const manifold::vec2 &bottom = down ? edge.b : edge.a;
+				if (top.y <= centre && centre < bottom.y) {
+					crossings.push_back({ top.x + (centre - top.y) * (bottom.x - top.x) / (bottom.y - top.y), down ? 1 : -1 });
+				}
+			}
+			std::sort(crossings.begin(), crossings.end());
+
+			int32_t winding = 0;
+			for (size_t i = 0; i + 1 < crossings.size(); i++) {
+				winding += crossings[i].direction;
+				if (winding == 0) {
+					continue;
+				}
+				// the pixels whose centres fall in [x_i, x_i+1)
+				const int32_t first = int32_t(std::clamp(std::ceil(crossings[i].x - 0.5), 0.0, double(_width)));
+				const int32_t end = int32_t(std::clamp(std::ceil(crossings[i + 1].x - 0.5), 0.0, double(_width)));
+				std::fill(row + first, row + std::max(first, end), uint8_t(255));
+			}
+		}
+	}
+
+	// Writes how much of every pixel of the band is covered, from 0 to 255, laid out as fill_mask().
+	void fill_coverage(int32_t p_band, uint8_t *r_pixels) const {
+		const int32_t first_row = p_band * _band_rows;
+		const int32_t end_row = std::min(first_row + _band_rows, _height);
+		const size_t stride = size_t(_width) + 2;
+		std::vector<float> rows(stride * size_t(end_row - first_row), 0.0f);
+
+		// parts of an edge left of the image still cover everything to their right, so they are moved
+		// onto its left side; parts right of it cover nothing in it and are moved onto its right side
+		const double width = _width;
+		for (uint32_t i = _band_first[p_band]; i < _band_first[p_band + 1]; i++) {
+			const Edge &edge = _edges[_band_edges[i]];
+			double cuts[4] = { 0.0, 1.0, 1.0, 1.0 };
+			int32_t cut_count = 1;
+			if (edge.a.x != edge.b.x) {
+				for (const double x : { 0.0, width }) {
+					const double t = (x - edge.a.x) / (edge.b.x - edge.a.x);
+					if (t > 0.0 && t < 1.0) {
+						cuts[cut_count++] = t;
+					}
+				}
+			}
+			cuts[cut_count] = 1.0;
+			std::sort(cuts + 1, cuts + cut_count);
+			for (int32_t cut = 0; cut < cut_count; cut++) {
+				manifold::vec2 from = manifold::la::lerp(edge.a, edge.b, cuts[cut]);
+				manifold::vec2 to = manifold::la::lerp(edge.a, edge.b, cuts[cut + 1]);
+				from.x = std::clamp(from.x, 0.0, width);
+				to.x = std::clamp(to.x, 0.0, width);
+				_accumulate(from, to, first_row, end_row, rows.data(), stride);
+			}
+		}
+
+		for (int32_t y = first_row; y < end_row; y++) {
+			const float *row = rows.data() + size_t(y - first_row) * stride;
+			uint8_t *pixels = r_pixels + size_t(y - first_row) * _width;
+			float coverage = 0.0f;
+			for (int32_t x = 0; x < _width; x++) {
+				coverage += row[x];
+				pixels[x] = uint8_t(std::min(std::abs(coverage), 1.0f) * 255.0f + 0.5f);
+			}
+		}
+	}
+};
@@ -3,26 +3,59 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/defs.hpp>
 
+#include "godot_manifold_cache.h"
+#include "godot_manifold_chunk_grid.h"
 #include "godot_manifold_defs.h"
+#include "godot_manifold_editor.h"
+#include "godot_manifold_profiler.h"
+
+#ifdef TOOLS_ENABLED
+#include <godot_cpp/classes/editor_plugin_registration.hpp>
+#endif
 
 using namespace godot;
 
 void initialize_manifold_module(ModuleInitializationLevel p_level) {
+#ifdef TOOLS_ENABLED
+	if (p_level == MODULE_INITIALIZATION_LEVEL_EDITOR) {
+		GDREGISTER_INTERNAL_CLASS(ManifoldMeshImportPlugin);
+		GDREGISTER_INTERNAL_CLASS(ManifoldEditorPlugin);
+		EditorPlugins::add_by_type<ManifoldEditorPlugin>();
+		return;
+	}
+#endif
+
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
 
 	GDREGISTER_CLASS(CrossSection);
+	GDREGISTER_CLASS(CrossSectionChunkGrid);
 	GDREGISTER_CLASS(ManifoldMesh32);
 	GDREGISTER_CLASS(ManifoldMesh64);
 	GDREGISTER_CLASS(Manifold);
 	GDREGISTER_CLASS(ManifoldMesh);
+	GDREGISTER_ABSTRACT_CLASS(ManifoldProfiler);
+	GDREGISTER_ABSTRACT_CLASS(ManifoldCache);
+
+	ManifoldProfiler::register_monitors();
 }
 
 void uninitialize_manifold_module(ModuleInitializationLevel p_level) {
+#ifdef TOOLS_ENABLED
+	if (p_level == MODULE_INITIALIZATION_LEVEL_EDITOR) {
+		EditorPlugins::remove_by_type<ManifoldEditorPlugin>();
+		return;
+	}
+#endif
+
 	if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
 		return;
 	}
+
+	ManifoldProfiler::unregister_monitors();
+	ManifoldCache::clear();
+	ManifoldCache::set_disk_cache(String());
 }
 
 #ifdef GODOT_MANIFOLD_STANDALONE
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "godot_manifold_parallel.h"
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+
+#include <manifold/cross_section.h>
+#include <manifold/manifold.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+static _FORCE_INLINE_ uint64_t slice_edge_key(uint32_t p_a, uint32_t p_b) {
+	return p_a < p_b ? (uint64_t(p_a) << 32) | p_b : (uint64_t(p_b) << 32) | p_a;
+}
+
+// Contours one layer from the triangles known to cross it. Each crossing triangle contributes one
+// segment running from the edge it goes down through to the edge it comes back up through, which
+// keeps solid regions counter-clockwise and holes clockwise, like manifold::Manifold::Slice.
+template <typename Precision, typename I>
+manifold::Polygons slice_layer(const manifold::MeshGLP<Precision, I> &p_mesh, const std::vector<uint32_t> &p_canonical, const std::vector<uint32_t> &p_triangles, double p_height) {
+	struct Segment {
+		uint64_t from;
+		uint64_t to;
+		manifold::vec2 point;
+	};
+
+	const size_t num_prop = p_mesh.numProp;
+	const auto position = [&p_mesh, num_prop](size_t p_vert) -> manifold::vec3 {
+		const Precision *vert = &p_mesh.vertProperties[p_vert * num_prop];
+		return { double(vert[0]), double(vert[1]), double(vert[2]) };
+	};
+
+	std::vector<Segment> segments;
+	segments.reserve(p_triangles.size());
+	godot::HashMap<uint64_t, uint32_t> by_start;
+	by_start.reserve(p_triangles.size());
+
+	for (const uint32_t tri : p_triangles) {
+		size_t verts[3];
+		manifold::vec3 positions[3];
+		for (int i = 0; i < 3; i++) {
+			verts[i] = p_mesh.triVerts[tri * 3 + i];
+			positions[i] = position(verts[i]);
+		}
+
+		int down = -1, up = -1;
+		for (int i = 0; i < 3; i++) {
+			const bool above_a = positions[i].z > p_height;
+			const bool above_b = positions[(i + 1) % 3].z > p_height;
+			if (above_a && !above_b) {
+				down = i;
+			} else if (!above_a && above_b) {
+				up = i;
+			}
+		}
+		DEV_ASSERT(down != -1 && up != -1);
+
+		const manifold::vec3 &a = positions[down];
+		const manifold::vec3 &b = positions[(down + 1) % 3];
+		const double t = (p_height - a.z) / (b.z - a.z);
+
+		Segment segment;
+		segment.from = slice_edge_key(p_canonical[verts[down]], p_canonical[verts[(down + 1) % 3]]);
+		segment.to = slice_edge_key(p_canonical[verts[up]], p_canonical[verts[(up + 1) % 3]]);
+		segment.point = { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t };
+
+		by_start.insert(segment.from, segments.size());
+		segments.push_back(segment);
+	}
+
+	manifold::Polygons polygons;
+	std::vector<bool> used(segments.size(), false);
+	for (size_t start = 0; start < segments.size(); start++) {
+		if (used[start]) {
+			continue;
+		}
+
+		manifold::SimplePolygon polygon;
+		uint32_t current = start;
+		while (!used[current]) {
+			used[current] = true;
+			polygon.push_back(segments[current].point);
+
+			const uint32_t *next = by_start.getptr(segments[current].to);
+			if (unlikely(!next)) {
+				break;
+			}
+			current = *next;
+		}
+
+		if (likely(polygon.size() >= 3)) {
+			polygons.push_back(std::move(polygon));
+		}
+	}
+
+	return polygons;
+}
+
+// Slices a mesh at every height in one sweep: triangles are sorted by their lowest vertex once, the
+// heights are visited in increasing order while maintaining the set of triangles that cross the
+// current one, and then every layer is contoured in parallel.
+template <typename Precision, typename I>
+std::vector<manifold::CrossSection> slice_mesh(const manifold::MeshGLP<Precision, I> &p_mesh, const std::vector<double> &p_heights) {
+	const size_t num_vert = p_mesh.NumVert();
+	const size_t num_tri = p_mesh.NumTri();
+	const size_t num_prop = p_mesh.numProp;
+
+	std::vector<manifold::CrossSection> layers(p_heights.size());
+	if (unlikely(num_tri == 0 || num_prop < 3)) {
+		return layers;
+	}
+
+	// property vertices that share a position need to share an ID for the contours to join up
+	std::vector<uint32_t> canonical(num_vert);
+	std::iota(canonical.begin(), canonical.end(), 0);
+	for (size_t i = 0; i < p_mesh.mergeFromVert.size(); i++) {
+		canonical[p_mesh.mergeFromVert[i]] = p_mesh.mergeToVert[i];
+	}
+
+	std::vector<double> tri_min(num_tri), tri_max(num_tri);
+	for (size_t tri = 0; tri < num_tri; tri++) {
+		const double z0 = p_mesh.vertProperties[p_mesh.triVerts[tri * 3 + 0] * num_prop + 2];
+		const double z1 = p_mesh.vertProperties[p_mesh.triVerts[tri * 3 + 1] * num_prop + 2];
+		const double z2 = p_mesh.vertProperties[p_mesh.triVerts[tri * 3 + 2] * num_prop + 2];
+		tri_min[tri] = std::min({ z0, z1, z2 });
+		tri_max[tri] = std::max({ z0, z1, z2 });
+	}
+
+	std::vector<uint32_t> tri_order(num_tri);
+	std::iota(tri_order.begin(), tri_order.end(), 0);
+	std::sort(tri_order.begin(), tri_order.end(), [&tri_min](uint32_t p_a, uint32_t p_b) {
+		return tri_min[p_a] < tri_min[p_b];
+	});
+
+	std::vector<uint32_t> layer_order(p_heights.size());
+	std::iota(layer_order.begin(), layer_order.end(), 0);
+	std::sort(layer_order.begin(), layer_order.end(), [&p_heights](uint32_t p_a, uint32_t p_b) {
+		return p_heights[p_a] < p_heights[p_b];
+	});
+
+	// a vertex exactly on a layer counts as below it, so a triangle crosses when min <= height < max
+	std::vector<std::vector<uint32_t>> crossing(p_heights.size());
+	std::vector<uint32_t> active;
+	size_t next_tri = 0;
+	for (const uint32_t layer : layer_order) {
+		const double height = p_heights[layer];
+		while (next_tri < num_tri && tri_min[tri_order[next_tri]] <= height) {
+			active.push_back(tri_order[next_tri++]);
+		}
+		active.erase(std::remove_if(active.begin(), active.end(), [&tri_max, height](uint32_t p_tri) {
+			return tri_max[p_tri] <= height;
+		}),
+				active.end());
+		crossing[layer] = active;
+	}
+
+	parallel_for(p_heights.size(), [&](uint32_t p_layer) {
+		const manifold::Polygons polygons = slice_layer(p_mesh, canonical, crossing[p_layer], p_heights[p_layer]);
+		layers[p_layer] = manifold::CrossSection(polygons, manifold::CrossSection::FillRule::Positive);
+	});
+
+	return layers;
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <manifold/manifold.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Triangle and vertex ordering for emitted index buffers: Forsyth's linear-speed vertex cache
+// optimisation, then clusters of the cache-friendly order sorted outside-in to cut overdraw, then
+// vertices renumbered in the order they are first fetched.
+
+// the post-transform cache modelled when reporting (a FIFO, like most current hardware)
+constexpr uint32_t VERTEX_CACHE_REPORT_SIZE = 16;
+
+// ...and the LRU cache the optimiser scores against
+constexpr uint32_t VERTEX_CACHE_OPTIMIZE_SIZE = 32;
+
+// clusters may only be reordered while that costs at most this much more in cache misses
+constexpr double VERTEX_CACHE_OVERDRAW_THRESHOLD = 1.05;
+
+static inline uint64_t vertex_cache_misses(const int32_t *p_indices, size_t p_index_count, size_t p_vertex_count, uint32_t p_cache_size = VERTEX_CACHE_REPORT_SIZE) {
+	// a vertex is in the cache when it was loaded within the last p_cache_size loads
+	std::vector<uint64_t> loaded_at(p_vertex_count, 0);
+	uint64_t loads = 0;
+	for (size_t i = 0; i < p_index_count; i++) {
+		uint64_t &time = loaded_at[p_indices[i]];
+		if (time == 0 || loads - time >= p_cache_size) {
+			time = ++loads;
+		}
+	}
+	return loads;
+}
+
+static inline void optimize_vertex_cache(int32_t *r_indices, size_t p_index_count, size_t p_vertex_count) {
+	constexpr uint32_t cache_size = VERTEX_CACHE_OPTIMIZE_SIZE;
+	constexpr uint32_t max_valence = 32;
+	const size_t triangle_count = p_index_count / 3;
+	if (triangle_count < 2) {
+		return;
+	}
+
+	// scores from the original article: the last triangle's vertices are slightly penalised, older
+	// cache entries decay, and vertices with few triangles left are boosted so none get stranded
+	float cache_scores[cache_size + 3];
+	float valence_scores[max_valence + 1];
+	for (uint32_t i = 0; i < cache_size + 3; i++) {
+		cache_scores[i] = i < 3 ? 0.75f : (i < cache_size ? std::pow(1.0f - float(i - 3) / float(cache_size - 3), 1.5f) : 0.0f);
+	}
+	valence_scores[0] = 0.0f;
+	for (uint32_t i = 1; i <= max_valence; i++) {
+		valence_scores[i] = 2.0f / std::sqrt(float(i));
+	}
+	const auto vertex_score = [&](int32_t p_cache_position, uint32_t p_remaining) -> float {
+		if (p_remaining == 0) {
+			return -1.0f;
+		}
+		return (p_cache_position >= 0 ? cache_scores[p_cache_position] : 0.0f) + valence_scores[std::min(p_remaining, max_valence)];
+	};
+
+	// triangles around each vertex, as offsets into one array
+	std::vector<uint32_t> remaining(p_vertex_count, 0);
+	for (size_t i = 0; i < p_index_count; i++) {
+		remaining[r_indices[i]]++;
+	}
+	std::vector<uint32_t> first_triangle(p_vertex_count + 1, 0);
+	for (size_t vertex = 0; vertex < p_vertex_count; vertex++) {
+		first_triangle[vertex + 1] = first_triangle[vertex] + remaining[vertex];
+	}
+	std::vector<uint32_t> adjacent(p_index_count);
+	{
+		std::vector<uint32_t> filled(first_triangle.begin(), first_triangle.end() - 1);
+		for (size_t i = 0; i < p_index_count; i++) {
+			adjacent[filled[r_indices[i]]++] = uint32_t(i / 3);
+		}
+	}
+
+	std::vector<int32_t> cache_position(p_vertex_count, -1);
+	std::vector<float> scores(p_vertex_count);
+	for (size_t vertex = 0; vertex < p_vertex_count; vertex++) {
+		scores[vertex] = vertex_score(-1, remaining[vertex]);
+	}
+	std::vector<float> triangle_scores(triangle_count);
+	std::vector<uint8_t> emitted(triangle_count, 0);
+	for (size_t triangle = 0; triangle < triangle_count; triangle++) {
+		triangle_scores[triangle] = scores[r_indices[triangle * 3]] + scores[r_indices[triangle * 3 + 1]] + scores[r_indices[triangle * 3 + 2]];
+	}
+
+	std::vector<int32_t> output;
+	output.reserve(p_index_count);
+	int32_t cache[cache_size + 3];
+	uint32_t cache_count = 0;
+	size_t cursor = 0;
+	int64_t best = std::max_element(triangle_scores.begin(), triangle_scores.end()) - triangle_scores.begin();
+
+	while (best >= 0) {
+		emitted[best] = 1;
+		const int32_t *triangle = &r_indices[best * 3];
+		output.insert(output.end(), triangle, triangle + 3);
+
+		// move the triangle's vertices to the front of the cache
+		int32_t next_cache[cache_size + 3];
+		uint32_t next_count = 0;
+		for (uint32_t k = 0; k < 3; k++) {
+			next_cache[next_count++] = triangle[k];
+			uint32_t &left = remaining[triangle[k]];
+			// drop the triangle from the vertex's list by swapping it to the end
+			uint32_t *begin = &adjacent[first_triangle[triangle[k]]];
+			uint32_t *end = begin + left;
+			*std::find(begin, end, uint32_t(best)) = end[-1];
+			left--;
+		}
+		for (uint32_t k = 0; k < cache_count; k++) {
+			if (cache[k] != triangle[0] && cache[k] != triangle[1] && cache[k] != triangle[2]) {
+				next_cache[next_count++] = cache[k];
+			}
+		}
+		for (uint32_t k = cache_size; k < next_count; k++) {
+			cache_position[next_cache[k]] = -1;
+			scores[next_cache[k]] = vertex_score(-1, remaining[next_cache[k]]);
+		}
+		cache_count = std::min(next_count, cache_size);
+		std::copy(next_cache, next_cache + cache_count, cache);
+
+		// rescore what is in the cache, and pick the best triangle touching it
+		for (uint32_t k = 0; k < cache_count; k++) {
+			cache_position[cache[k]] = k;
+			scores[cache[k]] = vertex_score(k, remaining[cache[k]]);
+		}
+		best = -1;
+		float best_score = -1.0f;
+		for (uint32_t k = 0; k < cache_count; k++) {
+			const uint32_t *begin = &adjacent[first_triangle[cache[k]]];
+			for (const uint32_t *t = begin; t != begin + remaining[cache[k]]; t++) {
+				const float score = scores[r_indices[*t * 3]] + scores[r_indices[*t * 3 + 1]] + scores[r_indices[*t * 3 + 2]];
+				triangle_scores[*t] = score;
+				if (score > best_score) {
+					best_score = score;
+					best = *t;
+				}
+			}
+		}
+
+		// nothing left around the cache: carry on from the next triangle not emitted yet
+		if (best < 0) {
+			while (cursor < triangle_count && emitted[cursor]) {
+				cursor++;
+			}
+			best = cursor < triangle_count ? int64_t(cursor) : -1;
+		}
+	}
+
+	std::copy(output.begin(), output.end(), r_indices);
+}
+
+// p_position(vertex) returns the vertex's position as a manifold::vec3. Triangles are expected in
+// Godot's clockwise winding.
+template <typename Position>
+void optimize_overdraw(int32_t *r_indices, size_t p_index_count, size_t p_vertex_count, const Position &p_position) {
+	const size_t triangle_count = p_index_count / 3;
+	if (triangle_count < 2) {
+		return;
+	}
+
+	struct Cluster {
+		size_t first;
+		size_t last;
+		manifold::vec3 centroid;
+		manifold::vec3 normal;
+		double sort_key;
+	};
+
+	// a new cluster starts wherever the cache order starts over (a triangle with no cached vertex), so
+	// clusters can be moved around without costing much locality
+	std::vector<Cluster> clusters;
+	{
+		std::vector<uint64_t> loaded_at(p_vertex_count, 0);
+		uint64_t loads = 0;
+		for (size_t triangle = 0; triangle < triangle_count; triangle++) {
+			uint32_t misses = 0;
+			for (size_t k = 0; k < 3; k++) {
+				uint64_t &time = loaded_at[r_indices[triangle * 3 + k]];
+				if (time == 0 || loads - time >= VERTEX_CACHE_REPORT_SIZE) {
+					time = ++loads;
+					misses++;
+				}
+			}
+			if (triangle == 0 || misses == 3) {
+				clusters.push_back({ triangle, triangle + 1, manifold::vec3(0.0), manifold::vec3(0.0), 0.0 });
+			} else {
+				clusters.back().last = triangle + 1;
+			}
+		}
+	}
+	if (clusters.size() < 2) {
+		return;
+	}
+
+	manifold::vec3 mesh_centroid(0.0);
+	double mesh_area = 0.0;
+	for (Cluster &cluster : clusters) {
+		double area = 0.0;
+		for (size_t triangle = cluster.first; triangle < cluster.last; triangle++) {
+			const manifold::vec3 a = p_position(r_indices[triangle * 3]);
+			const manifold::vec3 b = p_position(r_indices[triangle * 3 + 1]);
+			const manifold::vec3 c = p_position(r_indices[triangle * 3 + 2]);
+			// clockwise, so this points inwards
+			const manifold::vec3 cross = manifold::la::cross(b - a, c - a);
+			const double triangle_area = manifold::la::length(cross);
+			cluster.centroid += (a + b + c) * (triangle_area / 3.0);
+			cluster.normal -= cross;
+			area += triangle_area;
+		}
+		mesh_centroid += cluster.centroid;
+		mesh_area += area;
+		cluster.centroid = area > 0.0 ? cluster.centroid / area : p_position(r_indices[cluster.first * 3]);
+	}
+	mesh_centroid = mesh_area > 0.0 ? mesh_centroid / mesh_area : mesh_centroid;
+
+	// draw the clusters facing furthest away from the middle of the mesh first, since they are the
+	// most likely to hide what is behind them
+	for (Cluster &cluster : clusters) {
+		const double length = manifold::la::length(cluster.normal);
+		cluster.sort_key = length > 0.0 ? manifold::la::dot(cluster.centroid - mesh_centroid, cluster.normal / length) : 0.0;
+	}
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster &p_a, const Cluster &p_b) {
+		return p_a.sort_key > p_b.sort_key;
+	});
+
+	std::vector<int32_t> sorted;
+	sorted.reserve(p_index_count);
+	for (const Cluster &cluster : clusters) {
+		sorted.insert(sorted.end(), r_indices + cluster.first * 3, r_indices + cluster.last * 3);
+	}
+
+	const uint64_t misses = vertex_cache_misses(r_indices, p_index_count, p_vertex_count);
+	if (double(vertex_cache_misses(sorted.data(), p_index_count, p_vertex_count)) <= double(misses) * VERTEX_CACHE_OVERDRAW_THRESHOLD) {
+		std::copy(sorted.begin(), sorted.end(), r_indices);
+	}
+}
+
+// Renumbers vertices in the order the index buffer first uses them. r_vertices maps each vertex to
+// whatever it stands for, and is reordered to match.
+template <typename T>
+void optimize_vertex_fetch(int32_t *r_indices, size_t p_index_count, T &r_vertices) {
+	std::vector<int32_t> new_index(r_vertices.size(), -1);
+	T reordered;
+	reordered.resize(r_vertices.size());
+	int32_t count = 0;
+	for (size_t i = 0; i < p_index_count; i++) {
+		int32_t &index = new_index[r_indices[i]];
+		if (index < 0) {
+			index = count++;
+			reordered[index] = r_vertices[r_indices[i]];
+		}
+		r_indices[i] = index;
+	}
+	reordered.resize(count);
+	r_vertices = reordered;
+}